@@ -0,0 +1,878 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+// Benchmarks of the rendering and dispatch hot paths. The results are written as json
+// to compare the runs, see doc/en/docs/base/profiling.md
+//
+
+#include <wui/framework/framework.hpp>
+
+#include <wui/window/window.hpp>
+#include <wui/window/event_log.hpp>
+
+#include <wui/control/button.hpp>
+#include <wui/control/text.hpp>
+#include <wui/control/input.hpp>
+#include <wui/control/list.hpp>
+#include <wui/control/grid.hpp>
+#include <wui/control/chart.hpp>
+#include <wui/control/tooltip.hpp>
+
+#include <wui/graphic/graphic.hpp>
+#include <wui/graphic/pixel_format.hpp>
+#include <wui/graphic/decimation.hpp>
+
+#include <wui/common/text_buffer.hpp>
+#include <wui/common/edit_journal.hpp>
+
+#include <wui/theme/theme.hpp>
+
+#include <wui/system/alloc_counter.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct options
+{
+    std::string filter, res_dir = "res", out_file, replay_file;
+    double scale = 1.0;
+    bool alloc_check = false;
+};
+
+struct bench_result
+{
+    std::string name;
+    int64_t iterations;
+    uint64_t total_ns;
+    std::string skipped;
+};
+
+const wui::rect window_size = { 0, 0, 1280, 800 };
+
+class bench_runner
+{
+public:
+    explicit bench_runner(const options &options__)
+        : options_(options__), results()
+    {
+    }
+
+    bool selected(std::string_view name) const
+    {
+        return options_.filter.empty() || name.find(options_.filter) != std::string_view::npos;
+    }
+
+    /// Run the op iterations times after one warm up call
+    void run(std::string_view name, int64_t iterations, std::function<void(int64_t)> op)
+    {
+        if (!selected(name))
+        {
+            return;
+        }
+
+        iterations = (std::max)(static_cast<int64_t>(iterations * options_.scale), static_cast<int64_t>(1));
+
+        op(0);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int64_t i = 0; i != iterations; ++i)
+        {
+            op(i);
+        }
+        auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        results.push_back({ std::string(name), iterations, static_cast<uint64_t>(total), "" });
+
+        std::cerr << name << ": " << (total / iterations) << " ns/op" << std::endl;
+    }
+
+    void skip(std::string_view name, std::string_view reason)
+    {
+        if (selected(name))
+        {
+            results.push_back({ std::string(name), 0, 0, std::string(reason) });
+
+            std::cerr << name << ": skipped, " << reason << std::endl;
+        }
+    }
+
+    std::string json() const
+    {
+        auto j = nlohmann::json::object();
+
+#ifdef _WIN32
+        j["platform"] = "windows";
+#elif __linux__
+        j["platform"] = "linux";
+#endif
+        j["results"] = nlohmann::json::array();
+
+        for (auto &r : results)
+        {
+            if (!r.skipped.empty())
+            {
+                j["results"].push_back({ { "name", r.name }, { "skipped", r.skipped } });
+                continue;
+            }
+
+            j["results"].push_back({
+                { "name", r.name },
+                { "iterations", r.iterations },
+                { "total_ns", r.total_ns },
+                { "ns_per_op", static_cast<double>(r.total_ns) / r.iterations },
+                { "ops_per_sec", r.total_ns != 0 ? r.iterations * 1e9 / r.total_ns : 0.0 }
+            });
+        }
+
+        return j.dump(4);
+    }
+
+private:
+    const options &options_;
+    std::vector<bench_result> results;
+};
+
+bool load_theme(const options &options_, std::string_view name)
+{
+    return wui::set_default_theme_from_file(name, options_.res_dir + "/" + std::string(name) + ".json");
+}
+
+/// The window with the grid of buttons, texts and inputs
+void fill_window(wui::window &window_, int32_t count)
+{
+    const int32_t width = 120, height = 30, columns = window_size.width() / width;
+
+    for (int32_t i = 0; i != count; ++i)
+    {
+        wui::rect position{ (i % columns) * width, 40 + (i / columns) * height, (i % columns) * width + width - 4, 40 + (i / columns) * height + height - 4 };
+
+        std::shared_ptr<wui::i_control> control;
+        switch (i % 3)
+        {
+            case 0: control = std::make_shared<wui::button>("Button " + std::to_string(i), []() {}); break;
+            case 1: control = std::make_shared<wui::text>("Text " + std::to_string(i)); break;
+            case 2: control = std::make_shared<wui::input>("Input " + std::to_string(i)); break;
+        }
+
+        window_.add_control(control, position);
+    }
+}
+
+std::shared_ptr<wui::window> make_headless_window()
+{
+    auto window_ = std::make_shared<wui::window>();
+    if (!window_->init("wui_bench", window_size, wui::window_style::headless, []() {}))
+    {
+        return nullptr;
+    }
+    return window_;
+}
+
+void bench_paint(bench_runner &runner, bool has_display)
+{
+    if (!has_display)
+    {
+        return runner.skip("paint_full_window_300_controls", "no display");
+    }
+
+    auto window_ = make_headless_window();
+    if (!window_)
+    {
+        return runner.skip("paint_full_window_300_controls", "window is not created");
+    }
+
+    fill_window(*window_, 300);
+
+    runner.run("paint_full_window_300_controls", 200, [&](int64_t) {
+        window_->paint(window_size);
+    });
+
+    /// The retained window repaints only the recorded commands changed by the redraw requests
+    window_->set_retained_mode(true);
+    window_->paint_damaged();
+
+    runner.run("paint_retained_expose_300_controls", 200, [&](int64_t) {
+        window_->paint(window_size);
+    });
+
+    runner.run("paint_retained_redraw_all_300_controls", 200, [&](int64_t) {
+        window_->redraw(window_size);
+        window_->paint_damaged();
+    });
+
+    /// Resetting the retained mode records and rasterizes the whole window, as the resize does
+    auto full_raster = [&](int64_t) {
+        window_->set_retained_mode(false);
+        window_->set_retained_mode(true);
+        window_->paint_damaged();
+    };
+
+    runner.run("paint_retained_full_raster_300_controls", 100, full_raster);
+
+    window_->set_raster_threads(0);
+    runner.run("paint_retained_full_raster_tiled_300_controls", 100, full_raster);
+    window_->set_raster_threads(1);
+
+    /// The topmost control moving over the controls only recomposites the base layer's pixels
+    auto tooltip_ = std::make_shared<wui::tooltip>("The tooltip moving over the controls");
+    window_->add_control(tooltip_, { 0, 0, 240, 30 });
+    tooltip_->show();
+    window_->paint_damaged();
+
+    runner.run("paint_retained_tooltip_move_300_controls", 1000, [&](int64_t i) {
+        auto x = static_cast<int32_t>(i * 7 % (window_size.width() - 240)), y = static_cast<int32_t>(40 + i * 3 % (window_size.height() - 70));
+        tooltip_->set_position({ x, y, x + 240, y + 30 });
+        window_->paint_damaged();
+    });
+
+    window_->destroy();
+}
+
+void bench_list_scroll(bench_runner &runner, bool has_display)
+{
+    if (!has_display)
+    {
+        return runner.skip("list_wheel_scroll_1m_rows", "no display");
+    }
+
+    auto window_ = make_headless_window();
+    if (!window_)
+    {
+        return runner.skip("list_wheel_scroll_1m_rows", "window is not created");
+    }
+
+    auto list_ = std::make_shared<wui::list>();
+    list_->update_columns({ { 400, "Row" }, { 400, "Value" } });
+    list_->set_item_height_callback([](int32_t n, int32_t &height) { height = 20 + (n % 3) * 8; });
+    list_->set_draw_callback([](wui::graphic &gr, int32_t n, const wui::rect &item_rect, wui::list::item_state) {
+        gr.draw_text(item_rect, std::to_string(n), wui::theme_color(wui::list::tc, wui::list::tv_title_text), wui::theme_font_handle(wui::list::tc, wui::list::tv_font));
+    });
+
+    const wui::rect list_position{ 10, 40, 810, 790 };
+    window_->add_control(list_, list_position);
+    list_->set_item_count(1000000);
+
+    window_->paint_damaged();
+
+    /// Wheel from the top, the rows offsets are calculated from the first row so the deep jumps are not measured
+    wui::event ev;
+    ev.type = wui::event_type::mouse;
+    ev.mouse_event_ = wui::mouse_event{ wui::mouse_event_type::wheel, 400, 400, -120 };
+
+    runner.run("list_wheel_scroll_1m_rows", 300, [&](int64_t i) {
+        if (i % 600 == 599)
+        {
+            list_->scroll_to_start();
+        }
+        window_->dispatch_event(ev);
+        window_->paint_damaged();
+    });
+
+    window_->destroy();
+}
+
+/// The source of the generated cells
+class bench_grid_source : public wui::i_grid_source
+{
+public:
+    int32_t rows_count() const { return 1000000; }
+    int32_t columns_count() const { return 200; }
+
+    void header(int32_t column, std::string &text) { text.append("Column ").append(std::to_string(column)); }
+    void cell(int32_t row, int32_t column, std::string &text) { text.append(std::to_string(row)).append(":").append(std::to_string(column)); }
+};
+
+void bench_grid_scroll(bench_runner &runner, bool has_display)
+{
+    if (!has_display)
+    {
+        return runner.skip("grid_wheel_scroll_1m_rows_200_columns", "no display");
+    }
+
+    auto window_ = make_headless_window();
+    if (!window_)
+    {
+        return runner.skip("grid_wheel_scroll_1m_rows_200_columns", "window is not created");
+    }
+
+    auto source = std::make_shared<bench_grid_source>();
+
+    auto grid_ = std::make_shared<wui::grid>();
+    grid_->set_default_column_width(90);
+    grid_->set_frozen_columns(1);
+    grid_->set_source(source);
+
+    window_->add_control(grid_, { 10, 40, 810, 790 });
+    window_->paint_damaged();
+
+    wui::event ev;
+    ev.type = wui::event_type::mouse;
+    ev.mouse_event_ = wui::mouse_event{ wui::mouse_event_type::wheel, 400, 400, -120 };
+
+    runner.run("grid_wheel_scroll_1m_rows_200_columns", 300, [&](int64_t) {
+        window_->dispatch_event(ev);
+        window_->paint_damaged();
+    });
+
+    /// The horizontal scrolling shows the new columns, the cells texts are fitted and cached
+    wui::event key;
+    key.type = wui::event_type::keyboard;
+    key.keyboard_event_ = wui::keyboard_event{ wui::keyboard_event_type::down, 0, 0 };
+
+    window_->set_focused(grid_);
+
+    runner.run("grid_column_scroll_1m_rows_200_columns", 300, [&](int64_t i) {
+        key.keyboard_event_.key[0] = static_cast<char>((i / 150) % 2 == 0 ? wui::vk_right : wui::vk_left);
+        window_->dispatch_event(key);
+        window_->paint_damaged();
+    });
+
+    window_->destroy();
+}
+
+/// One million samples per second at 60 frames per second
+void bench_chart(bench_runner &runner, bool has_display)
+{
+    if (!has_display)
+    {
+        return runner.skip("chart_append_1m_samples_per_second", "no display");
+    }
+
+    auto window_ = make_headless_window();
+    if (!window_)
+    {
+        return runner.skip("chart_append_1m_samples_per_second", "window is not created");
+    }
+
+    auto chart_ = std::make_shared<wui::chart>();
+    chart_->add_series(wui::make_color(90, 200, 90));
+    chart_->add_series(wui::make_color(200, 160, 60));
+    chart_->set_samples_per_pixel(1000);
+
+    window_->add_control(chart_, { 10, 40, 1010, 540 });
+
+    const size_t frame_samples = 1000000 / 60;
+    std::vector<float> samples(frame_samples);
+
+    window_->paint_damaged();
+
+    runner.run("chart_append_1m_samples_per_second", 300, [&](int64_t i) {
+        for (size_t n = 0; n != frame_samples; ++n)
+        {
+            samples[n] = static_cast<float>(std::sin((i * frame_samples + n) * 0.0001) * 0.8 + (n % 17) * 0.005);
+        }
+        chart_->append(0, samples.data(), samples.size());
+        chart_->append(1, samples.data(), samples.size());
+
+        /// The repaint posted by the appending is handled by the message loop, it does not run here
+        window_->redraw(chart_->position());
+        window_->paint_damaged();
+    });
+
+    window_->destroy();
+}
+
+/// The notes field of 100k lines, the typing in the middle and the line lookups
+void bench_input_multiline(bench_runner &runner, bool has_display)
+{
+    std::string text;
+    for (int32_t i = 0; i != 100000; ++i)
+    {
+        text.append("key_").append(std::to_string(i)).append(" = value of the line ").append(std::to_string(i)).append("\n");
+    }
+
+    wui::text_buffer buffer(text);
+
+    runner.run("text_buffer_insert_100k_lines", 10000, [&](int64_t i) {
+        buffer.insert(buffer.line_start(static_cast<size_t>(i * 7919) % buffer.lines_count()), "x");
+    });
+
+    size_t lookup = 0;
+    runner.run("text_buffer_line_start_100k_lines", 10000, [&](int64_t i) {
+        lookup += buffer.offset_line(buffer.line_start(static_cast<size_t>(i * 7919) % buffer.lines_count()));
+    });
+
+    /// The undo of the pasted text takes the size of the paste, not of the buffer
+    wui::edit_journal journal(64 * 1024 * 1024);
+    journal.insert(buffer.size(), text);
+    buffer.insert(buffer.size(), text);
+
+    auto apply = [&buffer](wui::edit_journal::operation operation_, size_t offset, std::string_view text_) {
+        if (operation_ == wui::edit_journal::operation::insert)
+        {
+            buffer.insert(offset, text_);
+        }
+        else
+        {
+            buffer.erase(offset, text_.size());
+        }
+    };
+
+    runner.run("edit_journal_undo_redo_paste_100k_lines", 100, [&](int64_t i) {
+        if (i % 2 == 0)
+        {
+            journal.undo(apply);
+        }
+        else
+        {
+            journal.redo(apply);
+        }
+    });
+
+    if (!has_display)
+    {
+        return runner.skip("input_multiline_typing_100k_lines", "no display");
+    }
+
+    auto window_ = make_headless_window();
+    if (!window_)
+    {
+        return runner.skip("input_multiline_typing_100k_lines", "window is not created");
+    }
+
+    auto input_ = std::make_shared<wui::input>(text, wui::input_view::multiline);
+
+    window_->add_control(input_, { 10, 40, 810, 790 });
+    window_->set_focused(input_);
+    window_->paint_damaged();
+
+    /// The typing is in the middle of the text
+    wui::event ev;
+    ev.type = wui::event_type::mouse;
+    ev.mouse_event_ = wui::mouse_event{ wui::mouse_event_type::wheel, 400, 400, -120 };
+
+    for (int32_t i = 0; i != 1000; ++i)
+    {
+        window_->dispatch_event(ev);
+    }
+
+    ev.mouse_event_ = wui::mouse_event{ wui::mouse_event_type::left_down, 400, 400, 0 };
+    window_->dispatch_event(ev);
+
+    wui::event key;
+    key.type = wui::event_type::keyboard;
+    key.keyboard_event_ = wui::keyboard_event{ wui::keyboard_event_type::key, 0, 0 };
+    key.keyboard_event_.key[0] = 'a';
+    key.keyboard_event_.key_size = 1;
+
+    runner.run("input_multiline_typing_100k_lines", 300, [&](int64_t) {
+        window_->dispatch_event(key);
+        window_->paint_damaged();
+    });
+
+    window_->destroy();
+}
+
+void bench_measure_text(bench_runner &runner, bool has_display)
+{
+    if (!has_display)
+    {
+        return runner.skip("measure_text", "no display");
+    }
+
+    auto window_ = make_headless_window();
+    if (!window_)
+    {
+        return runner.skip("measure_text", "window is not created");
+    }
+
+    wui::graphic gr(window_->context());
+    gr.init({ 0, 0, 1024, 256 }, wui::make_color(0, 0, 0));
+
+    const std::vector<std::string> strings = { "OK", "Cancel", "The quick brown fox jumps over the lazy dog", "1234567.89", "Съешь же ещё этих мягких французских булок" };
+    auto font_ = wui::theme_font_handle(wui::text::tc, wui::text::tv_font);
+
+    int64_t width = 0;
+    runner.run("measure_text", 100000, [&](int64_t i) {
+        width += gr.measure_text(strings[i % strings.size()], font_).width();
+    });
+
+    gr.release();
+    window_->destroy();
+}
+
+/// The grid of the cells of 8 colors with the borders, drawn by the single primitives and by the batch
+void bench_primitives(bench_runner &runner, bool has_display)
+{
+    if (!has_display)
+    {
+        return runner.skip("draw_rects_lines_single_10k", "no display");
+    }
+
+    auto window_ = make_headless_window();
+    if (!window_)
+    {
+        return runner.skip("draw_rects_lines_single_10k", "window is not created");
+    }
+
+    wui::graphic gr(window_->context());
+    gr.init({ 0, 0, 1000, 1000 }, wui::make_color(0, 0, 0));
+
+    std::vector<std::pair<wui::rect, wui::color>> cells;
+    for (int32_t i = 0; i != 10000; ++i)
+    {
+        auto x = (i % 100) * 10, y = (i / 100) * 10;
+        cells.push_back({ { x, y, x + 10, y + 10 }, wui::make_color(static_cast<uint8_t>((i % 8) * 30), 100, 200) });
+    }
+    auto line_color = wui::make_color(64, 64, 64);
+
+    runner.run("draw_rects_lines_single_10k", 20, [&](int64_t) {
+        for (auto &c : cells)
+        {
+            gr.draw_rect(c.first, c.second);
+            gr.draw_line({ c.first.left, c.first.bottom - 1, c.first.right, c.first.bottom - 1 }, line_color);
+        }
+    });
+
+    wui::primitive_batch batch;
+    runner.run("draw_rects_lines_batch_10k", 20, [&](int64_t) {
+        batch.clear();
+        for (auto &c : cells)
+        {
+            batch.add_rect(c.first, c.second);
+            batch.add_line({ c.first.left, c.first.bottom - 1, c.first.right, c.first.bottom - 1 }, line_color);
+        }
+        gr.draw_batch(batch);
+    });
+
+    gr.release();
+    window_->destroy();
+}
+
+void bench_mouse_dispatch(bench_runner &runner)
+{
+    /// The window is not initialized, the dispatching doesn't need the system
+    auto window_ = std::make_shared<wui::window>();
+    window_->disable_draw();
+
+    const int32_t controls_count = 5000, subscribers_count = 1000, size = 16, columns = window_size.width() / size;
+
+    for (int32_t i = 0; i != controls_count; ++i)
+    {
+        window_->add_control(std::make_shared<wui::button>("", []() {}),
+            { (i % columns) * size, (i / columns) * size, (i % columns) * size + size - 1, (i / columns) * size + size - 1 });
+    }
+
+    int64_t received = 0;
+    for (int32_t i = 0; i != subscribers_count; ++i)
+    {
+        window_->subscribe([&received](const wui::event &) { ++received; }, wui::event_type::mouse);
+    }
+
+    wui::event ev;
+    ev.type = wui::event_type::mouse;
+
+    runner.run("mouse_move_dispatch_5000_controls_1000_subscribers", 20000, [&](int64_t i) {
+        ev.mouse_event_ = wui::mouse_event{ wui::mouse_event_type::move,
+            static_cast<int32_t>((i * 7) % window_size.width()),
+            static_cast<int32_t>((i * 3) % (controls_count / columns * size)), 0 };
+        window_->dispatch_event(ev);
+    });
+
+    window_->destroy();
+}
+
+void bench_theme(bench_runner &runner, const options &options_, bool has_display)
+{
+    struct lookup
+    {
+        const char *control, *value;
+    };
+    const std::vector<lookup> lookups = {
+        { wui::button::tc, wui::button::tv_calm },
+        { wui::button::tc, wui::button::tv_border_width },
+        { wui::window::tc, wui::window::tv_background },
+        { wui::list::tc, wui::list::tv_selected_item },
+        { wui::input::tc, wui::input::tv_text }
+    };
+
+    int64_t sum = 0;
+    runner.run("theme_color_lookup", 1000000, [&](int64_t i) {
+        auto &l = lookups[i % lookups.size()];
+        sum += wui::theme_color(l.control, l.value);
+    });
+
+    runner.run("theme_font_handle_lookup", 1000000, [&](int64_t i) {
+        sum += wui::theme_font_handle(i % 2 ? wui::button::tc : wui::text::tc, wui::button::tv_font).id;
+    });
+
+    if (!has_display)
+    {
+        return runner.skip("theme_switch_300_controls", "no display");
+    }
+
+    auto window_ = make_headless_window();
+    if (!window_)
+    {
+        return runner.skip("theme_switch_300_controls", "window is not created");
+    }
+
+    fill_window(*window_, 300);
+
+    runner.run("theme_switch_300_controls", 20, [&](int64_t i) {
+        load_theme(options_, i % 2 ? "dark" : "light");
+        window_->update_theme();
+        window_->paint(window_size);
+    });
+
+    load_theme(options_, "dark");
+
+    window_->destroy();
+}
+
+void bench_pixels(bench_runner &runner)
+{
+    const int32_t width = 1920, height = 1080;
+
+    std::vector<uint8_t> src(static_cast<size_t>(width) * height * 4), dst(src.size());
+    for (size_t i = 0; i != src.size(); ++i)
+    {
+        src[i] = static_cast<uint8_t>(i * 31);
+    }
+
+    auto best = wui::best_pixel_kernel();
+
+    const std::vector<std::pair<wui::pixel_kernel, const char*>> kernels = {
+        { wui::pixel_kernel::scalar, "convert_pixels_rgba32_1080p_scalar" },
+        { wui::pixel_kernel::sse2, "convert_pixels_rgba32_1080p_sse2" },
+        { wui::pixel_kernel::avx2, "convert_pixels_rgba32_1080p_avx2" }
+    };
+
+    for (auto &k : kernels)
+    {
+        if (static_cast<int32_t>(k.first) > static_cast<int32_t>(best))
+        {
+            runner.skip(k.second, "not supported by cpu");
+            continue;
+        }
+
+        runner.run(k.second, 100, [&](int64_t) {
+            wui::convert_pixels(src.data(), 0, wui::pixel_format::rgba32, dst.data(), width, height, true, k.first);
+        });
+    }
+}
+
+void bench_min_max(bench_runner &runner)
+{
+    std::vector<float> values(1000000);
+    for (size_t i = 0; i != values.size(); ++i)
+    {
+        values[i] = static_cast<float>((i * 7919) % 1000) - 500.0f;
+    }
+
+    auto best = wui::best_pixel_kernel();
+
+    const std::vector<std::pair<wui::pixel_kernel, const char*>> kernels = {
+        { wui::pixel_kernel::scalar, "min_max_1m_samples_scalar" },
+        { wui::pixel_kernel::sse2, "min_max_1m_samples_sse2" },
+        { wui::pixel_kernel::avx2, "min_max_1m_samples_avx2" }
+    };
+
+    for (auto &k : kernels)
+    {
+        if (static_cast<int32_t>(k.first) > static_cast<int32_t>(best))
+        {
+            runner.skip(k.second, "not supported by cpu");
+            continue;
+        }
+
+        float mn = 0.0f, mx = 0.0f;
+        runner.run(k.second, 200, [&](int64_t) {
+            wui::min_max(values.data(), values.size(), mn, mx, k.first);
+        });
+    }
+}
+
+/// Plays the log recorded by wui::event_recorder on the window with the default controls grid
+void bench_replay(bench_runner &runner, const options &options_, bool has_display)
+{
+    if (options_.replay_file.empty())
+    {
+        return;
+    }
+
+    if (!has_display)
+    {
+        return runner.skip("replay", "no display");
+    }
+
+    wui::event_player player;
+    if (!player.load(options_.replay_file))
+    {
+        return runner.skip("replay", player.get_error().str());
+    }
+
+    auto window_ = make_headless_window();
+    if (!window_)
+    {
+        return runner.skip("replay", "window is not created");
+    }
+
+    fill_window(*window_, 300);
+
+    runner.run("replay", 1, [&](int64_t) {
+        player.play(*window_);
+    });
+
+    window_->destroy();
+}
+
+/// Fails if the steady state repaint of the controls grid allocates
+bool alloc_check(bool has_display)
+{
+    if (!wui::alloc_counter::available())
+    {
+        std::cerr << "alloc check: the library is built without WUI_ALLOC_COUNTER" << std::endl;
+        return false;
+    }
+    if (!has_display)
+    {
+        std::cerr << "alloc check: no display" << std::endl;
+        return false;
+    }
+
+    auto window_ = make_headless_window();
+    if (!window_)
+    {
+        std::cerr << "alloc check: window is not created" << std::endl;
+        return false;
+    }
+    fill_window(*window_, 300);
+
+    bool violated = false;
+
+    wui::alloc_counter::enable();
+    wui::alloc_counter::set_paint_budget(3, [&violated](const wui::alloc_counter::frame_stats &stats) {
+        std::cerr << "alloc check: the repaint allocates: " << wui::alloc_counter::dump_json(stats) << std::endl;
+        violated = true;
+    });
+
+    for (int32_t i = 0; i != 20 && !violated; ++i)
+    {
+        window_->paint(window_size);
+    }
+
+    wui::alloc_counter::set_paint_budget(-1);
+    wui::alloc_counter::disable();
+
+    window_->destroy();
+
+    if (!violated)
+    {
+        std::cerr << "alloc check: passed" << std::endl;
+    }
+
+    return !violated;
+}
+
+bool has_display()
+{
+#ifdef _WIN32
+    return true;
+#elif __linux__
+    auto display = XOpenDisplay(NULL);
+    if (display)
+    {
+        XCloseDisplay(display);
+    }
+    return display != nullptr;
+#endif
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    options options_;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc)
+        {
+            options_.filter = argv[++i];
+        }
+        else if (arg == "--res" && i + 1 < argc)
+        {
+            options_.res_dir = argv[++i];
+        }
+        else if (arg == "--out" && i + 1 < argc)
+        {
+            options_.out_file = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc)
+        {
+            options_.replay_file = argv[++i];
+        }
+        else if (arg == "--alloc-check")
+        {
+            options_.alloc_check = true;
+        }
+        else if (arg == "--scale" && i + 1 < argc)
+        {
+            options_.scale = std::stod(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "usage: wui_bench [--filter substring] [--res themes_dir] [--out file.json] [--replay events.log] [--scale iterations_multiplier] [--alloc-check]" << std::endl;
+            return -1;
+        }
+    }
+
+    wui::framework::init();
+
+    if (!load_theme(options_, "dark"))
+    {
+        std::cerr << "theme is not loaded from " << options_.res_dir << ", the defaults are used" << std::endl;
+        wui::set_default_theme_empty("dark");
+    }
+
+    auto display = has_display();
+
+    if (options_.alloc_check)
+    {
+        return alloc_check(display) ? 0 : 1;
+    }
+
+    bench_runner runner(options_);
+
+    bench_paint(runner, display);
+    bench_list_scroll(runner, display);
+    bench_grid_scroll(runner, display);
+    bench_chart(runner, display);
+    bench_input_multiline(runner, display);
+    bench_measure_text(runner, display);
+    bench_primitives(runner, display);
+    bench_mouse_dispatch(runner);
+    bench_theme(runner, options_, display);
+    bench_pixels(runner);
+    bench_min_max(runner);
+    bench_replay(runner, options_, display);
+
+    if (options_.out_file.empty())
+    {
+        std::cout << runner.json() << std::endl;
+    }
+    else
+    {
+        std::ofstream f(options_.out_file, std::ios::out | std::ios::trunc);
+        f << runner.json() << std::endl;
+    }
+
+    return 0;
+}
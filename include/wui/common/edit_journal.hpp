@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+/// The undo and redo journal of the text edits. The edit is kept as the record of the operation, the offset
+/// and the changed text, the texts of all the records are in one arena. The typed chars are joined to the run
+/// of the previous typing, so the run is undone by one step. The oldest steps are dropped to keep the memory
+/// usage under the budget. Undo and redo take the size of the step's texts, not of the full text
+class edit_journal
+{
+public:
+    enum class operation
+    {
+        insert,
+        erase
+    };
+
+    /// Makes the operation on the text. The undo gives the inverse operations of the step in the reverse order
+    using apply_func = std::function<void(operation, size_t offset, std::string_view text)>;
+
+    edit_journal(size_t memory_budget = 4 * 1024 * 1024);
+
+    void set_memory_budget(size_t bytes);
+    size_t memory_budget() const;
+    size_t memory_usage() const;
+
+    void insert(size_t offset, std::string_view text, bool typing = false);
+    void erase(size_t offset, std::string_view text, bool typing = false);
+
+    /// The edits recorded between begin_group() and end_group() are undone by one step
+    void begin_group();
+    void end_group();
+
+    /// The next typing starts the new run. Called on the cursor moves
+    void close_run();
+
+    bool can_undo() const;
+    bool can_redo() const;
+
+    /// Return false if there is no step
+    bool undo(const apply_func &apply);
+    bool redo(const apply_func &apply);
+
+    void clear();
+
+private:
+    struct record
+    {
+        operation operation_;
+        bool typing;
+        bool joined; /// undone with the previous record
+        size_t offset;
+        size_t text_offset, text_size; /// in the arena
+    };
+
+    std::deque<record> records;
+    size_t current; /// the count of the done records, the rest are redone
+
+    std::string arena;
+    size_t arena_start; /// the arena's begin used by the oldest record
+
+    size_t budget;
+
+    int32_t group_depth;
+    size_t group_records; /// made in the current group
+    bool run_closed;
+
+    void add(operation operation_, size_t offset, std::string_view text, bool typing);
+    bool extend_run(operation operation_, size_t offset, std::string_view text);
+
+    void trim();
+    void drop_oldest();
+};
+
+}
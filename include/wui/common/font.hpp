@@ -31,4 +31,20 @@ struct font
     decorations decorations_;
 };
 
+/// Integer handle of the font interned by intern_font(), zero is the empty handle
+struct font_handle
+{
+    int32_t id;
+
+    inline bool valid() const
+    {
+        return id != 0;
+    }
+
+    inline bool operator==(const font_handle &lv) const
+    {
+        return id == lv.id;
+    }
+};
+
 }
@@ -0,0 +1,237 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <functional>
+#include <utility>
+
+namespace wui
+{
+
+/// Counters of the cache usage
+struct cache_stats
+{
+    const char *name;
+    uint64_t hits, misses, evictions;
+    size_t size, capacity;
+};
+
+/// Hash of the plain keys and the nested pairs used by the system objects caches
+struct lru_hash
+{
+    template <typename T>
+    size_t operator()(const T &value) const
+    {
+        return std::hash<T>()(value);
+    }
+
+    template <typename A, typename B>
+    size_t operator()(const std::pair<A, B> &value) const
+    {
+        auto h = (*this)(value.first);
+        return h ^ ((*this)(value.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+    }
+};
+
+/// Capacity bounded cache with least recently used eviction.
+/// Items are stored in the flat array linked to the recency list by indexes,
+/// the lookup goes by the open addressing hash table over this array.
+/// evict_callback is called for the items pushed out of the cache and on clear() to free system objects.
+template <typename key_t, typename value_t, typename hash_t = lru_hash>
+class lru_cache
+{
+public:
+    lru_cache(const char *name_, size_t capacity_, std::function<void(value_t &)> evict_callback_)
+        : name(name_),
+        capacity(capacity_ != 0 ? capacity_ : 1),
+        evict_callback(evict_callback_),
+        nodes(),
+        index(),
+        mask(0),
+        head(-1), tail(-1),
+        hits(0), misses(0), evictions(0)
+    {
+        size_t index_size = 2;
+        while (index_size < capacity * 2)
+        {
+            index_size <<= 1;
+        }
+        index.assign(index_size, -1);
+        mask = index_size - 1;
+
+        nodes.reserve(capacity);
+    }
+
+    ~lru_cache()
+    {
+        clear();
+    }
+
+    lru_cache(const lru_cache &) = delete;
+    lru_cache &operator=(const lru_cache &) = delete;
+
+    /// Return the pointer to cached value and make it the most recent, or nullptr on miss
+    value_t *find(const key_t &key)
+    {
+        auto slot = find_slot(key, hash_t()(key));
+        if (index[slot] == -1)
+        {
+            ++misses;
+            return nullptr;
+        }
+
+        ++hits;
+
+        auto n = index[slot];
+        unlink(n);
+        link_front(n);
+
+        return &nodes[n].value;
+    }
+
+    /// Put the value not present in cache, the least recent item is evicted if the cache is full
+    value_t &insert(const key_t &key, const value_t &value)
+    {
+        int32_t n = 0;
+
+        if (nodes.size() < capacity)
+        {
+            n = static_cast<int32_t>(nodes.size());
+            nodes.push_back(node{ key, value, 0, -1, -1 });
+        }
+        else
+        {
+            n = tail;
+
+            if (evict_callback)
+            {
+                evict_callback(nodes[n].value);
+            }
+            ++evictions;
+
+            erase_slot(find_slot(nodes[n].key, nodes[n].hash));
+            unlink(n);
+
+            nodes[n].key = key;
+            nodes[n].value = value;
+        }
+
+        nodes[n].hash = hash_t()(key);
+        index[find_slot(key, nodes[n].hash)] = n;
+        link_front(n);
+
+        return nodes[n].value;
+    }
+
+    void clear()
+    {
+        if (evict_callback)
+        {
+            for (auto &n : nodes)
+            {
+                evict_callback(n.value);
+            }
+        }
+        nodes.clear();
+        index.assign(index.size(), -1);
+        head = tail = -1;
+    }
+
+    cache_stats stats() const
+    {
+        return cache_stats{ name, hits, misses, evictions, nodes.size(), capacity };
+    }
+
+private:
+    struct node
+    {
+        key_t key;
+        value_t value;
+        size_t hash;
+        int32_t prev, next;
+    };
+
+    const char *name;
+    size_t capacity;
+    std::function<void(value_t &)> evict_callback;
+
+    std::vector<node> nodes;
+    std::vector<int32_t> index;
+    size_t mask;
+
+    /// Most and least recently used nodes
+    int32_t head, tail;
+
+    uint64_t hits, misses, evictions;
+
+    /// Return the slot containing the key or the empty slot where it should be placed
+    size_t find_slot(const key_t &key, size_t hash) const
+    {
+        auto slot = hash & mask;
+        while (index[slot] != -1)
+        {
+            auto &n = nodes[index[slot]];
+            if (n.hash == hash && n.key == key)
+            {
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    /// Backward shift deletion keeps probe chains unbroken without tombstones
+    void erase_slot(size_t slot)
+    {
+        index[slot] = -1;
+
+        auto next = (slot + 1) & mask;
+        while (index[next] != -1)
+        {
+            auto ideal = nodes[index[next]].hash & mask;
+
+            bool in_chain = slot <= next ? (slot < ideal && ideal <= next) : (slot < ideal || ideal <= next);
+            if (!in_chain)
+            {
+                index[slot] = index[next];
+                index[next] = -1;
+                slot = next;
+            }
+
+            next = (next + 1) & mask;
+        }
+    }
+
+    void unlink(int32_t n)
+    {
+        auto &nd = nodes[n];
+
+        if (nd.prev != -1) nodes[nd.prev].next = nd.next; else head = nd.next;
+        if (nd.next != -1) nodes[nd.next].prev = nd.prev; else tail = nd.prev;
+
+        nd.prev = nd.next = -1;
+    }
+
+    void link_front(int32_t n)
+    {
+        nodes[n].prev = -1;
+        nodes[n].next = head;
+
+        if (head != -1) nodes[head].prev = n;
+        head = n;
+
+        if (tail == -1) tail = n;
+    }
+};
+
+}
@@ -0,0 +1,27 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace wui
+{
+
+struct point
+{
+    int32_t x, y;
+
+    inline bool operator==(const point &lv) const
+    {
+        return x == lv.x && y == lv.y;
+    }
+};
+
+}
@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+/// The piece table of the text. The original text and the inserted texts are kept unchanged in two buffers,
+/// the text is the sequence of the pieces of these buffers. The pieces are the nodes of the treap counting
+/// the size and the line breaks of the subtrees, so the edit and the line to offset lookup take the log of the pieces count
+class text_buffer
+{
+public:
+    text_buffer(std::string_view text = "");
+
+    void assign(std::string_view text);
+    void clear();
+
+    size_t size() const;
+    bool empty() const;
+
+    /// The lines are separated by '\n', the text without breaks has one line
+    size_t lines_count() const;
+
+    void insert(size_t offset, std::string_view text);
+    void erase(size_t offset, size_t count);
+
+    char at(size_t offset) const;
+
+    /// Append the part of the text to the string
+    void copy(size_t offset, size_t count, std::string &out) const;
+    std::string to_string() const;
+
+    /// The offset of the line's first char, the lines_count() is the size()
+    size_t line_start(size_t line) const;
+    /// The line of the char at the offset
+    size_t offset_line(size_t offset) const;
+
+    /// Append the line without the break to the string
+    void line(size_t n, std::string &out) const;
+
+private:
+    struct node
+    {
+        bool added; /// the piece of the added buffer
+        size_t start, length;
+        size_t breaks;
+
+        uint32_t priority;
+        int32_t left, right;
+
+        size_t sum_length, sum_breaks; /// of the subtree
+    };
+
+    std::string original, added;
+    std::vector<size_t> original_breaks, added_breaks; /// the positions of '\n' in the buffers
+
+    std::vector<node> nodes;
+    std::vector<int32_t> free_nodes;
+    int32_t root;
+
+    uint32_t seed;
+
+    int32_t new_node(bool added_, size_t start, size_t length);
+    void free_tree(int32_t n);
+
+    size_t count_breaks(bool added_, size_t start, size_t length) const;
+    void update(int32_t n);
+
+    int32_t merge(int32_t l, int32_t r);
+    void split(int32_t t, size_t offset, int32_t &l, int32_t &r);
+
+    bool extend_last(int32_t t, size_t start, size_t length, size_t breaks);
+
+    void copy_tree(int32_t t, size_t offset, size_t count, std::string &out) const;
+};
+
+}
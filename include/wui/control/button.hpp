@@ -65,6 +65,7 @@ public:
     virtual bool topmost() const;
 
     virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
     virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
 
     virtual void show();
@@ -90,6 +91,8 @@ public:
 #endif
     void set_image(std::string_view file_name);
     void set_image(const std::vector<uint8_t> &image_data);
+    /// Use the image from theme's atlas
+    void set_theme_image(std::string_view name, std::shared_ptr<i_theme> theme_ = nullptr);
 
     void enable_focusing();
     void disable_focusing();
@@ -137,6 +140,7 @@ private:
 
     std::string tcn; /// control name in theme
     std::shared_ptr<i_theme> theme_;
+    font_handle text_font, anchor_font;
 
     rect position_;
 
@@ -0,0 +1,176 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/control/i_control.hpp>
+#include <wui/graphic/graphic.hpp>
+#include <wui/event/event.hpp>
+#include <wui/common/rect.hpp>
+#include <wui/common/point.hpp>
+#include <wui/common/color.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+namespace wui
+{
+
+/// The real time chart of the sample series. Each pixel column shows the minimum and the maximum
+/// of its samples, the series is drawn by one polyline. The appending is safe from any thread,
+/// the drawn columns are moved left by the new samples, only the new columns are drawn
+class chart : public i_control, public std::enable_shared_from_this<chart>
+{
+public:
+    chart(std::string_view theme_control_name = tc, std::shared_ptr<i_theme> theme_ = nullptr);
+    ~chart();
+
+    virtual void draw(graphic &gr, const rect &);
+
+    virtual void set_position(const rect &position, bool redraw = true);
+    virtual rect position() const;
+
+    virtual void set_parent(std::shared_ptr<window> window_);
+    virtual std::weak_ptr<window> parent() const;
+    virtual void clear_parent();
+
+    virtual void set_topmost(bool yes);
+    virtual bool topmost() const;
+
+    virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
+    virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
+
+    virtual void show();
+    virtual void hide();
+    virtual bool showed() const;
+
+    virtual void enable();
+    virtual void disable();
+    virtual bool enabled() const;
+
+    virtual bool focused() const;
+    virtual bool focusing() const;
+
+    virtual error get_error() const;
+
+public:
+    /// Chart's interface
+
+    /// Return the number of the added series. The samples of all the series have the same rate,
+    /// the sample n of the each series is drawn in the same column
+    int32_t add_series(color color_);
+    int32_t series_count() const;
+
+    void set_series_color(int32_t series, color color_);
+
+    /// Thread safe
+    void append(int32_t series, const float *values, size_t count);
+
+    /// Thread safe. The samples of all the series are removed
+    void clear();
+
+    /// The count of the samples drawn in one pixel column
+    void set_samples_per_pixel(int32_t count);
+    int32_t samples_per_pixel() const;
+
+    /// The values shown from the bottom to the top of the chart
+    void set_range(float min_value, float max_value);
+
+    /// The count of the parts divided by the horizontal lines
+    void set_divisions(int32_t count);
+
+public:
+    /// Control name in theme
+    static constexpr const char *tc = "chart";
+
+    /// Used theme values
+    static constexpr const char *tv_background = "background";
+    static constexpr const char *tv_border = "border";
+    static constexpr const char *tv_border_width = "border_width";
+    static constexpr const char *tv_line = "line";
+    static constexpr const char *tv_round = "round";
+
+    /// The user_emitted event's x of the repaint requested by the appending threads
+    static const int32_t repaint_event_id = 3559;
+
+private:
+    std::string tcn; /// control name in theme
+    std::shared_ptr<i_theme> theme_;
+
+    rect position_;
+
+    std::weak_ptr<window> parent_;
+    std::string my_plain_sid;
+
+    /// The parent for the appending threads, they post the repaint to the UI thread by the window's emit_event()
+    std::mutex async_parent_mutex;
+    std::weak_ptr<window> async_parent;
+
+    bool showed_;
+
+    struct series
+    {
+        color color_;
+
+        std::vector<float> ring; /// the sample n is at n % ring's size
+        uint64_t total; /// the count of the appended samples
+
+        uint64_t drawn; /// the count of the samples drawn to the buffer
+    };
+
+    /// Guards the series and the view's parameters
+    mutable std::mutex series_mutex;
+
+    std::vector<series> series_;
+
+    int32_t samples_per_pixel_;
+    float min_value, max_value;
+    int32_t divisions;
+
+    uint64_t clear_epoch;
+
+    std::atomic<bool> repaint_requested;
+
+    /// The columns are blitted left by the count of new columns, only the columns having the new samples are drawn.
+    /// Two buffers are used because the overlapped copy to itself is not supported by cairo
+    std::unique_ptr<graphic> front, back;
+    int32_t buffer_width, buffer_height;
+    bool buffer_valid;
+    int64_t rendered_last; /// the column drawn at the right side
+    uint64_t rendered_epoch;
+
+    std::vector<rect> lines;
+
+    /// The polylines are made under the lock and drawn after it, so the appending is not waiting the drawing
+    struct path
+    {
+        color color_;
+        std::vector<point> points;
+    };
+    std::vector<path> paths;
+
+    void redraw();
+    void post_redraw(); /// thread safe
+    void receive_plain_events(const event &ev);
+
+    void update_capacity(); /// needs series_mutex
+    uint64_t chart_total() const; /// needs series_mutex
+
+    bool update_buffers(system_context &ctx, int32_t width, int32_t height);
+    void render();
+    void make_path(const series &s, int64_t first, int64_t last, std::vector<point> &points_) const;
+    bool column_min_max(const series &s, int64_t column, float &min_, float &max_) const;
+    int32_t value_y(float value) const;
+};
+
+}
@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/control/i_control.hpp>
+#include <wui/control/i_grid_source.hpp>
+#include <wui/graphic/graphic.hpp>
+#include <wui/event/event.hpp>
+#include <wui/common/rect.hpp>
+#include <wui/common/color.hpp>
+#include <wui/common/alignment.hpp>
+#include <wui/common/lru_cache.hpp>
+#include <wui/control/scroll.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+
+namespace wui
+{
+
+/// The table of the source's cells. Only the visible rows and columns are asked and drawn,
+/// the header row and the first frozen columns are not scrolled
+class grid : public i_control, public std::enable_shared_from_this<grid>
+{
+public:
+    grid(std::string_view theme_control_name = tc, std::shared_ptr<i_theme> theme_ = nullptr);
+    ~grid();
+
+    virtual void draw(graphic &gr, const rect &);
+
+    virtual void set_position(const rect &position, bool redraw = true);
+    virtual rect position() const;
+
+    virtual void set_parent(std::shared_ptr<window> window_);
+    virtual std::weak_ptr<window> parent() const;
+    virtual void clear_parent();
+
+    virtual void set_topmost(bool yes);
+    virtual bool topmost() const;
+
+    virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
+    virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
+
+    virtual void show();
+    virtual void hide();
+    virtual bool showed() const;
+
+    virtual void enable();
+    virtual void disable();
+    virtual bool enabled() const;
+
+    virtual bool focused() const;
+    virtual bool focusing() const;
+
+    virtual error get_error() const;
+
+public:
+    /// Grid's interface
+    void set_source(std::shared_ptr<i_grid_source> source);
+    std::shared_ptr<i_grid_source> source() const;
+
+    /// Call after the source's rows or columns count is changed
+    void update();
+    /// Call after the cell's text is changed, the row -1 is the header
+    void update_cell(int32_t row, int32_t column);
+
+    void set_default_column_width(int32_t width);
+    void set_column_width(int32_t column, int32_t width);
+    int32_t column_width(int32_t column) const;
+
+    void set_column_alignment(int32_t column, hori_alignment alignment);
+
+    void set_row_height(int32_t height);
+    int32_t row_height() const;
+
+    /// The first columns are not scrolled horizontally
+    void set_frozen_columns(int32_t count);
+    int32_t frozen_columns() const;
+
+    void select_row(int32_t row);
+    int32_t selected_row() const;
+
+    void set_row_change_callback(std::function<void(int32_t)> row_change_callback);
+    void set_row_activate_callback(std::function<void(int32_t)> row_activate_callback);
+    void set_cell_click_callback(std::function<void(int32_t row, int32_t column)> cell_click_callback);
+
+public:
+    /// Control name in theme
+    static constexpr const char *tc = "grid";
+
+    /// Used theme values
+    static constexpr const char *tv_background = "background";
+    static constexpr const char *tv_border = "border";
+    static constexpr const char *tv_focused_border = "focused_border";
+    static constexpr const char *tv_border_width = "border_width";
+    static constexpr const char *tv_text = "text";
+    static constexpr const char *tv_header = "header";
+    static constexpr const char *tv_header_text = "header_text";
+    static constexpr const char *tv_line = "line";
+    static constexpr const char *tv_selected_item = "selected_item";
+    static constexpr const char *tv_round = "round";
+    static constexpr const char *tv_font = "font";
+
+private:
+    std::string tcn; /// control name in theme
+    std::shared_ptr<i_theme> theme_;
+    font_handle text_font;
+
+    rect position_;
+
+    std::weak_ptr<window> parent_;
+    std::string my_control_sid;
+
+    bool showed_, enabled_, focused_, mouse_on_control;
+
+    std::shared_ptr<i_grid_source> source_;
+
+    int32_t rows_count, columns_count;
+
+    int32_t default_column_width;
+    std::vector<int32_t> widths;
+    std::vector<int32_t> lefts; /// the column's left from the first column, the last is the width of all the columns
+    std::vector<hori_alignment> alignments;
+
+    int32_t row_height_;
+    int32_t frozen_columns_;
+
+    int32_t selected_row_;
+
+    /// The texts fitted to the cells with the ellipsis. The cell is measured again if its text or width is changed
+    struct cell_text
+    {
+        std::string text, shown;
+        int32_t available, width;
+    };
+    lru_cache<std::pair<int32_t, int32_t>, cell_text> text_cache;
+    std::string text_buffer;
+    std::vector<size_t> boundaries;
+
+    std::unique_ptr<graphic> content;
+    int32_t content_width, content_height;
+    int32_t text_height;
+
+    std::vector<rect> lines;
+
+    std::shared_ptr<scroll> vert_scroll, hori_scroll, mouse_scroll;
+
+    std::function<void(int32_t)> row_change_callback, row_activate_callback;
+    std::function<void(int32_t, int32_t)> cell_click_callback;
+
+    void receive_control_events(const event &ev);
+    bool route_to_scroll(const event &ev);
+
+    void on_scroll(scroll_state, int32_t);
+
+    void redraw();
+
+    void update_columns();
+    void update_scroll_areas();
+
+    int32_t view_width() const;
+    int32_t view_height() const;
+    int32_t frozen_width() const;
+
+    int32_t column_left(int32_t column) const; /// in the view, the scrolling is counted
+    int32_t find_column(int32_t x) const;
+    int32_t find_row(int32_t y) const;
+
+    void make_row_visible(int32_t row);
+    void change_selected_row(int32_t row);
+
+    bool update_content(system_context &ctx, int32_t width, int32_t height);
+    void draw_cells(graphic &gr_, int32_t row, int32_t first_column, int32_t last_column, int32_t top, color text_color, font_handle font_);
+    void draw_cell_text(graphic &gr_, int32_t row, int32_t column, const rect &cell_rect, color text_color, font_handle font_);
+    void fit_text(graphic &gr_, cell_text &ct, font_handle font_);
+};
+
+}
@@ -38,6 +38,7 @@ public:
     virtual bool topmost() const = 0;
 
     virtual void update_theme_control_name(std::string_view theme_control_name) = 0;
+    virtual std::string_view theme_control_name() const = 0;
     virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr) = 0;
 
     virtual void show() = 0;
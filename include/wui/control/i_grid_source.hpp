@@ -0,0 +1,34 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace wui
+{
+
+/// The data of the grid. The grid asks the visible cells only on each paint,
+/// so the source can be a view over the large external storage
+class i_grid_source
+{
+public:
+    virtual int32_t rows_count() const = 0;
+    virtual int32_t columns_count() const = 0;
+
+    /// Append the text to the empty string, the string's memory is reused by the grid
+    virtual void header(int32_t column, std::string &text) = 0;
+    virtual void cell(int32_t row, int32_t column, std::string &text) = 0;
+
+protected:
+    ~i_grid_source() {}
+};
+
+}
@@ -28,6 +28,8 @@
 namespace wui
 {
 
+class image_atlas;
+
 class image : public i_control, public std::enable_shared_from_this<image>
 {
 public:
@@ -51,6 +53,7 @@ public:
     virtual bool topmost() const;
 
     virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
     virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
 
     virtual void show();
@@ -75,6 +78,9 @@ public:
     void change_image(std::string_view file_name);
     void change_image(const std::vector<uint8_t> &data);
 
+    /// Take the image from theme's atlas, the image not decoded and follows the theme changing
+    void change_theme_image(std::string_view name, std::shared_ptr<i_theme> theme_ = nullptr);
+
     int32_t width() const;
     int32_t height() const;
 
@@ -96,6 +102,10 @@ private:
     bool showed_, topmost_;
 
     std::string file_name;
+
+    std::string theme_image_name;
+    std::shared_ptr<image_atlas> atlas;
+    rect atlas_rect;
 	
 #ifdef _WIN32
     int32_t resource_index;
@@ -106,6 +116,7 @@ private:
 
     error err;
 
+    void reset_atlas();
     void redraw();
 };
 
@@ -16,8 +16,12 @@
 #include <wui/common/color.hpp>
 #include <wui/system/timer.hpp>
 #include <wui/control/menu.hpp>
+#include <wui/control/scroll.hpp>
+#include <wui/common/text_buffer.hpp>
+#include <wui/common/edit_journal.hpp>
 
 #include <string>
+#include <vector>
 #include <functional>
 #include <memory>
 
@@ -51,6 +55,7 @@ public:
     virtual bool topmost() const;
 
     virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
     virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
 
     virtual void show();
@@ -71,9 +76,24 @@ public:
     void set_text(std::string_view text);
     std::string text() const;
 
+    /// The multiline view keeps the text in the piece table, only the visible lines are measured and drawn
     void set_input_view(input_view input_view_);
 
+    /// The lines of the multiline view, the other views have one line
+    size_t lines_count() const;
+    std::string line(size_t n) const;
+
+    /// The typed chars are undone by runs, the journal's oldest steps are dropped over the memory budget
+    void undo();
+    void redo();
+    bool can_undo() const;
+    bool can_redo() const;
+    void set_undo_memory_budget(size_t bytes);
+
+    /// The change callback gets the full text, in the multiline view it is copied from the piece table on each edit
     void set_change_callback(std::function<void(const std::string&)> change_callback);
+    /// Called on each edit without the text, use it with text() or line() for the big multiline texts
+    void set_modify_callback(std::function<void()> modify_callback);
     void set_return_callback(std::function<void()> return_callback);
 
 public:
@@ -99,12 +119,18 @@ public:
 private:
     input_view input_view_;
     std::string text_;
+    text_buffer buffer_; /// the text of the multiline view
+    edit_journal journal;
     
     std::function<void(const std::string&)> change_callback;
+    std::function<void()> modify_callback;
     std::function<void()> return_callback;
 
     std::string tcn; /// control name in theme
     std::shared_ptr<i_theme> theme_;
+    font_handle text_font;
+    font_handle line_font; /// of the single line views, the password is drawn by the monospace font
+    int32_t line_font_size;
 
     rect position_;
     size_t cursor_position, select_start_position, select_end_position;
@@ -120,9 +146,23 @@ private:
     bool focused_;
     bool cursor_visible;
     bool selecting;
+    bool mouse_on_control, mouse_on_slider;
 
     int32_t left_shift;
 
+    /// The multiline view's lines are drawn to the content, the view follows the cursor after the edits and the moves
+    std::unique_ptr<graphic> content;
+    int32_t content_width, content_height;
+    int32_t line_height;
+    size_t top_line;
+    bool follow_cursor;
+    std::string line_buffer;
+    std::vector<size_t> boundaries;
+
+    std::shared_ptr<scroll> vert_scroll;
+    int32_t scroll_area;
+    bool updating_scroll;
+
     void receive_control_events(const event &ev);
     void receive_plain_events(const event &ev);
 
@@ -130,11 +170,38 @@ private:
 
     void redraw_cursor();
 
+    bool multiline() const;
+
+    size_t text_size() const;
+    char char_at(size_t position) const;
+    std::string text_part(size_t position, size_t count) const;
+    void insert_text(size_t position, std::string_view text, bool typing = false);
+    void erase_text(size_t position, size_t count, bool typing = false);
+    void apply_edit(edit_journal::operation operation_, size_t position, std::string_view text); /// not journaled
+    void notify_change();
+
+    size_t prev_char(size_t position);
+    size_t next_char(size_t position);
+
+    void draw_multiline(graphic &gr, const rect &control_pos);
+    bool update_content(system_context &ctx, int32_t width, int32_t height);
+    void make_cursor_visible(font_handle font_);
+    void update_line_font();
+
+    int32_t line_text_width(size_t count, font_handle font_); /// of the line_buffer's begin
+    size_t line_position(size_t n, int32_t x); /// the offset nearest to the x in the line
+    void move_cursor_line(int64_t lines, bool shift_pressed);
+
+    int32_t visible_lines() const;
+    void update_scroll();
+    void on_scroll(scroll_state, int32_t);
+    bool has_scrollbar() const;
+
     void update_select_positions(bool shift_pressed, size_t start_position, size_t end_position);
 
     bool clear_selected_text(); /// returns true if selection is not empty
 
-    void select_current_word(int32_t x);
+    void select_current_word(int32_t x, int32_t y);
 
     void select_all();
 
@@ -143,7 +210,7 @@ private:
     void move_cursor_left();
     void move_cursor_right();
 
-    size_t calculate_mouse_cursor_position(int32_t x);
+    size_t calculate_mouse_cursor_position(int32_t x, int32_t y);
 
     void buffer_copy();
     void buffer_cut();
@@ -45,6 +45,7 @@ public:
     virtual bool topmost() const;
 
     virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
     virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
 
     virtual void show();
@@ -78,10 +79,15 @@ public:
     };
     void set_mode(list_mode mode);
     
-    void select_item(int32_t n_item);
+    /// make_visible scrolls the list to the item, false keeps the scroll position
+    void select_item(int32_t n_item, bool make_visible = true);
     int32_t selected_item() const;
 
     void set_column_width(int32_t n_column, int32_t width);
+
+    /// The same height of all the items, the item height callback is not called then and the item's top is calculated
+    /// without the summing of the previous items, so the list of millions items is scrolled fast. -1 uses the callback
+    void set_item_height(int32_t height);
     int32_t get_item_height(int32_t n_item) const;
     
     void set_item_count(int32_t count);
@@ -133,6 +139,7 @@ public:
 private:
     std::string tcn; /// control name in theme
     std::shared_ptr<i_theme> theme_;
+    font_handle text_font;
 
     rect position_;
     
@@ -149,6 +156,8 @@ private:
 
     int32_t title_height;
 
+    int32_t fixed_item_height;
+
     int32_t scroll_area;
 
     std::shared_ptr<scroll> vert_scroll;
@@ -176,6 +185,8 @@ private:
 
     bool has_scrollbar();
 
+    int32_t find_item(int32_t pos) const;
+
     void update_selected_item(int32_t y);
     void update_active_item(int32_t y);
 
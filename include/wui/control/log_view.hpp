@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/control/i_control.hpp>
+#include <wui/graphic/graphic.hpp>
+#include <wui/event/event.hpp>
+#include <wui/common/rect.hpp>
+#include <wui/common/color.hpp>
+#include <wui/control/scroll.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+
+namespace wui
+{
+
+/// The view of the streaming text lines. The lines are kept in the ring of fixed capacity,
+/// the texts are in the one arena, so the appending does not allocate and the oldest lines are dropped.
+/// The appending is safe from any thread, the appends between two paints are drawn by one repaint
+class log_view : public i_control, public std::enable_shared_from_this<log_view>
+{
+public:
+    log_view(size_t lines_capacity = 10000, size_t arena_size = 1024 * 1024,
+        std::string_view theme_control_name = tc, std::shared_ptr<i_theme> theme_ = nullptr);
+    ~log_view();
+
+    virtual void draw(graphic &gr, const rect &);
+
+    virtual void set_position(const rect &position, bool redraw = true);
+    virtual rect position() const;
+
+    virtual void set_parent(std::shared_ptr<window> window_);
+    virtual std::weak_ptr<window> parent() const;
+    virtual void clear_parent();
+
+    virtual void set_topmost(bool yes);
+    virtual bool topmost() const;
+
+    virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
+    virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
+
+    virtual void show();
+    virtual void hide();
+    virtual bool showed() const;
+
+    virtual void enable();
+    virtual void disable();
+    virtual bool enabled() const;
+
+    virtual bool focused() const;
+    virtual bool focusing() const;
+
+    virtual error get_error() const;
+
+public:
+    /// Log view's interface
+    enum class severity
+    {
+        debug,
+        info,
+        warning,
+        error
+    };
+
+    /// Thread safe. The text having the line breaks is appended as the several lines
+    void append(std::string_view text, severity severity_ = severity::info);
+
+    /// Thread safe
+    void clear();
+
+    size_t lines_count() const;
+    /// The line number 0 is the oldest kept line
+    std::string line(size_t n) const;
+
+    /// The view follows the appended lines. Scrolling up stops the following, scrolling to the end resumes it
+    void set_follow_tail(bool yes);
+    bool follow_tail() const;
+
+    /// Draw the lines with the theme's color of its severity, otherwise all the lines have the text color
+    void set_severity_coloring(bool yes);
+    bool severity_coloring() const;
+
+public:
+    /// Control name in theme
+    static constexpr const char *tc = "log_view";
+
+    /// Used theme values
+    static constexpr const char *tv_background = "background";
+    static constexpr const char *tv_border = "border";
+    static constexpr const char *tv_focused_border = "focused_border";
+    static constexpr const char *tv_border_width = "border_width";
+    static constexpr const char *tv_text = "text";
+    static constexpr const char *tv_debug_text = "debug_text";
+    static constexpr const char *tv_warning_text = "warning_text";
+    static constexpr const char *tv_error_text = "error_text";
+    static constexpr const char *tv_round = "round";
+    static constexpr const char *tv_font = "font";
+
+    /// The user_emitted event's x of the repaint requested by the appending threads
+    static const int32_t repaint_event_id = 3558;
+
+private:
+    std::string tcn; /// control name in theme
+    std::shared_ptr<i_theme> theme_;
+    font_handle text_font;
+
+    rect position_;
+
+    std::weak_ptr<window> parent_;
+    std::string my_control_sid, my_plain_sid;
+
+    /// The parent for the appending threads, they post the repaint to the UI thread by the window's emit_event()
+    std::mutex async_parent_mutex;
+    std::weak_ptr<window> async_parent;
+
+    bool showed_, enabled_, focused_, mouse_on_control, mouse_on_slider;
+
+    struct line_data
+    {
+        uint32_t offset, size;
+        severity severity_;
+    };
+
+    /// Guards the ring, the arena and the view's line numbers
+    mutable std::mutex lines_mutex;
+
+    std::vector<line_data> lines;
+    size_t head, count; /// the oldest line and the count of kept lines
+    uint64_t total; /// the number of the next appended line, counted from the start
+
+    std::vector<char> arena;
+    size_t write_pos;
+
+    uint64_t clear_epoch;
+
+    bool follow_tail_, severity_coloring_;
+    uint64_t top_line; /// the number of the first visible line when not following
+
+    std::atomic<bool> repaint_requested;
+
+    /// The content is blitted up by the count of new rows, only these are drawn.
+    /// Two buffers are used because the overlapped copy to itself is not supported by cairo
+    std::unique_ptr<graphic> front, back;
+    int32_t buffer_width, buffer_height;
+    bool buffer_valid;
+    uint64_t rendered_top, rendered_end, rendered_epoch;
+
+    int32_t row_height;
+
+    int32_t scroll_area;
+    bool updating_scroll;
+
+    std::shared_ptr<scroll> vert_scroll;
+
+    void receive_control_events(const event &ev);
+
+    void on_scroll(scroll_state, int32_t);
+
+    void redraw();
+    void post_redraw(); /// thread safe
+    void receive_plain_events(const event &ev);
+
+    void push_line(std::string_view text, severity severity_);
+    void drop_oldest();
+
+    int32_t rows_fit() const;
+    uint64_t visible_top() const; /// needs lines_mutex
+
+    bool update_buffers(system_context &ctx, int32_t width, int32_t height);
+    void draw_rows(graphic &gr_, uint64_t from, uint64_t to, uint64_t top);
+    void render();
+
+    void update_scroll();
+    void scroll_to(uint64_t line);
+
+    bool has_scrollbar();
+};
+
+}
@@ -19,6 +19,7 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <functional>
 #include <memory>
 
@@ -26,6 +27,7 @@ namespace wui
 {
 
 class image;
+class theme_overlay;
 
 struct menu_item;
 
@@ -55,7 +57,7 @@ struct menu_item
 
     std::function<void(int32_t)> click_callback;
 
-    int32_t level; menu_item_state prev_state; /// don't fill
+    int32_t level, row; menu_item_state prev_state; /// don't fill
 
     inline bool operator==(int32_t id_)
     {
@@ -82,6 +84,7 @@ public:
     virtual bool topmost() const;
 
     virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
     virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
 
     virtual void show();
@@ -128,11 +131,12 @@ public:
     static constexpr const char *tv_font = "font";
 
 private:
-    std::shared_ptr<i_theme> list_theme;
+    std::shared_ptr<theme_overlay> list_theme; /// the few list values over the menu's theme
     std::shared_ptr<list> list_;
 
     std::string tcn; /// control name in theme
     std::shared_ptr<i_theme> theme_;
+    font_handle text_font;
 
     rect position_;
 
@@ -144,6 +148,17 @@ private:
 
     std::vector<menu_item> items;
 
+    /// The node of each id. The parent is nullptr for the top level items
+    struct item_node
+    {
+        menu_item *item, *parent;
+    };
+    std::unordered_map<int32_t, item_node> items_by_id;
+
+    /// The visible rows of the list in the order. The edit or the expanding of the item updates its subtree's rows only,
+    /// the item's row field is its index here, renumbered after the splice
+    std::vector<menu_item*> rows, subtree_rows;
+
     int32_t max_text_width, max_hotkey_width;
 
     int32_t item_height_;
@@ -157,6 +172,16 @@ private:
 
     void update_size();
 
+    void index_items(menu_items_t &items_, menu_item *parent);
+    void unindex_items(const menu_items_t &items_);
+    void append_rows(std::vector<menu_item*> &out, menu_items_t &items_, int32_t level);
+    void update_rows();
+    int32_t find_row(const menu_item *item) const;
+    int32_t subtree_end(int32_t row) const;
+    void update_subtree_rows(int32_t row, int32_t end);
+    void renumber_rows(int32_t from);
+    bool is_ancestor(const menu_item *ancestor, int32_t id) const;
+
     void draw_arrow_down(graphic &gr, rect pos, bool expanded);
     void draw_list_item(wui::graphic &gr, int32_t n_item, const wui::rect &item_rect_, list::item_state state);
     void activate_list_item(int32_t n_item);
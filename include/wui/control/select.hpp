@@ -17,13 +17,18 @@
 #include <wui/control/list.hpp>
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include <memory>
 #include <vector>
+#include <unordered_map>
+#include <chrono>
 
 namespace wui
 {
 
+class theme_overlay;
+
 struct select_item;
 
 typedef std::vector<select_item> select_items_t;
@@ -59,6 +64,7 @@ public:
     virtual bool topmost() const;
 
     virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
     virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
 
     virtual void show();
@@ -89,6 +95,13 @@ public:
 
     void set_change_callback(std::function<void(int32_t /* number */, int64_t /* id */)> change_callback);
 
+    /// The popup list shows at most count items and scrolls the rest, 0 (default) shows all the items
+    void set_max_visible_items(int32_t count);
+
+    /// Return the number of the first item in the text order whose text starts with the prefix, ASCII case insensitive.
+    /// Uses the index built by set_items(), -1 if nothing is found. The typed characters select the item by this
+    int32_t find_item(std::string_view prefix) const;
+
 public:
     /// Control name in theme
     static constexpr const char *tc = "select";
@@ -112,17 +125,28 @@ public:
 private:
     std::vector<select_item> items_;
 
+    /// id -> number and the ids sorted by the case folded text, for select_item_id() and the type-ahead.
+    /// The ids are not changed by the deletion or the swap, so the text order is not renumbered
+    std::unordered_map<int64_t, int32_t> numbers_by_id;
+    std::vector<int64_t> text_order;
+
+    int32_t max_visible_items;
+
+    std::string typed_prefix;
+    std::chrono::steady_clock::time_point last_typed;
+
     std::function<void(int32_t, int64_t)> change_callback;
     
     std::string tcn; /// control name in theme
     std::shared_ptr<i_theme> theme_;
+    font_handle text_font;
 
     rect position_;;
     
     std::weak_ptr<window> parent_;
     std::string my_control_sid, my_plain_sid;
 
-    std::shared_ptr<i_theme> list_theme;
+    std::shared_ptr<theme_overlay> list_theme; /// the few list values over the select's theme
     std::shared_ptr<list> list_;
 
     bool showed_, enabled_, active, topmost_;
@@ -147,6 +171,13 @@ private:
 
     void show_list();
 
+    const std::string &item_text(int64_t id) const;
+    bool text_less(int64_t first, int64_t second) const;
+    void index_text(int64_t id);
+    void unindex_text(int64_t id);
+
+    void type_ahead(const keyboard_event &ev);
+
     void draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect_, list::item_state state);
     void activate_list_item(int32_t n_item);
     void change_list_item(int32_t n_item);
@@ -0,0 +1,236 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/control/i_control.hpp>
+#include <wui/graphic/graphic.hpp>
+#include <wui/event/event.hpp>
+#include <wui/common/rect.hpp>
+#include <wui/common/color.hpp>
+
+#include <wui/control/list.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace wui
+{
+
+class theme_overlay;
+
+struct tree_item
+{
+    std::string text;
+
+    bool has_children;
+
+    int64_t data; /// the user's value, for example the id of the file
+};
+
+/// The tree of nodes drawn by the list. The children of the node are requested from the provider
+/// when the node is expanded first time, the provider can load them in the other thread
+class tree : public i_control, public std::enable_shared_from_this<tree>
+{
+public:
+    tree(std::string_view theme_control_name = tc, std::shared_ptr<i_theme> theme_ = nullptr);
+    ~tree();
+
+    virtual void draw(graphic &gr, const rect &);
+
+    virtual void set_position(const rect &position, bool redraw = true);
+    virtual rect position() const;
+
+    virtual void set_parent(std::shared_ptr<window> window_);
+    virtual std::weak_ptr<window> parent() const;
+    virtual void clear_parent();
+
+    virtual void set_topmost(bool);
+    virtual bool topmost() const;
+
+    virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
+    virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
+
+    virtual void show();
+    virtual void hide();
+    virtual bool showed() const;
+
+    virtual void enable();
+    virtual void disable();
+    virtual bool enabled() const;
+
+    virtual bool focused() const;
+    virtual bool focusing() const;
+
+    virtual error get_error() const;
+
+public:
+    /// Tree's interface
+
+    /// The node having the top level nodes as the children, it is not shown
+    static constexpr int32_t root_node = 0;
+
+    /// Set the top level nodes, the previous nodes are removed
+    void set_items(const std::vector<tree_item> &items);
+
+    /// Fill the children of the node, called on the UI thread
+    void set_children_provider(std::function<void(int32_t node, std::vector<tree_item> &children)> children_provider);
+
+    /// Start the loading of the children and call ready() from any thread when they are loaded.
+    /// The node shows the loading row till that
+    void set_async_children_provider(std::function<void(int32_t node, std::function<void(std::vector<tree_item> &&children)> ready)> async_children_provider);
+
+    const tree_item &item(int32_t node) const;
+    int32_t parent_node(int32_t node) const;
+    int32_t node_level(int32_t node) const;
+
+    void expand(int32_t node);
+    void collapse(int32_t node);
+    bool expanded(int32_t node) const;
+
+    /// Remove the loaded children, they are requested again on the next expand
+    void reload(int32_t node);
+
+    /// The collapsed ancestors of the node are expanded
+    void select_node(int32_t node);
+    int32_t selected_node() const;
+
+    int32_t visible_count() const;
+
+    void set_item_height(int32_t item_height);
+
+    void set_node_change_callback(std::function<void(int32_t)> node_change_callback);
+    void set_node_activate_callback(std::function<void(int32_t)> node_activate_callback);
+
+public:
+    /// Control name in theme
+    static constexpr const char *tc = "tree";
+
+    /// Used theme values
+    static constexpr const char *tv_background = "background";
+    static constexpr const char *tv_border = "border";
+    static constexpr const char *tv_focused_border = "focused_border";
+    static constexpr const char *tv_border_width = "border_width";
+    static constexpr const char *tv_text = "text";
+    static constexpr const char *tv_loading_text = "loading_text";
+    static constexpr const char *tv_expander = "expander";
+    static constexpr const char *tv_selected_item = "selected_item";
+    static constexpr const char *tv_active_item = "active_item";
+    static constexpr const char *tv_scrollbar = "scrollbar";
+    static constexpr const char *tv_scrollbar_slider = "scrollbar_slider";
+    static constexpr const char *tv_scrollbar_slider_acive = "scrollbar_slider_active";
+    static constexpr const char *tv_round = "round";
+    static constexpr const char *tv_font = "font";
+
+    /// Used locale values
+    static constexpr const char *cl_loading = "loading";
+
+    /// The user_emitted event's x of the loaded children
+    static const int32_t loaded_event_id = 3557;
+
+private:
+    std::shared_ptr<theme_overlay> list_theme; /// the few list values over the tree's theme
+    std::shared_ptr<list> list_;
+
+    std::string tcn; /// control name in theme
+    std::shared_ptr<i_theme> theme_;
+    font_handle text_font;
+
+    std::weak_ptr<window> parent_;
+    std::string my_subscriber_id;
+
+    enum class node_state
+    {
+        collapsed,
+        loading,
+        expanded
+    };
+
+    struct node
+    {
+        tree_item item;
+
+        int32_t parent, index; /// the index in the parent's children
+        int32_t level;
+
+        node_state state;
+        bool loaded;
+        uint32_t ticket; /// the async loading is applied to the same loading only
+
+        std::vector<int32_t> children;
+
+        /// The Fenwick tree over the visible rows of the children's subtrees,
+        /// so the row is found and the expanding is counted for the log of the children count
+        std::vector<int32_t> children_rows;
+
+        int32_t rows; /// the visible rows of the subtree, the node itself is counted
+    };
+
+    std::vector<node> nodes;
+    std::vector<int32_t> free_nodes;
+
+    std::function<void(int32_t, std::vector<tree_item>&)> children_provider;
+    std::function<void(int32_t, std::function<void(std::vector<tree_item>&&)>)> async_children_provider;
+
+    struct loaded_children
+    {
+        int32_t node;
+        uint32_t ticket;
+        std::vector<tree_item> children;
+    };
+    /// Shared with the ready() functions, so the provider's thread does not hold the tree
+    struct loaded_queue
+    {
+        std::mutex mutex;
+        std::vector<loaded_children> items;
+    };
+    std::shared_ptr<loaded_queue> loaded;
+
+    std::function<void(int32_t)> node_change_callback, node_activate_callback;
+
+    int32_t selected;
+    bool selecting; /// the list's selection is moved by the tree
+
+    int32_t item_height_;
+
+    void update_list_theme();
+
+    void receive_event(const event &ev);
+
+    int32_t new_node(const tree_item &item, int32_t parent, int32_t index);
+    void free_children(int32_t node);
+    void set_children(int32_t node, std::vector<tree_item> &children);
+
+    void add_rows(int32_t node, int32_t delta);
+    int32_t children_rows_sum(const node &n, int32_t count) const;
+
+    struct row
+    {
+        int32_t node;
+        bool loading;
+    };
+    row find_row(int32_t n_row) const;
+    int32_t node_row(int32_t node) const;
+
+    void apply_loaded();
+    void update_count();
+
+    bool valid(int32_t node) const;
+
+    void draw_expander(graphic &gr, const rect &pos, bool expanded);
+    void draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect, list::item_state state);
+    void activate_list_item(int32_t n_item);
+    void change_list_item(int32_t n_item);
+};
+
+}
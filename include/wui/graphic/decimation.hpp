@@ -0,0 +1,24 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/graphic/pixel_format.hpp>
+
+#include <cstddef>
+
+namespace wui
+{
+
+/// Find the minimum and the maximum of the values, the count must be above zero.
+/// The NaN values are not supported. The kernel is selected as the pixels conversion's one
+void min_max(const float *values, size_t count, float &min_value, float &max_value,
+    pixel_kernel kernel = pixel_kernel::best);
+
+}
@@ -0,0 +1,137 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/common/rect.hpp>
+#include <wui/common/point.hpp>
+#include <wui/common/color.hpp>
+#include <wui/common/font.hpp>
+
+#include <wui/graphic/pixel_format.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+#ifdef _WIN32
+namespace Gdiplus { class Image; }
+#elif __linux__
+struct _cairo_surface;
+#endif
+
+namespace wui
+{
+
+class graphic;
+
+/// The drawing commands recorded by graphic::begin_recording(). Used by the window's retained mode
+/// to replay the controls without executing their draw() and to find the changed areas by comparing the lists
+class display_list
+{
+public:
+    display_list();
+
+    void clear();
+    bool empty() const;
+    size_t size() const;
+
+    /// Union of the commands bounds
+    rect bounds() const;
+
+    void add_clear(const rect &position);
+    void add_pixel(const rect &position, color color_);
+    void add_line(const rect &position, color color_, uint32_t width);
+    void add_polyline(const point *points, size_t count, color color_, uint32_t width);
+    void add_pixels(const point *points, size_t count, color color_);
+    void add_lines(const rect *positions, size_t count, color color_);
+    void add_rects(const rect *positions, size_t count, color fill_color);
+    void add_text(const rect &position, const rect &bounds, std::string_view text, color color_, font_handle font_);
+    void add_rect(const rect &position, color fill_color);
+    void add_rect(const rect &position, color border_color, color fill_color, uint32_t border_width, uint32_t round);
+
+    /// The commands below keep the pointer to the source, the source content is not known,
+    /// so these commands are always treated as changed by diff()
+    void add_buffer(const rect &position, uint8_t *buffer, int32_t left_shift, int32_t top_shift);
+    void add_buffer(const rect &position, const uint8_t *buffer, pixel_format format, int32_t stride, int32_t left_shift, int32_t top_shift, bool premultiply);
+    void add_graphic(const rect &position, graphic &graphic_, int32_t left_shift, int32_t top_shift);
+#ifdef _WIN32
+    void add_surface(Gdiplus::Image &surface, const rect &position);
+    void add_surface(Gdiplus::Image &surface, const rect &source, const rect &position);
+#elif __linux__
+    void add_surface(_cairo_surface &surface, const rect &position);
+    void add_surface(_cairo_surface &surface, const rect &source, const rect &position);
+#endif
+
+    /// The list has no commands drawing another graphic, so it can be replayed by the other thread
+    bool thread_safe() const;
+    /// Union of the bounds of the commands which are not thread safe
+    rect unsafe_bounds() const;
+
+    /// Draw the commands whose bounds intersect the area. The null area draws all.
+    /// The commands are moved by -x_origin, -y_origin, used to draw the area to the graphic of its size
+    void replay(graphic &gr, const rect &area, int32_t x_origin = 0, int32_t y_origin = 0) const;
+
+    /// Append to damage the bounds of the commands that differ between the lists
+    static void diff(const display_list &prev, const display_list &next, std::vector<rect> &damage);
+
+private:
+    enum class command_type : uint8_t
+    {
+        clear,
+        pixel,
+        line,
+        polyline,
+        pixels,
+        lines,
+        rects,
+        text,
+        rect,
+        rounded_rect,
+        buffer,
+        format_buffer,
+        graphic,
+        surface,
+        scaled_surface
+    };
+
+    struct command
+    {
+        command_type type;
+
+        rect position, bounds, source;
+        color color_, fill_color;
+        uint32_t width, round;
+        int32_t font_id, left_shift, top_shift, stride;
+        pixel_format format;
+        bool premultiply;
+
+        size_t text_offset, text_size;
+        size_t points_offset, points_size;
+
+        const void *pointer;
+    };
+
+    std::vector<command> commands;
+    std::string texts;
+    std::vector<point> points; /// the rect is kept as two points
+
+    rect bounds_;
+    bool thread_safe_;
+    rect unsafe_bounds_;
+
+    command &add(command_type type, const rect &position, const rect &bounds);
+    command &add_point_command(command_type type, const point *points_, size_t count, int32_t outset);
+    command &add_rect_command(command_type type, const rect *positions, size_t count, int32_t outset);
+
+    bool equal(const command &a, const command &b, const display_list &b_list) const;
+};
+
+}
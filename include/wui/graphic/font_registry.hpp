@@ -0,0 +1,25 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/common/font.hpp>
+
+namespace wui
+{
+
+/// Return the handle of the font, equal fonts always have the same handle.
+/// The handles live until the application exit, so the registry is not bounded: it keeps every distinct font
+/// once. Intern the fonts once (the theme does it on load), not on each draw
+font_handle intern_font(const font &font_);
+
+/// Return the font by it's handle or the empty font for the invalid handle
+font get_interned_font(font_handle handle);
+
+}
@@ -13,15 +13,25 @@
 
 #include <wui/common/color.hpp>
 #include <wui/common/rect.hpp>
+#include <wui/common/point.hpp>
 #include <wui/common/font.hpp>
 #include <wui/common/error.hpp>
 
 #include <wui/graphic/primitive_container.hpp>
+#include <wui/graphic/pixel_format.hpp>
+#include <wui/graphic/overdraw_map.hpp>
+#include <wui/graphic/display_list.hpp>
+#include <wui/graphic/primitive_batch.hpp>
 
+#include <string>
 #include <string_view>
+#include <vector>
 #include <cstdint>
 
-#ifdef __linux__
+#ifdef _WIN32
+namespace Gdiplus { class Image; }
+#elif __linux__
+struct _cairo;
 struct _cairo_surface;
 struct _cairo_device;
 #endif
@@ -38,6 +48,10 @@ public:
     bool init(const rect &max_size, color background_color);
     void release();
 
+    /// Init the graphic in the memory only, without the system drawable. The image graphic is not bound to the window's
+    /// connection, so the different image graphics can be drawn by the different threads. Composited by draw_graphic()
+    bool init_image(const rect &max_size, color background_color);
+
     void set_background_color(color background_color);
 
     void clear(const rect &position);
@@ -48,20 +62,43 @@ public:
 
     void draw_line(const rect &position, color color_, uint32_t width = 1);
 
+    /// Draw the connected segments through the points by one system call
+    void draw_polyline(const point *points, size_t count, color color_, uint32_t width = 1);
+
     rect measure_text(std::string_view text, const font &font_);
     void draw_text(const rect &position, std::string_view text, color color_, const font &font_);
 
+    /// text functions taking the interned font, these are not copy and compare the font's name
+    rect measure_text(std::string_view text, font_handle font_);
+    void draw_text(const rect &position, std::string_view text, color color_, font_handle font_);
+
     void draw_rect(const rect &position, color fill_color);
     void draw_rect(const rect &position, color border_color, color fill_color, uint32_t border_width, uint32_t round);
 
+    /// The primitives of one color, each call is drawn by one system call. The lines are one pixel wide
+    void draw_pixels(const point *points, size_t count, color color_);
+    void draw_lines(const rect *positions, size_t count, color color_);
+    void draw_rects(const rect *positions, size_t count, color fill_color);
+
+    /// Draw the primitives of the different colors grouped by the color
+    void draw_batch(const primitive_batch &batch);
+
     /// draw some buffer on context
     void draw_buffer(const rect &position, uint8_t *buffer, int32_t left_shift, int32_t top_shift);
 
+    /// draw the buffer of other pixel format, rows are converted to native layout by simd kernels
+    void draw_buffer(const rect &position, const uint8_t *buffer, pixel_format format, int32_t stride, int32_t left_shift, int32_t top_shift, bool premultiply = false);
+
     /// draw another graphic on context
     void draw_graphic(const rect &position, graphic &graphic_, int32_t left_shift, int32_t top_shift);
 
 #ifdef _WIN32
     HDC drawable();
+
+    /// draw the image scaled to position, recorded unlike the drawing on drawable()
+    void draw_surface(Gdiplus::Image &image, const rect &position);
+    /// draw the source area of image scaled to position, used by image_atlas
+    void draw_surface(Gdiplus::Image &image, const rect &source, const rect &position);
 #elif __linux__
     xcb_drawable_t drawable();
 
@@ -70,10 +107,37 @@ public:
     void end_cairo_device();
 
     void draw_surface(_cairo_surface &surface, const rect &position);
+    /// draw the source area of surface scaled to position, used by image_atlas
+    void draw_surface(_cairo_surface &surface, const rect &source, const rect &position);
+
+    /// Return the MIT-SHM segment for the buffer of width * height pixels or nullptr if shm is unavailable.
+    /// The buffer filled by caller is passed to draw_buffer() without copying. The segment is created again
+    /// for the bigger size, so the returned pointer is invalidated by the call with the bigger size.
+    /// draw_buffer() rejects the segment smaller than its position
+    uint8_t *shared_buffer(int32_t width, int32_t height);
 #endif
 
     error get_error() const;
 
+    /// Return the usage counters of system objects caches
+    std::vector<cache_stats> get_cache_stats() const;
+
+    /// Debug counting of the writes per tile, used by window's overdraw heatmap.
+    /// Drawing on the drawable() directly is not counted
+    void set_overdraw_tracking(bool yes);
+    bool overdraw_tracking() const;
+    overdraw_map &get_overdraw_map();
+
+    /// While recording the drawing methods append the commands to the list instead of drawing,
+    /// measure_text() works as usual. Used by window's retained mode
+    void begin_recording(display_list &list);
+    void end_recording();
+    bool recording() const;
+
+    /// Restrict the drawing by the area, the null area removes the restriction
+    void set_clip(const rect &area);
+    rect clip() const;
+
 private:
     system_context &context_;
 
@@ -83,14 +147,72 @@ private:
 
     color background_color;
 
+    std::vector<uint8_t> convert_buffer;
+
+    std::string text_buffer;
+
+    /// The groups of the primitive_batch
+    std::vector<rect> batch_rects;
+    std::vector<point> batch_points;
+
+    bool overdraw_tracking_;
+    overdraw_map overdraw;
+
+    display_list *recording_list;
+
+    /// The last font recorded by draw_text(), the control passing the font usually draws all by one
+    font last_font;
+    font_handle last_font_handle;
+
+    rect clip_;
+
+    inline void track_write(const rect &position)
+    {
+        if (overdraw_tracking_)
+        {
+            overdraw.add_write(position);
+        }
+    }
+
 #ifdef _WIN32
+    std::wstring wide_text_buffer;
+    std::vector<POINT> poly_points;
+
     HDC mem_dc;
     HBITMAP mem_bitmap;
+
+    rect measure_text(std::string_view text, HFONT font_);
+    void draw_text(const rect &position, std::string_view text, color color_, HFONT font_);
 #elif __linux__
+    std::vector<xcb_point_t> poly_points;
+    std::vector<xcb_segment_t> poly_segments;
+
     xcb_pixmap_t mem_pixmap;
 
     _cairo_surface *surface;
     _cairo_device *device;
+
+    /// MIT-SHM segment used by draw_buffer()
+    bool shm_checked, shm_available;
+    uint32_t shm_segment;
+    uint8_t *shm_data;
+    size_t shm_size;
+    /// The last put of the segment is checked before the segment is written again, usually without the round trip
+    bool shm_pending;
+    xcb_void_cookie_t shm_put_cookie;
+
+    rect measure_text(std::string_view text, _cairo *font_);
+    void draw_text(const rect &position, std::string_view text, color color_, _cairo *font_, int32_t font_size);
+
+    /// Apply the clip area to the new cairo context or to the cached gc for one operation
+    void clip_context(_cairo *cr);
+    void clip_gc(xcb_gcontext_t gc);
+    void unclip_gc(xcb_gcontext_t gc);
+
+    bool prepare_shm(size_t size);
+    void release_shm();
+    void wait_shm();
+    bool draw_buffer_shm(const rect &position, uint8_t *buffer, int32_t left_shift, int32_t top_shift);
 #endif
 
     error err;
@@ -0,0 +1,72 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/common/rect.hpp>
+#include <wui/common/error.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <gdiplus.h>
+#elif __linux__
+struct _cairo_surface;
+#endif
+
+namespace wui
+{
+
+class graphic;
+
+/// Packs the theme's images into the single surface.
+/// Images are decoded once, then every icon is drawn as the sub rect of this surface
+class image_atlas
+{
+public:
+    image_atlas();
+    ~image_atlas();
+
+    /// Decode and pack all images, every image is scaled by scale factor
+    void build(const std::map<std::string, std::vector<uint8_t>> &images, double scale = 1.0);
+    void release();
+
+    /// Return the image's area on the atlas surface or empty rect if image not found
+    rect find(std::string_view name) const;
+
+    /// Draw the sub rect of atlas on the graphic
+    void draw(graphic &gr, const rect &source, const rect &position) const;
+
+    double scale() const;
+
+    int32_t width() const;
+    int32_t height() const;
+
+    error get_error() const;
+
+private:
+    std::map<std::string, rect> rects;
+
+    double scale_;
+
+#ifdef _WIN32
+    Gdiplus::Bitmap *surface;
+#elif __linux__
+    _cairo_surface *surface;
+#endif
+
+    error err;
+};
+
+}
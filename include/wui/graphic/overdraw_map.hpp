@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/common/rect.hpp>
+
+#include <vector>
+#include <cstdint>
+
+namespace wui
+{
+
+/// Per tile counters of the graphic's writes, the debug data of window's overdraw heatmap
+class overdraw_map
+{
+public:
+    static constexpr int32_t tile_size = 16;
+
+    overdraw_map();
+
+    void resize(int32_t width, int32_t height);
+    void reset();
+
+    /// Count the write to the tiles covered by position
+    void add_write(const rect &position);
+
+    /// Count the repaint of the tiles covered by position.
+    /// The writes made to the tile since its previous repaint become its overdraw depth
+    void add_flush(const rect &position);
+
+    int32_t columns() const;
+    int32_t rows() const;
+
+    /// Count of the tile repaints since the reset
+    uint32_t repaints(int32_t column, int32_t row) const;
+
+    /// Count of the writes to the tile during its last repaint
+    uint32_t depth(int32_t column, int32_t row) const;
+
+private:
+    int32_t columns_, rows_;
+
+    std::vector<uint32_t> writes, depths, repaints_;
+
+    /// Return false if position is out of map, else the covered tiles range [first, last]
+    bool tiles(const rect &position, int32_t &first_column, int32_t &first_row, int32_t &last_column, int32_t &last_row) const;
+};
+
+}
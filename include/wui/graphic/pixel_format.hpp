@@ -0,0 +1,49 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace wui
+{
+
+/// Layouts of the buffers accepted by graphic::draw_buffer()
+enum class pixel_format
+{
+    native,  /// 32 bit B, G, R, A bytes, the layout of system context
+    rgba32,  /// 32 bit R, G, B, A bytes
+    rgb24,   /// 24 bit R, G, B bytes
+    grey8    /// 8 bit luminance
+};
+
+/// Conversion kernels, best is selected on the first call by the cpu features
+enum class pixel_kernel
+{
+    best,
+    scalar,
+    sse2,
+    avx2
+};
+
+/// Return the fastest kernel supported by the cpu
+pixel_kernel best_pixel_kernel();
+
+/// Convert the source rows to the native layout.
+/// src_stride is the size of source row in bytes, 0 means the rows are tightly packed.
+/// If premultiply is set the color channels are multiplied by alpha
+void convert_pixels(const uint8_t *src, int32_t src_stride, pixel_format format,
+    uint8_t *dst, int32_t width, int32_t height,
+    bool premultiply = false,
+    pixel_kernel kernel = pixel_kernel::best);
+
+/// Return the size of one pixel of format in bytes
+int32_t pixel_size(pixel_format format);
+
+}
@@ -0,0 +1,72 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/common/rect.hpp>
+#include <wui/common/point.hpp>
+#include <wui/common/color.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+class graphic;
+
+/// The primitives of the different colors collected to be drawn by graphic::draw_batch().
+/// The rects, the lines, the polylines and the pixels are drawn in this order, each kind is grouped by the color
+/// and each group is drawn by one system call. So the overlapping primitives are not drawn in the adding order
+class primitive_batch
+{
+public:
+    primitive_batch();
+
+    void clear();
+    bool empty() const;
+
+    void add_rect(const rect &position, color fill_color);
+    void add_line(const rect &position, color color_);
+    void add_polyline(const point *points, size_t count, color color_);
+    void add_pixel(const point &position, color color_);
+
+private:
+    friend class graphic;
+
+    enum class kind : uint8_t
+    {
+        rect,
+        line,
+        polyline,
+        pixel
+    };
+
+    struct item
+    {
+        kind kind_;
+        color color_;
+        size_t offset, count; /// in the rects or in the points
+    };
+
+    std::vector<item> items;
+    std::vector<rect> rects; /// the rects and the lines
+    std::vector<point> points; /// the polylines and the pixels
+
+    /// The items ordered by the kind and the color, the adding order is kept in the group
+    mutable std::vector<size_t> order;
+    mutable bool sorted;
+
+    void add(kind kind_, color color_, size_t offset);
+
+    const std::vector<size_t> &sorted_items() const;
+};
+
+}
@@ -13,9 +13,11 @@
 #include <wui/common/rect.hpp>
 #include <wui/common/font.hpp>
 #include <wui/common/error.hpp>
+#include <wui/common/lru_cache.hpp>
 #include <wui/system/system_context.hpp>
 
-#include <map>
+#include <string>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -38,14 +40,20 @@ public:
 
     wui::error get_error() const;
 
+    /// Return the hits, misses and evictions of every system objects cache
+    std::vector<cache_stats> get_stats() const;
+
 #ifdef _WIN32
     HPEN get_pen(int32_t style, int32_t width, color color_);
     HBRUSH get_brush(color color_);
-    HFONT get_font(font font_);
+    HFONT get_font(const font &font_);
+    HFONT get_font(font_handle font_);
     HBITMAP get_bitmap(int32_t width, int32_t height, uint8_t *buffer, HDC hdc);
 #elif __linux__
     xcb_gcontext_t get_gc(color color_);
-    _cairo *get_font(font font_, _cairo_surface *surface);
+    _cairo *get_font(const font &font_, _cairo_surface *surface);
+    _cairo *get_font(font_handle font_, _cairo_surface *surface);
+    int32_t get_font_size(font_handle font_) const;
 #endif
 
 private:
@@ -53,14 +61,26 @@ private:
 
     wui::error err;
 
+    /// The caches are bounded, the least recently used objects are freed to not leak them on many colors
 #ifdef _WIN32
-    std::map<std::pair<std::pair<int32_t, int32_t>, color>, HPEN> pens;
-    std::map<int32_t, HBRUSH> brushes;
-    std::map<std::pair<std::pair<std::string, int32_t>, decorations>, HFONT> fonts;
-    std::map<std::pair<int32_t, int32_t>, HBITMAP> bitmaps;
+    lru_cache<std::pair<std::pair<int32_t, int32_t>, color>, HPEN> pens;
+    lru_cache<color, HBRUSH> brushes;
+    lru_cache<std::pair<std::pair<std::string, int32_t>, decorations>, HFONT> fonts;
+    lru_cache<std::pair<int32_t, int32_t>, HBITMAP> bitmaps;
+
+    /// Fonts by interned handle's id, the lookup is the plain indexing
+    std::vector<HFONT> interned_fonts;
 #elif __linux__
-    std::map<color, xcb_gcontext_t> gcs;
-    std::map<std::pair<std::pair<std::string, int32_t>, decorations>, _cairo*> fonts;
+    lru_cache<color, xcb_gcontext_t> gcs;
+    lru_cache<std::pair<std::pair<std::string, int32_t>, decorations>, _cairo*> fonts;
+
+    /// Fonts by interned handle's id, the lookup is the plain indexing
+    struct interned_font
+    {
+        _cairo *cr;
+        int32_t size;
+    };
+    std::vector<interned_font> interned_fonts;
 #endif
 };
 
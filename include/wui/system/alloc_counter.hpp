@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace wui
+{
+
+namespace alloc_counter
+{
+
+/// What the thread is doing when the allocation happens
+enum class phase : int32_t
+{
+    none,
+    dispatch, /// mouse, keyboard and system events handling
+    layout,   /// size and state changes handling
+    paint
+};
+
+/// The counting replaces global operator new, so it is compiled only with WUI_ALLOC_COUNTER defined.
+/// Without it the counters stay zero and available() returns false
+bool available();
+
+/// The counter is off by default, the disabled counter costs one atomic load per phase change
+void enable();
+void disable();
+bool enabled();
+
+/// Sets the calling thread's phase until destruction. The paint scopes are attributed to the control name
+class scope
+{
+public:
+    scope(phase phase_, std::string_view control_name = "");
+    ~scope();
+
+    scope(const scope &) = delete;
+    scope &operator=(const scope &) = delete;
+
+private:
+    bool active;
+    phase prev_phase;
+    int32_t prev_slot;
+};
+
+struct control_allocs
+{
+    std::string control;
+    uint64_t count, bytes;
+};
+
+/// Allocations made since the previous frame end, the frame is ended by each window paint
+struct frame_stats
+{
+    uint64_t frame;
+
+    uint64_t dispatch_count, dispatch_bytes;
+    uint64_t layout_count, layout_bytes;
+    uint64_t paint_count, paint_bytes;
+
+    std::vector<control_allocs> controls; /// paint allocations by the control, the window's own drawing goes as "window"
+};
+
+/// Called by the window after the paint
+void end_frame();
+
+/// The statistics of the last ended frame
+frame_stats last_frame();
+
+/// The test mode: after the warmup_frames ended frames, every frame whose paint allocates calls the callback.
+/// The default callback prints the frame to stderr and aborts, so the steady state repaint must not allocate.
+/// The negative warmup_frames turns the mode off
+void set_paint_budget(int32_t warmup_frames, std::function<void(const frame_stats&)> violation_callback = nullptr);
+
+/// Return the frame statistics as json document
+std::string dump_json(const frame_stats &stats);
+
+}
+
+}
@@ -0,0 +1,64 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/common/rect.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace wui
+{
+
+class i_control;
+class graphic;
+
+namespace paint_profiler
+{
+
+/// Count of the duration histogram buckets, bucket n holds the draws taken [2^n, 2^(n+1)) nanoseconds
+static constexpr int32_t histogram_size = 40;
+
+/// Drawing statistics of the controls with the same theme control name
+struct paint_stats
+{
+    std::string control;
+
+    uint64_t count, total_ns, max_ns;
+    uint64_t total_area, max_area; /// painted area in pixels
+
+    std::array<uint64_t, histogram_size> histogram;
+};
+
+/// The profiler is off by default, the disabled profiler costs one atomic load per draw
+void enable();
+void disable();
+bool enabled();
+
+/// Draw the control measuring it if profiler is enabled. Used by window's paint loop
+void draw_control(i_control &control, graphic &gr, const rect &paint_rect);
+
+/// Add the one draw measurement, the data goes to the calling thread's histograms without locking
+void record(std::string_view control_name, uint64_t duration_ns, uint64_t area);
+
+/// Return the statistics merged from all threads, the most expensive controls goes first
+std::vector<paint_stats> get_stats();
+
+/// Return the statistics as json document
+std::string dump_json();
+
+void reset();
+
+}
+
+}
@@ -56,6 +56,7 @@ rect get_popup_position(std::weak_ptr<window> parent, const rect &base_position,
 
 /// This function truncates the string
 void truncate_line(std::string &line, graphic &gr, const font &font_, int32_t width, int32_t truncating_count = 10);
+void truncate_line(std::string &line, graphic &gr, font_handle font_, int32_t width, int32_t truncating_count = 10);
 
 /// Service on Linux
 #ifdef __linux__
@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+namespace wui
+{
+
+namespace tracer
+{
+
+/// Value of span argument meaning the span has no argument
+static constexpr int64_t no_arg = INT64_MIN;
+
+/// The tracer is off by default. Enabling it allocates the ring buffer of capacity spans,
+/// when the buffer is full the oldest spans are overwritten
+void enable(size_t capacity = 65536);
+void disable();
+
+/// Defined in tracer.cpp, read inline so the disabled spans cost one atomic load
+extern std::atomic<bool> enabled_;
+
+inline bool enabled()
+{
+    return enabled_.load(std::memory_order_relaxed);
+}
+
+/// Monotonic time in nanoseconds used by the spans
+uint64_t now();
+
+/// Put the finished span to the ring buffer. name and category must be string literals
+void add(const char *name, const char *category, uint64_t start_ns, uint64_t duration_ns, int64_t arg = no_arg);
+
+/// Records the span from construction to destruction
+class span
+{
+public:
+    span(const char *name_, const char *category_, int64_t arg_ = no_arg)
+        : name(name_), category(category_), arg(arg_), start(enabled() ? now() : 0)
+    {
+    }
+
+    ~span()
+    {
+        if (start != 0 && enabled())
+        {
+            add(name, category, start, now() - start, arg);
+        }
+    }
+
+    span(const span &) = delete;
+    span &operator=(const span &) = delete;
+
+private:
+    const char *name, *category;
+    int64_t arg;
+    uint64_t start;
+};
+
+/// Return the recorded spans in Chrome trace event json format (chrome://tracing, Perfetto)
+std::string dump_chrome_json();
+
+/// Write the Chrome trace json to the file, returns false if file can't be written
+bool save(std::string_view file_name);
+
+/// Remove all recorded spans
+void clear();
+
+}
+
+}
@@ -0,0 +1,69 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace wui
+{
+
+/// The pool of threads executing the batches of tasks. Each thread takes the tasks from the back of its own queue
+/// and steals from the front of the other queues when its own is empty, so the uneven tasks are balanced
+class work_pool
+{
+public:
+    /// The threads_count includes the calling thread, 0 takes the hardware concurrency
+    work_pool(int32_t threads_count = 0);
+    ~work_pool();
+
+    work_pool(const work_pool &) = delete;
+    work_pool &operator=(const work_pool &) = delete;
+
+    int32_t threads_count() const;
+
+    /// Execute the tasks_count tasks and wait all them. The calling thread executes the tasks too.
+    /// The task gets its index and the index of executing thread, 0 is the calling thread,
+    /// so the per thread resources can be indexed without locking
+    void run(size_t tasks_count, const std::function<void(size_t task, int32_t thread)> &task);
+
+private:
+    struct queue
+    {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::unique_ptr<queue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex state_mutex;
+    std::condition_variable wake, done;
+    uint64_t generation;
+    bool stopping;
+
+    const std::function<void(size_t, int32_t)> *task_;
+    std::atomic<size_t> remaining;
+
+    void work(int32_t index);
+    void execute(int32_t index);
+
+    bool pop(int32_t index, size_t &task);
+    bool steal(int32_t index, size_t &task);
+};
+
+}
@@ -16,10 +16,13 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include <memory>
 
 namespace wui
 {
 
+class image_atlas;
+
 class i_theme
 {
 public:
@@ -36,10 +39,15 @@ public:
 
     virtual void set_font(std::string_view control, std::string_view value, const font &font_) = 0;
     virtual font get_font(std::string_view control, std::string_view value) const = 0;
+    /// Return the interned handle of font, fonts are interned once by set_font and on loading
+    virtual font_handle get_font_handle(std::string_view control, std::string_view value) const = 0;
 
     virtual void set_image(std::string_view name, const std::vector<uint8_t> &data) = 0;
     virtual const std::vector<uint8_t> &get_image(std::string_view name) = 0;
 
+    /// Return all theme's images packed to the one surface, atlas is builded once per scale
+    virtual std::shared_ptr<image_atlas> get_image_atlas(double scale) = 0;
+
 #ifdef _WIN32
     virtual void load_resource(int32_t resource_index, std::string_view resource_section) = 0;
 #endif
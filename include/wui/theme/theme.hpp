@@ -50,6 +50,12 @@ const std::string &theme_string(std::string_view control, std::string_view value
 /// Return the item's font value by current theme
 font theme_font(std::string_view control, std::string_view value, std::shared_ptr<i_theme> theme_ = nullptr);
 
+/// Return the item's interned font handle by current theme, used by graphic without the font copying
+font_handle theme_font_handle(std::string_view control, std::string_view value, std::shared_ptr<i_theme> theme_ = nullptr);
+
 const std::vector<uint8_t> &theme_image(std::string_view name, std::shared_ptr<i_theme> theme_ = nullptr);
 
+/// Return the atlas of all current theme's images for the scale
+std::shared_ptr<image_atlas> theme_image_atlas(double scale = 1.0, std::shared_ptr<i_theme> theme_ = nullptr);
+
 }
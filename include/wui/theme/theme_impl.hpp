@@ -12,6 +12,7 @@
 #include <wui/theme/i_theme.hpp>
 
 #include <map>
+#include <mutex>
 
 namespace wui
 {
@@ -34,10 +35,13 @@ public:
 
     virtual void set_font(std::string_view control, std::string_view value, const font &font_);
     virtual font get_font(std::string_view control, std::string_view value) const;
+    virtual font_handle get_font_handle(std::string_view control, std::string_view value) const;
 
     virtual void set_image(std::string_view name, const std::vector<uint8_t> &data);
     virtual const std::vector<uint8_t> &get_image(std::string_view name);
 
+    virtual std::shared_ptr<image_atlas> get_image_atlas(double scale);
+
 #ifdef _WIN32
     virtual void load_resource(int32_t resource_index, std::string_view resource_section);
 #endif
@@ -50,11 +54,29 @@ public:
 private:
     std::string name;
 
-    std::map<std::pair<std::string, std::string>, int32_t> ints;
-    std::map<std::pair<std::string, std::string>, std::string> strings;
-    std::map<std::pair<std::string, std::string>, font> fonts;
+    /// Compares the keys with the string_view pairs, so the lookups don't allocate the key strings
+    struct key_less
+    {
+        using is_transparent = void;
+
+        template <typename L, typename R>
+        bool operator()(const L &l, const R &r) const
+        {
+            std::string_view lf(l.first), rf(r.first);
+            return lf < rf || (lf == rf && std::string_view(l.second) < std::string_view(r.second));
+        }
+    };
+
+    std::map<std::pair<std::string, std::string>, int32_t, key_less> ints;
+    std::map<std::pair<std::string, std::string>, std::string, key_less> strings;
+    std::map<std::pair<std::string, std::string>, font, key_less> fonts;
+    std::map<std::pair<std::string, std::string>, font_handle, key_less> font_handles;
     std::map<std::string, std::vector<uint8_t>> imgs;
 
+    /// Atlases by scale in percents
+    std::map<int32_t, std::shared_ptr<image_atlas>> atlases;
+    std::mutex atlases_mutex;
+
     std::string dummy_string;
     std::vector<uint8_t> dummy_image;
 
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/theme/i_theme.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace wui
+{
+
+/// The theme keeping only the values set to it, the others are read from the parent theme.
+/// The null parent means the current default theme, so the overlay follows the theme switching without copying.
+/// Used by the controls which adjust a few values of the theme for their inner controls
+class theme_overlay : public i_theme
+{
+public:
+    theme_overlay(std::shared_ptr<i_theme> parent = nullptr, std::string_view name = "");
+
+    void set_parent(std::shared_ptr<i_theme> parent);
+    std::shared_ptr<i_theme> parent() const;
+
+    /// Remove all the set values
+    void clear();
+
+    virtual std::string get_name() const;
+
+    virtual void set_color(std::string_view control, std::string_view value, color color_);
+    virtual color get_color(std::string_view control, std::string_view value) const;
+
+    virtual void set_dimension(std::string_view control, std::string_view value, int32_t dimension);
+    virtual int32_t get_dimension(std::string_view control, std::string_view value) const;
+
+    virtual void set_string(std::string_view control, std::string_view value, std::string_view str);
+    virtual const std::string &get_string(std::string_view control, std::string_view value) const;
+
+    virtual void set_font(std::string_view control, std::string_view value, const font &font_);
+    virtual font get_font(std::string_view control, std::string_view value) const;
+    virtual font_handle get_font_handle(std::string_view control, std::string_view value) const;
+
+    virtual void set_image(std::string_view name, const std::vector<uint8_t> &data);
+    virtual const std::vector<uint8_t> &get_image(std::string_view name);
+
+    /// The atlas of the parent, the images set to the overlay are not packed
+    virtual std::shared_ptr<image_atlas> get_image_atlas(double scale);
+
+    /// The overlay is not loaded, these set the error
+#ifdef _WIN32
+    virtual void load_resource(int32_t resource_index, std::string_view resource_section);
+#endif
+    virtual void load_json(std::string_view json);
+    virtual void load_file(std::string_view file_name);
+    virtual void load_theme(const i_theme &theme_);
+
+    virtual error get_error() const;
+
+private:
+    template <typename T>
+    struct entry
+    {
+        std::string control, value;
+        T data;
+    };
+
+    struct font_data
+    {
+        font font_;
+        font_handle handle;
+    };
+
+    std::string name;
+
+    std::shared_ptr<i_theme> parent_;
+
+    /// The overlays have a few values, so the vectors are searched faster than the maps
+    std::vector<entry<int32_t>> ints;
+    std::vector<entry<std::string>> strings;
+    std::vector<entry<font_data>> fonts;
+    std::vector<entry<std::vector<uint8_t>>> imgs;
+
+    std::string dummy_string;
+    std::vector<uint8_t> dummy_image;
+
+    error err;
+
+    i_theme *source() const;
+};
+
+}
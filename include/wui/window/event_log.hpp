@@ -0,0 +1,90 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/event/event.hpp>
+#include <wui/common/error.hpp>
+
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace wui
+{
+
+class window;
+
+/// Writes the events dispatched by the window to the compact binary log.
+/// Each record is the time delta in microseconds, the event type and the event fields packed by varints,
+/// the mouse coordinates are stored as deltas from the previous mouse event
+class event_recorder
+{
+public:
+    event_recorder();
+
+    void start();
+    void stop();
+    bool recording() const;
+
+    /// Called by the window for each event came from the system
+    void record(const event &ev);
+
+    /// Count of the recorded events
+    size_t count() const;
+
+    /// The log with the header, ready to be saved or passed to event_player::load()
+    std::vector<uint8_t> data() const;
+
+    bool save(std::string_view file_name) const;
+
+    void clear();
+
+private:
+    mutable std::mutex data_mutex;
+
+    std::vector<uint8_t> data_;
+    size_t count_;
+
+    bool recording_;
+    uint64_t prev_time;
+    int32_t prev_x, prev_y;
+};
+
+/// Dispatches the recorded events to the window. Intended for the headless windows (window_style::headless)
+/// to repeat the user's session as the performance test
+class event_player
+{
+public:
+    event_player();
+
+    bool load(std::string_view file_name);
+    bool load(const std::vector<uint8_t> &data);
+
+    size_t count() const;
+
+    /// Dispatch all the events and paint the window's damage after each one.
+    /// The speed 0 plays as fast as possible, 1.0 keeps the recorded intervals. Returns the play duration in nanoseconds
+    uint64_t play(window &window_, double speed = 0.0);
+
+    error get_error() const;
+
+private:
+    struct recorded_event
+    {
+        uint64_t time_us;
+        event ev;
+    };
+    std::vector<recorded_event> events;
+
+    error err;
+};
+
+}
@@ -35,6 +35,7 @@ enum class window_style : uint32_t
 
     title_showed = (1 << 10),
     topmost = (1 << 11),
+    headless = (1 << 12), /// the window is never shown, it is painted by window::paint() only
 
     border_left = (1 << 15),
     border_top = (1 << 16),
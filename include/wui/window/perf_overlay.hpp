@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#pragma once
+
+#include <wui/system/system_context.hpp>
+#include <wui/system/timer.hpp>
+#include <wui/graphic/graphic.hpp>
+#include <wui/common/rect.hpp>
+#include <wui/common/font.hpp>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace wui
+{
+
+/// What the overdraw heatmap shows in each tile
+enum class overdraw_heatmap
+{
+    none,
+    repaints, /// how many times the tile was repainted
+    overdraw  /// how many times the tile was written during its last repaint
+};
+
+/// The window's performance panel: fps, last paint time, dirty area, event queue depth and cache hit rates.
+/// The panel is drawn over the window's buffer just before the flush and the pixels under it are restored
+/// after, so the buffer always holds the clean content and the panel never invalidates the controls
+class perf_overlay
+{
+public:
+    /// refresh_callback is called from the timer thread, it must post the refresh to the window's painting thread
+    perf_overlay(system_context &context, std::function<void(void)> refresh_callback);
+    ~perf_overlay();
+
+    void show();
+    void hide();
+    bool showed() const;
+
+    /// The heatmap is drawn over the repainted areas the same way as the panel
+    void set_heatmap(overdraw_heatmap heatmap);
+    overdraw_heatmap heatmap() const;
+
+    /// Called by the paint handler before drawing the controls
+    void begin_paint();
+
+    /// Replaces graphic::flush() of the paint handler. Draws the heatmap and the panel over gr, flushes them
+    /// with the paint_rect, then restores the content under them. The null paint_rect refreshes only the overlay
+    void flush(graphic &gr, const rect &paint_rect, const rect &window_size);
+
+    /// Count of the events waiting to be processed, set by the window's event loop
+    void set_queue_depth(int32_t depth);
+
+    void release();
+
+private:
+    system_context &context_;
+
+    timer refresh_timer;
+
+    std::atomic<bool> showed_;
+
+    std::atomic<overdraw_heatmap> heatmap_;
+    std::atomic<bool> heatmap_changed;
+
+    graphic backup, heatmap_backup;
+    bool backup_inited, heatmap_backup_inited;
+
+    font_handle font_;
+
+    rect position_, flushed_position;
+
+    uint64_t paint_start, paint_ns, interval_start, frames;
+    double fps, dirty_percent;
+
+    std::atomic<int32_t> queue_depth;
+
+    std::vector<cache_stats> prev_caches;
+    std::vector<std::string> cache_lines;
+
+    void update_interval(graphic &gr, uint64_t now);
+    void draw(graphic &gr, const rect &window_size);
+    bool draw_heatmap(graphic &gr, const rect &area);
+};
+
+}
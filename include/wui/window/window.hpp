@@ -13,10 +13,16 @@
 #include <wui/system/system_context.hpp>
 #include <wui/control/i_control.hpp>
 #include <wui/graphic/graphic.hpp>
+#include <wui/system/work_pool.hpp>
+#include <wui/window/perf_overlay.hpp>
+#include <wui/window/event_log.hpp>
 #include <wui/common/rect.hpp>
 
 #include <vector>
+#include <deque>
+#include <unordered_map>
 #include <memory>
+#include <mutex>
 
 #include <thread>
 
@@ -82,6 +88,7 @@ public:
     virtual bool focusing() const;
 
     virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual std::string_view theme_control_name() const;
     virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
 
     virtual void show();
@@ -115,8 +122,41 @@ public:
     void enable_draw();
     bool draw_enabled() const;
 
+    /// Performance panel drawn over the controls: fps, paint time, dirty area, event queue and caches
+    void show_perf_overlay();
+    void hide_perf_overlay();
+    bool perf_overlay_showed() const;
+
+    /// Debug heatmap of the repaint frequency or the overdraw depth over the window
+    void show_overdraw_heatmap(overdraw_heatmap heatmap);
+    overdraw_heatmap overdraw_heatmap_mode() const;
+
+    /// Retained mode of the top level window: the controls are recorded to the display lists, only the controls
+    /// requested redraw are executed again and only the changed commands are rasterized
+    void set_retained_mode(bool yes);
+    bool retained_mode() const;
+
+    /// The count of threads rasterizing the large repaints of the retained mode by tiles. The tiles are drawn
+    /// to the image graphics and composited to the window's buffer. 1 (default) rasterizes on the window's thread only,
+    /// 0 takes the hardware concurrency
+    void set_raster_threads(int32_t count);
+    int32_t raster_threads() const;
+
     /// Emit event methods
     void emit_event(int32_t x, int32_t y);
+
+    /// Dispatch the mouse, keyboard, internal or system event as if it came from the system.
+    /// The focus keys are dispatched as the set_focus and execute_focused internal events
+    void dispatch_event(const event &ev);
+
+    /// Write the events came from the system to the recorder, nullptr stops the recording
+    void set_event_recorder(std::shared_ptr<event_recorder> recorder);
+
+    /// Paint the area synchronously, used by the system paint handlers and to paint the headless windows
+    void paint(const rect &paint_rect, bool clear = false);
+
+    /// Paint the area collected by redraw() of the headless window, returns the painted area
+    rect paint_damaged();
     
     /// Method to set the focus of the child control
     void set_focused(std::shared_ptr<i_control> control);
@@ -159,6 +199,8 @@ private:
     system_context context_;
     graphic graphic_;
 
+    perf_overlay perf_overlay_;
+
     std::vector<std::shared_ptr<i_control>> controls;
     std::shared_ptr<i_control> active_control;
 
@@ -170,9 +212,48 @@ private:
 
     std::string tcn; /// control name in theme
     std::shared_ptr<i_theme> theme_;
+    font_handle caption_font; /// resolved in update_theme()
 
     bool showed_, enabled_, skip_draw_;
 
+    /// Area to be painted by paint_damaged() in the headless window
+    std::mutex damage_mutex;
+    rect damage;
+    bool damage_clear;
+
+    /// Retained mode state, the dirty areas are collected under damage_mutex
+    struct retained_control
+    {
+        display_list list, next_list;
+        rect position;
+        uint64_t generation;
+        bool topmost;
+    };
+    bool retained_;
+    std::unordered_map<const i_control*, retained_control> retained_controls;
+    display_list window_list, next_window_list;
+    std::vector<rect> retained_dirty, retained_dirty_taken, retained_damage;
+    rect retained_size;
+    uint64_t retained_generation;
+
+    /// The non topmost content is kept in the base layer when the window has topmost controls,
+    /// so showing, moving or hiding them only copies the base pixels and replays their lists
+    bool layered;
+    graphic base_layer;
+    std::vector<rect> composite_damage;
+
+    /// Tiled rasterization, one image graphic per pool's thread
+    int32_t raster_threads_;
+    std::unique_ptr<work_pool> raster_pool;
+    std::vector<std::unique_ptr<graphic>> raster_graphics;
+    std::vector<rect> raster_tiles, raster_window_tiles; /// the latter are under the not thread safe commands
+    std::vector<rect> raster_unsafe;
+    std::mutex raster_mutex; /// guards the compositing to graphic_
+    color raster_background;
+
+    std::shared_ptr<event_recorder> event_recorder_;
+    int32_t dispatch_depth; /// the events sent while dispatching other one are not recorded
+
     size_t focused_index;
 
     std::weak_ptr<window> parent_;
@@ -244,7 +325,11 @@ private:
 
     uint8_t key_modifier;
 
+    /// Events read ahead from the connection while the perf overlay counts the queue depth
+    std::deque<xcb_generic_event_t*> pending_events;
+
     void process_events();
+    xcb_generic_event_t *next_event();
 
     void init_atoms();
 
@@ -261,6 +346,7 @@ private:
     void send_event_to_control(const std::shared_ptr<i_control> &control, const event &ev);
     void send_event_to_plains(const event &ev);
     void send_mouse_event(const mouse_event &ev);
+    void record_event(const event &ev);
 
     bool check_control_here(int32_t x, int32_t y);
 
@@ -277,6 +363,13 @@ private:
     void update_buttons();
 
     void draw_border(graphic &gr);
+    void draw_caption(graphic &gr, const rect &paint_rect);
+
+    rect paint_retained(const rect &paint_rect);
+    void rasterize(graphic &gr, const rect &area, int32_t x_origin, int32_t y_origin, bool with_topmost);
+    bool rasterize_tiled(graphic &target, bool with_topmost);
+
+    void request_perf_overlay_refresh();
 
     void send_internal(internal_event_type type, int32_t x, int32_t y);
     void send_system(system_event_type type, int32_t x, int32_t y);
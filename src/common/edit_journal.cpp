@@ -0,0 +1,264 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/common/edit_journal.hpp>
+
+namespace wui
+{
+
+/// The dropped begin of the arena is freed when it is bigger than this and than the used part
+static const size_t min_arena_compact = 4096;
+
+edit_journal::edit_journal(size_t memory_budget_)
+    : records(),
+    current(0),
+    arena(),
+    arena_start(0),
+    budget(memory_budget_),
+    group_depth(0),
+    group_records(0),
+    run_closed(true)
+{
+}
+
+void edit_journal::set_memory_budget(size_t bytes)
+{
+    budget = bytes;
+    trim();
+}
+
+size_t edit_journal::memory_budget() const
+{
+    return budget;
+}
+
+size_t edit_journal::memory_usage() const
+{
+    return arena.size() - arena_start + records.size() * sizeof(record);
+}
+
+void edit_journal::insert(size_t offset, std::string_view text, bool typing)
+{
+    add(operation::insert, offset, text, typing);
+}
+
+void edit_journal::erase(size_t offset, std::string_view text, bool typing)
+{
+    add(operation::erase, offset, text, typing);
+}
+
+void edit_journal::begin_group()
+{
+    if (group_depth++ == 0)
+    {
+        group_records = 0;
+    }
+}
+
+void edit_journal::end_group()
+{
+    if (group_depth > 0)
+    {
+        --group_depth;
+    }
+}
+
+void edit_journal::close_run()
+{
+    run_closed = true;
+}
+
+bool edit_journal::can_undo() const
+{
+    return current != 0;
+}
+
+bool edit_journal::can_redo() const
+{
+    return current != records.size();
+}
+
+bool edit_journal::undo(const apply_func &apply)
+{
+    if (current == 0)
+    {
+        return false;
+    }
+
+    run_closed = true;
+
+    do
+    {
+        --current;
+
+        auto &r = records[current];
+        apply(r.operation_ == operation::insert ? operation::erase : operation::insert,
+            r.offset,
+            std::string_view(arena).substr(r.text_offset, r.text_size));
+    }
+    while (current != 0 && records[current].joined);
+
+    return true;
+}
+
+bool edit_journal::redo(const apply_func &apply)
+{
+    if (current == records.size())
+    {
+        return false;
+    }
+
+    run_closed = true;
+
+    do
+    {
+        auto &r = records[current];
+        apply(r.operation_, r.offset, std::string_view(arena).substr(r.text_offset, r.text_size));
+
+        ++current;
+    }
+    while (current != records.size() && records[current].joined);
+
+    return true;
+}
+
+void edit_journal::clear()
+{
+    records.clear();
+    current = 0;
+
+    arena.clear();
+    arena_start = 0;
+
+    run_closed = true;
+}
+
+void edit_journal::add(operation operation_, size_t offset, std::string_view text, bool typing)
+{
+    if (text.empty())
+    {
+        return;
+    }
+
+    /// The new edit removes the undone steps, their texts are the arena's end
+    if (current != records.size())
+    {
+        arena.resize(records[current].text_offset);
+        records.resize(current);
+
+        run_closed = true;
+    }
+
+    if (typing && extend_run(operation_, offset, text))
+    {
+        return trim();
+    }
+
+    bool joined = group_depth > 0 && group_records != 0 && !records.empty();
+
+    records.push_back({ operation_, typing, joined, offset, arena.size(), text.size() });
+    arena.append(text.data(), text.size());
+    ++current;
+
+    if (group_depth > 0)
+    {
+        ++group_records;
+    }
+
+    run_closed = !typing;
+
+    trim();
+}
+
+bool edit_journal::extend_run(operation operation_, size_t offset, std::string_view text)
+{
+    if (run_closed || records.empty() || (group_depth > 0 && group_records != 0))
+    {
+        return false;
+    }
+
+    /// The last record's text is at the arena's end
+    auto &last = records.back();
+    if (!last.typing || last.operation_ != operation_)
+    {
+        return false;
+    }
+
+    if (operation_ == operation::insert)
+    {
+        if (offset != last.offset + last.text_size)
+        {
+            return false;
+        }
+        arena.append(text.data(), text.size());
+    }
+    else if (offset + text.size() == last.offset) /// backspace
+    {
+        arena.insert(last.text_offset, text.data(), text.size());
+        last.offset = offset;
+    }
+    else if (offset == last.offset) /// delete
+    {
+        arena.append(text.data(), text.size());
+    }
+    else
+    {
+        return false;
+    }
+
+    last.text_size += text.size();
+
+    return true;
+}
+
+void edit_journal::trim()
+{
+    while (!records.empty() && memory_usage() > budget)
+    {
+        if (current == 0)
+        {
+            return clear();
+        }
+        drop_oldest();
+    }
+
+    if (records.empty())
+    {
+        arena.clear();
+        arena_start = 0;
+    }
+    else if (arena_start > min_arena_compact && arena_start * 2 > arena.size())
+    {
+        arena.erase(0, arena_start);
+        for (auto &r : records)
+        {
+            r.text_offset -= arena_start;
+        }
+        arena_start = 0;
+    }
+}
+
+void edit_journal::drop_oldest()
+{
+    /// The step is dropped with its joined records
+    do
+    {
+        auto &r = records.front();
+        arena_start = r.text_offset + r.text_size;
+
+        records.pop_front();
+        if (current != 0)
+        {
+            --current;
+        }
+    }
+    while (!records.empty() && records.front().joined);
+}
+
+}
@@ -0,0 +1,450 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/common/text_buffer.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+text_buffer::text_buffer(std::string_view text)
+    : original(), added(),
+    original_breaks(), added_breaks(),
+    nodes(), free_nodes(),
+    root(-1),
+    seed(0x9e3779b9)
+{
+    assign(text);
+}
+
+void text_buffer::assign(std::string_view text)
+{
+    original.assign(text.data(), text.size());
+    added.clear();
+
+    original_breaks.clear();
+    added_breaks.clear();
+    for (size_t i = 0; i != original.size(); ++i)
+    {
+        if (original[i] == '\n')
+        {
+            original_breaks.push_back(i);
+        }
+    }
+
+    nodes.clear();
+    free_nodes.clear();
+    root = original.empty() ? -1 : new_node(false, 0, original.size());
+}
+
+void text_buffer::clear()
+{
+    assign("");
+}
+
+size_t text_buffer::size() const
+{
+    return root != -1 ? nodes[root].sum_length : 0;
+}
+
+bool text_buffer::empty() const
+{
+    return size() == 0;
+}
+
+size_t text_buffer::lines_count() const
+{
+    return (root != -1 ? nodes[root].sum_breaks : 0) + 1;
+}
+
+void text_buffer::insert(size_t offset, std::string_view text)
+{
+    if (text.empty())
+    {
+        return;
+    }
+    offset = (std::min)(offset, size());
+
+    auto start = added.size();
+    size_t breaks = 0;
+    for (size_t i = 0; i != text.size(); ++i)
+    {
+        if (text[i] == '\n')
+        {
+            added_breaks.push_back(start + i);
+            ++breaks;
+        }
+    }
+    added.append(text.data(), text.size());
+
+    int32_t l = -1, r = -1;
+    split(root, offset, l, r);
+
+    /// The typing continues the last added piece, so the pieces count is not grown by each char
+    if (!extend_last(l, start, text.size(), breaks))
+    {
+        l = merge(l, new_node(true, start, text.size()));
+    }
+
+    root = merge(l, r);
+}
+
+void text_buffer::erase(size_t offset, size_t count)
+{
+    auto size_ = size();
+    if (offset >= size_ || count == 0)
+    {
+        return;
+    }
+    count = (std::min)(count, size_ - offset);
+
+    int32_t l = -1, mr = -1, m = -1, r = -1;
+    split(root, offset, l, mr);
+    split(mr, count, m, r);
+
+    free_tree(m);
+
+    root = merge(l, r);
+}
+
+char text_buffer::at(size_t offset) const
+{
+    auto t = root;
+    while (t != -1)
+    {
+        auto &n = nodes[t];
+        size_t left_length = n.left != -1 ? nodes[n.left].sum_length : 0;
+
+        if (offset < left_length)
+        {
+            t = n.left;
+        }
+        else if (offset < left_length + n.length)
+        {
+            return (n.added ? added : original)[n.start + offset - left_length];
+        }
+        else
+        {
+            offset -= left_length + n.length;
+            t = n.right;
+        }
+    }
+    return 0;
+}
+
+void text_buffer::copy(size_t offset, size_t count, std::string &out) const
+{
+    auto size_ = size();
+    if (offset >= size_ || count == 0)
+    {
+        return;
+    }
+
+    copy_tree(root, offset, (std::min)(count, size_ - offset), out);
+}
+
+void text_buffer::copy_tree(int32_t t, size_t offset, size_t count, std::string &out) const
+{
+    if (t == -1 || count == 0)
+    {
+        return;
+    }
+
+    auto &n = nodes[t];
+    size_t left_length = n.left != -1 ? nodes[n.left].sum_length : 0;
+    auto end = offset + count, piece_end = left_length + n.length;
+
+    if (offset < left_length)
+    {
+        copy_tree(n.left, offset, (std::min)(end, left_length) - offset, out);
+    }
+
+    auto from = (std::max)(offset, left_length), to = (std::min)(end, piece_end);
+    if (from < to)
+    {
+        out.append((n.added ? added : original), n.start + from - left_length, to - from);
+    }
+
+    if (end > piece_end)
+    {
+        auto right_offset = offset > piece_end ? offset - piece_end : 0;
+        copy_tree(n.right, right_offset, end - piece_end - right_offset, out);
+    }
+}
+
+std::string text_buffer::to_string() const
+{
+    std::string out;
+    out.reserve(size());
+    copy(0, size(), out);
+    return out;
+}
+
+size_t text_buffer::line_start(size_t line_) const
+{
+    if (line_ == 0)
+    {
+        return 0;
+    }
+    if (line_ >= lines_count())
+    {
+        return size();
+    }
+
+    /// The line starts after the line_-th break
+    auto k = line_;
+    size_t offset = 0;
+
+    auto t = root;
+    while (t != -1)
+    {
+        auto &n = nodes[t];
+        size_t left_length = n.left != -1 ? nodes[n.left].sum_length : 0;
+        size_t left_breaks = n.left != -1 ? nodes[n.left].sum_breaks : 0;
+
+        if (k <= left_breaks)
+        {
+            t = n.left;
+            continue;
+        }
+        k -= left_breaks;
+
+        if (k <= n.breaks)
+        {
+            auto &breaks = n.added ? added_breaks : original_breaks;
+            auto first = std::lower_bound(breaks.begin(), breaks.end(), n.start);
+            return offset + left_length + (*(first + (k - 1)) - n.start) + 1;
+        }
+        k -= n.breaks;
+
+        offset += left_length + n.length;
+        t = n.right;
+    }
+
+    return size();
+}
+
+size_t text_buffer::offset_line(size_t offset) const
+{
+    size_t line_ = 0;
+
+    auto t = root;
+    while (t != -1)
+    {
+        auto &n = nodes[t];
+        size_t left_length = n.left != -1 ? nodes[n.left].sum_length : 0;
+
+        if (offset < left_length)
+        {
+            t = n.left;
+            continue;
+        }
+
+        line_ += n.left != -1 ? nodes[n.left].sum_breaks : 0;
+        offset -= left_length;
+
+        if (offset < n.length)
+        {
+            return line_ + count_breaks(n.added, n.start, offset);
+        }
+
+        line_ += n.breaks;
+        offset -= n.length;
+        t = n.right;
+    }
+
+    return line_;
+}
+
+void text_buffer::line(size_t n, std::string &out) const
+{
+    if (n >= lines_count())
+    {
+        return;
+    }
+
+    auto start = line_start(n);
+    auto end = n + 1 < lines_count() ? line_start(n + 1) - 1 : size();
+
+    copy(start, end - start, out);
+}
+
+int32_t text_buffer::new_node(bool added_, size_t start, size_t length)
+{
+    /// xorshift, the priorities need not be strong random
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    node n{ added_, start, length, count_breaks(added_, start, length), seed, -1, -1, 0, 0 };
+
+    int32_t index = 0;
+    if (!free_nodes.empty())
+    {
+        index = free_nodes.back();
+        free_nodes.pop_back();
+        nodes[index] = n;
+    }
+    else
+    {
+        index = static_cast<int32_t>(nodes.size());
+        nodes.push_back(n);
+    }
+
+    update(index);
+
+    return index;
+}
+
+void text_buffer::free_tree(int32_t n)
+{
+    if (n == -1)
+    {
+        return;
+    }
+
+    free_tree(nodes[n].left);
+    free_tree(nodes[n].right);
+
+    free_nodes.push_back(n);
+}
+
+size_t text_buffer::count_breaks(bool added_, size_t start, size_t length) const
+{
+    auto &breaks = added_ ? added_breaks : original_breaks;
+    return static_cast<size_t>(std::lower_bound(breaks.begin(), breaks.end(), start + length) - std::lower_bound(breaks.begin(), breaks.end(), start));
+}
+
+void text_buffer::update(int32_t t)
+{
+    auto &n = nodes[t];
+
+    n.sum_length = n.length;
+    n.sum_breaks = n.breaks;
+
+    if (n.left != -1)
+    {
+        n.sum_length += nodes[n.left].sum_length;
+        n.sum_breaks += nodes[n.left].sum_breaks;
+    }
+    if (n.right != -1)
+    {
+        n.sum_length += nodes[n.right].sum_length;
+        n.sum_breaks += nodes[n.right].sum_breaks;
+    }
+}
+
+int32_t text_buffer::merge(int32_t l, int32_t r)
+{
+    if (l == -1)
+    {
+        return r;
+    }
+    if (r == -1)
+    {
+        return l;
+    }
+
+    if (nodes[l].priority > nodes[r].priority)
+    {
+        auto right = merge(nodes[l].right, r);
+        nodes[l].right = right;
+        update(l);
+        return l;
+    }
+
+    auto left = merge(l, nodes[r].left);
+    nodes[r].left = left;
+    update(r);
+    return r;
+}
+
+void text_buffer::split(int32_t t, size_t offset, int32_t &l, int32_t &r)
+{
+    if (t == -1)
+    {
+        l = r = -1;
+        return;
+    }
+
+    size_t left_length = nodes[t].left != -1 ? nodes[nodes[t].left].sum_length : 0;
+
+    int32_t a = -1, b = -1;
+
+    if (offset <= left_length)
+    {
+        split(nodes[t].left, offset, a, b);
+        nodes[t].left = b;
+        update(t);
+
+        l = a;
+        r = t;
+    }
+    else if (offset >= left_length + nodes[t].length)
+    {
+        split(nodes[t].right, offset - left_length - nodes[t].length, a, b);
+        nodes[t].right = a;
+        update(t);
+
+        l = t;
+        r = b;
+    }
+    else
+    {
+        /// The offset is inside the piece, its tail is the new node (new_node() can move the nodes).
+        /// The tail takes the piece's priority, so it is not above the piece's ancestors
+        auto k = offset - left_length;
+        auto tail = new_node(nodes[t].added, nodes[t].start + k, nodes[t].length - k);
+        nodes[tail].priority = nodes[t].priority;
+
+        auto &n = nodes[t];
+        n.length = k;
+        n.breaks = count_breaks(n.added, n.start, k);
+
+        auto right = n.right;
+        n.right = -1;
+        update(t);
+
+        l = t;
+        r = merge(tail, right);
+    }
+}
+
+bool text_buffer::extend_last(int32_t t, size_t start, size_t length, size_t breaks)
+{
+    if (t == -1)
+    {
+        return false;
+    }
+
+    if (nodes[t].right != -1)
+    {
+        if (!extend_last(nodes[t].right, start, length, breaks))
+        {
+            return false;
+        }
+        update(t);
+        return true;
+    }
+
+    auto &n = nodes[t];
+    if (!n.added || n.start + n.length != start)
+    {
+        return false;
+    }
+
+    n.length += length;
+    n.breaks += breaks;
+    update(t);
+
+    return true;
+}
+
+}
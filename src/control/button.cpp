@@ -16,12 +16,22 @@
 
 #include <wui/theme/theme.hpp>
 
+#include <wui/graphic/font_registry.hpp>
+
 #include <wui/system/tools.hpp>
 #include <wui/common/flag_helpers.hpp>
 
 namespace wui
 {
 
+/// The anchor's caption is underlined
+static font_handle anchor_font_handle(std::string_view tcn, std::shared_ptr<i_theme> theme_)
+{
+    auto font_ = theme_font(tcn, button::tv_font, theme_);
+    font_.decorations_ = decorations::underline;
+    return intern_font(font_);
+}
+
 button::button(std::string_view caption_, std::function<void(void)> click_callback_, std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
     : button_view_(button_view::text),
     caption(caption_),
@@ -31,6 +41,7 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
     click_callback(click_callback_),
     tcn(theme_control_name_),
     theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)), anchor_font(anchor_font_handle(tcn, theme_)),
     position_(),
     parent_(),
     my_subscriber_id(),
@@ -45,18 +56,23 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
 
 std::shared_ptr<image> get_button_image(button_view button_view_, std::shared_ptr<i_theme> theme_)
 {
+    std::shared_ptr<image> img;
+
     switch (button_view_)
     {
         case button_view::switcher:
-            return std::make_shared<image>(theme_image(button::ti_switcher_on, theme_));
+            img = std::make_shared<image>(std::vector<uint8_t>());
+            img->change_theme_image(button::ti_switcher_on, theme_);
         break;
         case button_view::radio:
-            return std::make_shared<image>(theme_image(button::ti_radio_on, theme_));
+            img = std::make_shared<image>(std::vector<uint8_t>());
+            img->change_theme_image(button::ti_radio_on, theme_);
         break;
         default:
-            return nullptr;
         break;
     }
+
+    return img;
 }
 
 button::button(std::string_view caption_, std::function<void(void)> click_callback_, button_view button_view__, std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
@@ -68,6 +84,7 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
     click_callback(click_callback_),
     tcn(theme_control_name_),
     theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)), anchor_font(anchor_font_handle(tcn, theme_)),
     position_(),
     parent_(),
     my_subscriber_id(),
@@ -91,6 +108,7 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
     click_callback(click_callback_),
     tcn(theme_control_name_),
     theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)), anchor_font(anchor_font_handle(tcn, theme_)),
     position_(),
     parent_(),
     showed_(true), enabled_(true), topmost_(false), active(false), focused_(false),
@@ -113,6 +131,7 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
     click_callback(click_callback_),
     tcn(theme_control_name_),
     theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)), anchor_font(anchor_font_handle(tcn, theme_)),
     position_(),
     parent_(),
     showed_(true), enabled_(true), topmost_(false), active(false), focused_(false),
@@ -134,6 +153,7 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
     click_callback(click_callback_),
     tcn(theme_control_name_),
     theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)), anchor_font(anchor_font_handle(tcn, theme_)),
     position_(),
     parent_(),
     my_subscriber_id(),
@@ -163,7 +183,7 @@ void button::draw(graphic &gr, const rect &)
         return;
     }
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = text_font;
 
     if (button_view_ != button_view::image && !caption.empty() && text_rect.width() == 0)
     {
@@ -311,7 +331,7 @@ void button::draw(graphic &gr, const rect &)
         if (button_view_ == button_view::anchor)
         {
             color_ = theme_color(tcn, tv_anchor, theme_);
-            font_.decorations_ = decorations::underline;
+            font_ = anchor_font;
         }
 
         if (!enabled_ && (button_view_ == button_view::anchor || button_view_ == button_view::sheet))
@@ -498,6 +518,11 @@ void button::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view button::theme_control_name() const
+{
+    return tcn;
+}
+
 void button::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -506,16 +531,19 @@ void button::update_theme(std::shared_ptr<i_theme> theme__)
     }
     theme_ = theme__;
 
+    text_font = theme_font_handle(tcn, tv_font, theme_);
+    anchor_font = anchor_font_handle(tcn, theme_);
+
     tooltip_->update_theme(theme_);
 
     if (button_view_ == button_view::switcher)
     {
-        image_->change_image(theme_image(turned_ ? ti_switcher_on : ti_switcher_off));
+        image_->change_theme_image(turned_ ? ti_switcher_on : ti_switcher_off, theme_);
         update_err("button::update_theme[switcher]", image_->get_error());
     }
     if (button_view_ == button_view::radio)
     {
-        image_->change_image(theme_image(turned_ ? ti_radio_on : ti_radio_off));
+        image_->change_theme_image(turned_ ? ti_radio_on : ti_radio_off, theme_);
         update_err("button::update_theme[radio]", image_->get_error());
     }
     else if (image_)
@@ -631,6 +659,18 @@ void button::set_image(const std::vector<uint8_t> &image_data)
     redraw();
 }
 
+void button::set_theme_image(std::string_view name, std::shared_ptr<i_theme> theme__)
+{
+    if (!image_)
+    {
+        image_ = std::make_shared<image>(std::vector<uint8_t>());
+    }
+    image_->change_theme_image(name, theme__);
+
+    update_err("button::set_theme_image", image_->get_error());
+    redraw();
+}
+
 void button::enable_focusing()
 {
     focusing_ = true;
@@ -647,11 +687,11 @@ void button::turn(bool on)
     switch (button_view_)
     {
         case button_view::switcher:
-            image_->change_image(theme_image(turned_ ? ti_switcher_on : ti_switcher_off));
+            image_->change_theme_image(turned_ ? ti_switcher_on : ti_switcher_off, theme_);
             update_err("button::turn", image_->get_error());
         break;
         case button_view::radio:
-            image_->change_image(theme_image(turned_ ? ti_radio_on : ti_radio_off));
+            image_->change_theme_image(turned_ ? ti_radio_on : ti_radio_off, theme_);
             update_err("button::turn", image_->get_error());
         break;
         default:
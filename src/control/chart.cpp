@@ -0,0 +1,667 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/control/chart.hpp>
+
+#include <wui/window/window.hpp>
+
+#include <wui/theme/theme.hpp>
+
+#include <wui/graphic/decimation.hpp>
+
+#include <wui/system/tools.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace wui
+{
+
+chart::chart(std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
+    : tcn(theme_control_name_),
+    theme_(theme__),
+    position_(),
+    parent_(),
+    my_plain_sid(),
+    async_parent_mutex(),
+    async_parent(),
+    showed_(true),
+    series_mutex(),
+    series_(),
+    samples_per_pixel_(1),
+    min_value(-1.0f), max_value(1.0f),
+    divisions(4),
+    clear_epoch(0),
+    repaint_requested(false),
+    front(), back(),
+    buffer_width(0), buffer_height(0),
+    buffer_valid(false),
+    rendered_last(-1),
+    rendered_epoch(0),
+    lines(),
+    paths()
+{
+}
+
+chart::~chart()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(shared_from_this());
+    }
+}
+
+void chart::draw(graphic &gr, const rect &)
+{
+    if (!showed_ || position_.is_null())
+    {
+        return;
+    }
+
+    repaint_requested = false;
+
+    auto control_pos = position();
+
+    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+
+    system_context ctx = { 0 };
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+#ifdef _WIN32
+        ctx = parent__->context();
+#elif __linux__
+        ctx = { parent__->context().display, parent__->context().connection, parent__->context().screen, gr.drawable() };
+#endif
+    }
+
+    if (update_buffers(ctx, position_.width() - border_width * 2, position_.height() - border_width * 2))
+    {
+        render();
+
+        gr.draw_graphic({ control_pos.left + border_width,
+                control_pos.top + border_width,
+                buffer_width,
+                buffer_height },
+            *front, 0, 0);
+    }
+
+    gr.draw_rect(control_pos,
+        theme_color(tcn, tv_border, theme_),
+        make_color(0, 0, 0, 255),
+        border_width,
+        theme_dimension(tcn, tv_round, theme_));
+}
+
+bool chart::update_buffers(system_context &ctx, int32_t width, int32_t height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    if (!front || buffer_width != width || buffer_height != height)
+    {
+        auto background = theme_color(tcn, tv_background, theme_);
+
+        front.reset(new graphic(ctx));
+        back.reset(new graphic(ctx));
+        if (!front->init_image({ 0, 0, width, height }, background) || !back->init_image({ 0, 0, width, height }, background))
+        {
+            front.reset();
+            back.reset();
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(series_mutex);
+
+        buffer_width = width;
+        buffer_height = height;
+        buffer_valid = false;
+    }
+
+    return true;
+}
+
+void chart::render()
+{
+    auto background = theme_color(tcn, tv_background, theme_);
+    auto line_color = theme_color(tcn, tv_line, theme_);
+
+    int64_t first = 0, last = 0, shift = 0;
+    int32_t divisions_ = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(series_mutex);
+
+        auto total = chart_total();
+
+        last = total != 0 ? static_cast<int64_t>((total - 1) / samples_per_pixel_) : -1;
+        auto first_visible = last - buffer_width + 1;
+
+        if (buffer_valid && rendered_epoch == clear_epoch && last >= rendered_last && last - rendered_last < buffer_width)
+        {
+            /// The columns having the new samples of any series and the columns moved in from the right
+            shift = last - rendered_last;
+            first = rendered_last + 1;
+            for (auto &s : series_)
+            {
+                if (s.total != s.drawn)
+                {
+                    first = (std::min)(first, static_cast<int64_t>(s.drawn / samples_per_pixel_));
+                }
+            }
+            first = (std::max)(first, first_visible);
+        }
+        else
+        {
+            shift = 0;
+            first = first_visible;
+            buffer_valid = false;
+        }
+
+        paths.resize(series_.size());
+        for (size_t i = 0; i != series_.size(); ++i)
+        {
+            paths[i].color_ = series_[i].color_;
+            paths[i].points.clear();
+
+            if (first <= last)
+            {
+                make_path(series_[i], first, last, paths[i].points);
+            }
+
+            series_[i].drawn = series_[i].total;
+        }
+
+        divisions_ = divisions;
+
+        rendered_last = last;
+        rendered_epoch = clear_epoch;
+    }
+
+    if (buffer_valid && shift != 0)
+    {
+        back->draw_graphic({ 0, 0, buffer_width - static_cast<int32_t>(shift), buffer_height }, *front, static_cast<int32_t>(shift), 0);
+        std::swap(front, back);
+    }
+    buffer_valid = true;
+
+    if (first > last)
+    {
+        return;
+    }
+
+    auto left = buffer_width - 1 - static_cast<int32_t>(last - first);
+
+    front->draw_rect({ left, 0, buffer_width, buffer_height }, background);
+
+    lines.clear();
+    for (int32_t n = 1; n < divisions_; ++n)
+    {
+        auto y = buffer_height * n / divisions_;
+        lines.push_back({ left, y, buffer_width - 1, y });
+    }
+    front->draw_lines(lines.data(), lines.size(), line_color);
+
+    for (auto &p : paths)
+    {
+        front->draw_polyline(p.points.data(), p.points.size(), p.color_);
+    }
+}
+
+void chart::make_path(const series &s, int64_t first, int64_t last, std::vector<point> &points_) const
+{
+    /// The previous column is connected to the redrawn ones
+    auto start = (std::max)(first - 1, last - buffer_width + 1);
+
+    for (auto column = start; column <= last; ++column)
+    {
+        float mn = 0.0f, mx = 0.0f;
+        if (!column_min_max(s, column, mn, mx))
+        {
+            continue; /// the samples are not appended yet or already dropped
+        }
+
+        int32_t x = buffer_width - 1 - static_cast<int32_t>(last - column);
+        auto top = value_y(mx), bottom = value_y(mn);
+
+        if (top == bottom)
+        {
+            points_.push_back({ x, top });
+        }
+        else if (!points_.empty() && points_.back().y > (top + bottom) / 2)
+        {
+            /// The column is passed from the nearest end, so the connecting segments are short
+            points_.push_back({ x, bottom });
+            points_.push_back({ x, top });
+        }
+        else
+        {
+            points_.push_back({ x, top });
+            points_.push_back({ x, bottom });
+        }
+    }
+
+    if (points_.size() == 1)
+    {
+        points_.push_back(points_.front());
+    }
+}
+
+bool chart::column_min_max(const series &s, int64_t column, float &min_, float &max_) const
+{
+    auto size = s.ring.size();
+    if (column < 0 || size == 0)
+    {
+        return false;
+    }
+
+    auto oldest = s.total > size ? s.total - size : 0;
+
+    auto from = (std::max)(static_cast<uint64_t>(column) * samples_per_pixel_, oldest);
+    auto to = (std::min)(static_cast<uint64_t>(column + 1) * samples_per_pixel_, s.total);
+    if (from >= to)
+    {
+        return false;
+    }
+
+    /// The samples are at most in two parts of the ring
+    auto pos = static_cast<size_t>(from % size);
+    auto count = static_cast<size_t>(to - from);
+    auto head = (std::min)(count, size - pos);
+
+    min_max(s.ring.data() + pos, head, min_, max_);
+
+    if (head != count)
+    {
+        float mn = 0.0f, mx = 0.0f;
+        min_max(s.ring.data(), count - head, mn, mx);
+
+        min_ = (std::min)(min_, mn);
+        max_ = (std::max)(max_, mx);
+    }
+
+    return true;
+}
+
+int32_t chart::value_y(float value) const
+{
+    if (max_value <= min_value || std::isnan(value))
+    {
+        return buffer_height / 2;
+    }
+
+    auto y = (buffer_height - 1) - (static_cast<double>(value) - min_value) * (buffer_height - 1) / (static_cast<double>(max_value) - min_value);
+
+    /// The values out of the range are drawn at the edge
+    y = (std::max)((std::min)(y, static_cast<double>(buffer_height)), -1.0);
+
+    return static_cast<int32_t>(std::lround(y));
+}
+
+uint64_t chart::chart_total() const
+{
+    uint64_t total = 0;
+    for (auto &s : series_)
+    {
+        total = (std::max)(total, s.total);
+    }
+    return total;
+}
+
+void chart::update_capacity()
+{
+    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+
+    auto width = position_.width() - border_width * 2;
+    if (width <= 0)
+    {
+        return;
+    }
+
+    /// The visible columns and the column moved out on the next blit
+    auto size = static_cast<size_t>(width + 2) * samples_per_pixel_;
+
+    for (auto &s : series_)
+    {
+        if (s.ring.size() == size)
+        {
+            continue;
+        }
+
+        std::vector<float> ring(size);
+
+        auto kept = (std::min)({ s.total, static_cast<uint64_t>(s.ring.size()), static_cast<uint64_t>(size) });
+        for (auto n = s.total - kept; n != s.total; ++n)
+        {
+            ring[n % size] = s.ring[n % s.ring.size()];
+        }
+
+        s.ring.swap(ring);
+    }
+}
+
+void chart::set_position(const rect &position__, bool redraw)
+{
+    update_control_position(position_, position__, showed_ && redraw, parent_);
+
+    std::lock_guard<std::mutex> lock(series_mutex);
+    update_capacity();
+}
+
+rect chart::position() const
+{
+    return get_control_position(position_, parent_);
+}
+
+void chart::set_parent(std::shared_ptr<window> window)
+{
+    parent_ = window;
+
+    my_plain_sid = window->subscribe(std::bind(&chart::receive_plain_events, this, std::placeholders::_1), event_type::internal);
+
+    std::lock_guard<std::mutex> lock(async_parent_mutex);
+    async_parent = window;
+}
+
+std::weak_ptr<window> chart::parent() const
+{
+    return parent_;
+}
+
+void chart::clear_parent()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->unsubscribe(my_plain_sid);
+        my_plain_sid.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(async_parent_mutex);
+        async_parent.reset();
+    }
+
+    parent_.reset();
+}
+
+void chart::set_topmost(bool)
+{
+}
+
+bool chart::topmost() const
+{
+    return false;
+}
+
+void chart::update_theme_control_name(std::string_view theme_control_name)
+{
+    tcn = theme_control_name;
+    update_theme(theme_);
+}
+
+std::string_view chart::theme_control_name() const
+{
+    return tcn;
+}
+
+void chart::update_theme(std::shared_ptr<i_theme> theme__)
+{
+    if (theme_ && !theme__)
+    {
+        return;
+    }
+    theme_ = theme__;
+
+    buffer_valid = false;
+
+    {
+        std::lock_guard<std::mutex> lock(series_mutex);
+        update_capacity();
+    }
+
+    redraw();
+}
+
+void chart::show()
+{
+    if (!showed_)
+    {
+        showed_ = true;
+        buffer_valid = false;
+
+        redraw();
+    }
+}
+
+void chart::hide()
+{
+    if (showed_)
+    {
+        showed_ = false;
+
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position(), true);
+        }
+    }
+}
+
+bool chart::showed() const
+{
+    return showed_;
+}
+
+void chart::enable()
+{
+}
+
+void chart::disable()
+{
+}
+
+bool chart::enabled() const
+{
+    return true;
+}
+
+bool chart::focused() const
+{
+    return false;
+}
+
+bool chart::focusing() const
+{
+    return false;
+}
+
+error chart::get_error() const
+{
+    return front ? front->get_error() : error{};
+}
+
+int32_t chart::add_series(color color_)
+{
+    std::lock_guard<std::mutex> lock(series_mutex);
+
+    series_.push_back(series{ color_, {}, 0, 0 });
+    update_capacity();
+
+    return static_cast<int32_t>(series_.size()) - 1;
+}
+
+int32_t chart::series_count() const
+{
+    std::lock_guard<std::mutex> lock(series_mutex);
+    return static_cast<int32_t>(series_.size());
+}
+
+void chart::set_series_color(int32_t n, color color_)
+{
+    {
+        std::lock_guard<std::mutex> lock(series_mutex);
+        if (n < 0 || n >= static_cast<int32_t>(series_.size()))
+        {
+            return;
+        }
+        series_[n].color_ = color_;
+    }
+
+    buffer_valid = false;
+    redraw();
+}
+
+void chart::append(int32_t n, const float *values, size_t count)
+{
+    if (!values || count == 0)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(series_mutex);
+        if (n < 0 || n >= static_cast<int32_t>(series_.size()))
+        {
+            return;
+        }
+
+        auto &s = series_[n];
+        auto size = s.ring.size();
+
+        if (size != 0)
+        {
+            /// The samples not fitting the ring are skipped
+            if (count > size)
+            {
+                s.total += count - size;
+                values += count - size;
+                count = size;
+            }
+
+            auto pos = static_cast<size_t>(s.total % size);
+            auto head = (std::min)(count, size - pos);
+
+            memcpy(s.ring.data() + pos, values, head * sizeof(float));
+            memcpy(s.ring.data(), values + head, (count - head) * sizeof(float));
+        }
+
+        s.total += count;
+    }
+
+    /// The appends made before the paint are drawn together. The repaint is posted, because the control's position
+    /// and parent are used by the UI thread only
+    if (!repaint_requested.exchange(true))
+    {
+        post_redraw();
+    }
+}
+
+void chart::clear()
+{
+    {
+        std::lock_guard<std::mutex> lock(series_mutex);
+
+        for (auto &s : series_)
+        {
+            s.total = 0;
+            s.drawn = 0;
+        }
+        ++clear_epoch;
+    }
+
+    if (!repaint_requested.exchange(true))
+    {
+        post_redraw();
+    }
+}
+
+void chart::set_samples_per_pixel(int32_t count)
+{
+    {
+        std::lock_guard<std::mutex> lock(series_mutex);
+
+        samples_per_pixel_ = (std::max)(count, 1);
+        update_capacity();
+    }
+
+    buffer_valid = false;
+    redraw();
+}
+
+int32_t chart::samples_per_pixel() const
+{
+    std::lock_guard<std::mutex> lock(series_mutex);
+    return samples_per_pixel_;
+}
+
+void chart::set_range(float min_value_, float max_value_)
+{
+    {
+        std::lock_guard<std::mutex> lock(series_mutex);
+
+        min_value = min_value_;
+        max_value = max_value_;
+    }
+
+    buffer_valid = false;
+    redraw();
+}
+
+void chart::set_divisions(int32_t count)
+{
+    {
+        std::lock_guard<std::mutex> lock(series_mutex);
+        divisions = (std::max)(count, 1);
+    }
+
+    buffer_valid = false;
+    redraw();
+}
+
+void chart::post_redraw()
+{
+    std::shared_ptr<window> parent__;
+    {
+        std::lock_guard<std::mutex> lock(async_parent_mutex);
+        parent__ = async_parent.lock();
+    }
+
+    if (parent__)
+    {
+        parent__->emit_event(repaint_event_id, 0);
+    }
+}
+
+void chart::receive_plain_events(const event &ev)
+{
+    if (ev.type == event_type::internal && ev.internal_event_.type == internal_event_type::user_emitted && ev.internal_event_.x == repaint_event_id &&
+        repaint_requested)
+    {
+        redraw();
+    }
+}
+
+void chart::redraw()
+{
+    if (showed_)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position());
+        }
+    }
+}
+
+}
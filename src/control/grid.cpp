@@ -0,0 +1,1049 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/control/grid.hpp>
+
+#include <wui/window/window.hpp>
+
+#include <wui/theme/theme.hpp>
+
+#include <wui/system/tools.hpp>
+
+#include <wui/common/flag_helpers.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace wui
+{
+
+static const int32_t text_indent = 5;
+static const int32_t scrollbar_size = 14;
+static const size_t text_cache_size = 8192;
+
+/// The height of millions of rows does not fit int32_t, it is computed in int64_t and clamped for the scroll
+static int32_t clamp_pixels(int64_t value)
+{
+    return static_cast<int32_t>((std::min)(value, static_cast<int64_t>((std::numeric_limits<int32_t>::max)())));
+}
+
+grid::grid(std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
+    : tcn(theme_control_name_),
+    theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)),
+    position_(),
+    parent_(),
+    my_control_sid(),
+    showed_(true), enabled_(true), focused_(false), mouse_on_control(false),
+    source_(),
+    rows_count(0), columns_count(0),
+    default_column_width(100),
+    widths(),
+    lefts(1, 0),
+    alignments(),
+    row_height_(28),
+    frozen_columns_(0),
+    selected_row_(-1),
+    text_cache("grid texts", text_cache_size, nullptr),
+    text_buffer(),
+    boundaries(),
+    content(),
+    content_width(0), content_height(0),
+    text_height(0),
+    lines(),
+    vert_scroll(std::make_shared<scroll>(0, 0, orientation::vertical, std::bind(&grid::on_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__)),
+    hori_scroll(std::make_shared<scroll>(0, 0, orientation::horizontal, std::bind(&grid::on_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__)),
+    mouse_scroll(),
+    row_change_callback(), row_activate_callback(),
+    cell_click_callback()
+{
+}
+
+grid::~grid()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(shared_from_this());
+    }
+}
+
+void grid::draw(graphic &gr, const rect &)
+{
+    if (!showed_ || position_.is_null())
+    {
+        return;
+    }
+
+    auto control_pos = position();
+
+    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+
+    system_context ctx = { 0 };
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+#ifdef _WIN32
+        ctx = parent__->context();
+#elif __linux__
+        ctx = { parent__->context().display, parent__->context().connection, parent__->context().screen, gr.drawable() };
+#endif
+    }
+
+    if (!update_content(ctx, view_width(), view_height()))
+    {
+        return;
+    }
+
+    auto &gr_ = *content;
+
+    auto w = content_width, h = content_height;
+    auto header_height = row_height_;
+
+    auto background = theme_color(tcn, tv_background, theme_);
+    auto header_color = theme_color(tcn, tv_header, theme_);
+    auto selected_color = theme_color(tcn, tv_selected_item, theme_);
+    auto line_color = theme_color(tcn, tv_line, theme_);
+    auto text_color = theme_color(tcn, tv_text, theme_);
+    auto header_text_color = theme_color(tcn, tv_header_text, theme_);
+    auto font = text_font;
+
+    gr_.draw_rect({ 0, 0, w, h }, background);
+
+    if (source_)
+    {
+        auto frozen = (std::min)(frozen_columns_, columns_count);
+        auto frozen_w = frozen_width();
+
+        /// The visible scrolled columns are found by the lefts, the rows by the fixed height
+        int32_t first_column = frozen, last_column = frozen;
+        if (columns_count > frozen)
+        {
+            auto x = lefts[frozen] + hori_scroll->get_scroll_pos();
+            first_column = static_cast<int32_t>(std::upper_bound(lefts.begin() + frozen, lefts.begin() + columns_count + 1, x) - lefts.begin()) - 1;
+            first_column = (std::max)(first_column, frozen);
+
+            last_column = first_column;
+            while (last_column < columns_count && column_left(last_column) < w)
+            {
+                ++last_column;
+            }
+        }
+
+        auto scroll_pos = vert_scroll->get_scroll_pos();
+        auto first_row = (std::min)(scroll_pos / row_height_, rows_count);
+        auto last_row = static_cast<int32_t>((std::min)((static_cast<int64_t>(scroll_pos) + h - header_height + row_height_ - 1) / row_height_, static_cast<int64_t>(rows_count)));
+
+        /// The rows are placed from the first one, row * row_height_ of the far rows overflows int32_t
+        auto first_top = header_height - (scroll_pos - first_row * row_height_);
+
+        for (auto row = first_row; row < last_row; ++row)
+        {
+            auto top = first_top + (row - first_row) * row_height_;
+            if (row == selected_row_)
+            {
+                gr_.draw_rect({ 0, top, w, top + row_height_ }, selected_color);
+            }
+            draw_cells(gr_, row, first_column, last_column, top, text_color, font);
+        }
+
+        /// The frozen columns cover the scrolled ones
+        if (frozen != 0)
+        {
+            gr_.draw_rect({ 0, header_height, frozen_w, h }, background);
+
+            for (auto row = first_row; row < last_row; ++row)
+            {
+                auto top = first_top + (row - first_row) * row_height_;
+                if (row == selected_row_)
+                {
+                    gr_.draw_rect({ 0, top, frozen_w, top + row_height_ }, selected_color);
+                }
+                draw_cells(gr_, row, 0, frozen, top, text_color, font);
+            }
+        }
+
+        gr_.draw_rect({ 0, 0, w, header_height }, header_color);
+        draw_cells(gr_, -1, first_column, last_column, 0, header_text_color, font);
+        if (frozen != 0)
+        {
+            gr_.draw_rect({ 0, 0, frozen_w, header_height }, header_color);
+            draw_cells(gr_, -1, 0, frozen, 0, header_text_color, font);
+        }
+
+        /// All the lines are drawn by one call
+        lines.clear();
+        for (auto column = first_column; column < last_column; ++column)
+        {
+            auto x = column_left(column) + widths[column] - 1;
+            if (x >= frozen_w)
+            {
+                lines.push_back({ x, 0, x, h });
+            }
+        }
+        for (auto column = 0; column < frozen; ++column)
+        {
+            auto x = lefts[column] + widths[column] - 1;
+            lines.push_back({ x, 0, x, h });
+        }
+        for (auto row = first_row; row < last_row; ++row)
+        {
+            auto y = first_top + (row - first_row + 1) * row_height_ - 1;
+            lines.push_back({ 0, y, w, y });
+        }
+        lines.push_back({ 0, header_height - 1, w, header_height - 1 });
+
+        gr_.draw_lines(lines.data(), lines.size(), line_color);
+    }
+
+    gr.draw_graphic({ control_pos.left + border_width,
+            control_pos.top + border_width,
+            w,
+            h },
+        gr_, 0, 0);
+
+    if (mouse_on_control || focused_)
+    {
+        if (vert_scroll->showed())
+        {
+            vert_scroll->draw(gr, {});
+        }
+        if (hori_scroll->showed())
+        {
+            hori_scroll->draw(gr, {});
+        }
+    }
+
+    gr.draw_rect(control_pos,
+        !focused_ ? theme_color(tcn, tv_border, theme_) : theme_color(tcn, tv_focused_border, theme_),
+        make_color(0, 0, 0, 255),
+        border_width,
+        theme_dimension(tcn, tv_round, theme_));
+}
+
+bool grid::update_content(system_context &ctx, int32_t width, int32_t height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    if (!content || content_width != width || content_height != height)
+    {
+        content.reset(new graphic(ctx));
+        if (!content->init_image({ 0, 0, width, height }, theme_color(tcn, tv_background, theme_)))
+        {
+            content.reset();
+            return false;
+        }
+
+        content_width = width;
+        content_height = height;
+    }
+
+    if (text_height == 0)
+    {
+        text_height = content->measure_text("Qq", text_font).height();
+    }
+
+    return true;
+}
+
+void grid::draw_cells(graphic &gr_, int32_t row, int32_t first_column, int32_t last_column, int32_t top, color text_color, font_handle font_)
+{
+    for (auto column = first_column; column < last_column; ++column)
+    {
+        auto left = column_left(column);
+        draw_cell_text(gr_, row, column, { left, top, left + widths[column], top + row_height_ }, text_color, font_);
+    }
+}
+
+void grid::draw_cell_text(graphic &gr_, int32_t row, int32_t column, const rect &cell_rect, color text_color, font_handle font_)
+{
+    text_buffer.clear();
+    if (row == -1)
+    {
+        source_->header(column, text_buffer);
+    }
+    else
+    {
+        source_->cell(row, column, text_buffer);
+    }
+
+    if (text_buffer.empty())
+    {
+        return;
+    }
+
+    auto available = cell_rect.width() - text_indent * 2;
+
+    auto key = std::make_pair(row, column);
+    auto ct = text_cache.find(key);
+    if (!ct)
+    {
+        ct = &text_cache.insert(key, cell_text{ "", "", -1, 0 });
+    }
+
+    if (ct->available != available || ct->text != text_buffer)
+    {
+        ct->text = text_buffer;
+        ct->available = available;
+        fit_text(gr_, *ct, font_);
+    }
+
+    if (ct->shown.empty())
+    {
+        return;
+    }
+
+    auto left = cell_rect.left + text_indent;
+    switch (alignments[column])
+    {
+        case hori_alignment::center:
+            left = cell_rect.left + (cell_rect.width() - ct->width) / 2;
+        break;
+        case hori_alignment::right:
+            left = cell_rect.right - text_indent - ct->width;
+        break;
+        default: break;
+    }
+
+    gr_.draw_text({ left, cell_rect.top + (cell_rect.height() - text_height) / 2, 0, 0 }, ct->shown, text_color, font_);
+}
+
+void grid::fit_text(graphic &gr_, cell_text &ct, font_handle font_)
+{
+    ct.width = gr_.measure_text(ct.text, font_).width();
+    if (ct.width <= ct.available)
+    {
+        ct.shown = ct.text;
+        return;
+    }
+
+    /// The longest prefix fitting with the ellipsis, cut by the utf-8 characters
+    boundaries.clear();
+    for (size_t i = 0; i <= ct.text.size(); ++i)
+    {
+        if (i == ct.text.size() || (ct.text[i] & 0xC0) != 0x80)
+        {
+            boundaries.emplace_back(i);
+        }
+    }
+
+    size_t low = 0, high = boundaries.size() - 1;
+    while (high - low > 1)
+    {
+        auto middle = (low + high) / 2;
+
+        ct.shown.assign(ct.text, 0, boundaries[middle]);
+        ct.shown += "...";
+
+        if (gr_.measure_text(ct.shown, font_).width() <= ct.available)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    ct.shown.assign(ct.text, 0, boundaries[low]);
+    ct.shown += "...";
+    ct.width = gr_.measure_text(ct.shown, font_).width();
+
+    if (ct.width > ct.available)
+    {
+        ct.shown.clear();
+        ct.width = 0;
+    }
+}
+
+bool grid::route_to_scroll(const event &ev)
+{
+    std::shared_ptr<scroll> scroll_;
+    if (vert_scroll->showed() && vert_scroll->position().in(ev.mouse_event_.x, ev.mouse_event_.y))
+    {
+        scroll_ = vert_scroll;
+    }
+    else if (hori_scroll->showed() && hori_scroll->position().in(ev.mouse_event_.x, ev.mouse_event_.y))
+    {
+        scroll_ = hori_scroll;
+    }
+
+    if (scroll_ != mouse_scroll)
+    {
+        if (mouse_scroll)
+        {
+            event sev = ev;
+            sev.mouse_event_.type = wui::mouse_event_type::leave;
+
+            mouse_scroll->receive_control_events(sev);
+        }
+
+        mouse_scroll = scroll_;
+
+        if (mouse_scroll)
+        {
+            event sev = ev;
+            sev.mouse_event_.type = wui::mouse_event_type::enter;
+
+            mouse_scroll->receive_control_events(sev);
+
+            return true;
+        }
+    }
+
+    if (mouse_scroll)
+    {
+        mouse_scroll->receive_control_events(ev);
+        return true;
+    }
+
+    return false;
+}
+
+void grid::receive_control_events(const event &ev)
+{
+    if (!showed_ || !enabled_)
+    {
+        return;
+    }
+
+    if (ev.type == event_type::mouse)
+    {
+        if (ev.mouse_event_.type != mouse_event_type::leave && route_to_scroll(ev))
+        {
+            return;
+        }
+
+        auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+        auto control_pos = position();
+        auto x = ev.mouse_event_.x - control_pos.left - border_width, y = ev.mouse_event_.y - control_pos.top - border_width;
+
+        switch (ev.mouse_event_.type)
+        {
+            case mouse_event_type::enter:
+                mouse_on_control = true;
+                update_scroll_areas();
+                redraw();
+            break;
+            case mouse_event_type::leave:
+                if (mouse_scroll)
+                {
+                    event sev = ev;
+                    mouse_scroll->receive_control_events(sev);
+                    mouse_scroll.reset();
+                }
+                mouse_on_control = false;
+                redraw();
+            break;
+            case mouse_event_type::left_down:
+            {
+                auto row = find_row(y), column = find_column(x);
+                if (row != -1)
+                {
+                    change_selected_row(row);
+                }
+                if (cell_click_callback && column != -1 && (row != -1 || y < row_height_))
+                {
+                    cell_click_callback(row, column);
+                }
+            }
+            break;
+            case mouse_event_type::left_double:
+            {
+                auto row = find_row(y);
+                if (row != -1 && row_activate_callback)
+                {
+                    row_activate_callback(row);
+                }
+            }
+            break;
+            case mouse_event_type::wheel:
+                if (ev.mouse_event_.wheel_delta > 0)
+                {
+                    vert_scroll->scroll_up();
+                }
+                else
+                {
+                    vert_scroll->scroll_down();
+                }
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::keyboard)
+    {
+        if (ev.keyboard_event_.type != keyboard_event_type::down || rows_count == 0)
+        {
+            return;
+        }
+
+        auto page = (std::max)((view_height() - row_height_) / row_height_, 1);
+
+        switch (ev.keyboard_event_.key[0])
+        {
+            case vk_home: case vk_nhome:
+                change_selected_row(0);
+            break;
+            case vk_end: case vk_nend:
+                change_selected_row(rows_count - 1);
+            break;
+            case vk_up: case vk_nup:
+                change_selected_row((std::max)(selected_row_ - 1, 0));
+            break;
+            case vk_down: case vk_ndown:
+                change_selected_row((std::min)(selected_row_ + 1, rows_count - 1));
+            break;
+            case vk_page_up: case vk_npage_up:
+                change_selected_row((std::max)(selected_row_ - page, 0));
+            break;
+            case vk_page_down: case vk_npage_down:
+                change_selected_row((std::min)(selected_row_ + page, rows_count - 1));
+            break;
+            case vk_left: case vk_right:
+            {
+                /// Scroll by the column
+                auto frozen = (std::min)(frozen_columns_, columns_count);
+                if (columns_count == frozen)
+                {
+                    break;
+                }
+
+                auto pos = hori_scroll->get_scroll_pos();
+                auto column = static_cast<int32_t>(std::upper_bound(lefts.begin() + frozen, lefts.begin() + columns_count + 1, lefts[frozen] + pos) - lefts.begin()) - 1;
+                column = (std::max)(column, frozen);
+
+                if (ev.keyboard_event_.key[0] == vk_left)
+                {
+                    if (lefts[column] - lefts[frozen] == pos && column > frozen)
+                    {
+                        --column;
+                    }
+                }
+                else if (column < columns_count)
+                {
+                    ++column;
+                }
+
+                hori_scroll->set_scroll_pos(lefts[column] - lefts[frozen]);
+            }
+            break;
+        }
+    }
+    else if (ev.type == event_type::internal)
+    {
+        switch (ev.internal_event_.type)
+        {
+            case internal_event_type::set_focus:
+                focused_ = true;
+                update_scroll_areas();
+                redraw();
+            break;
+            case internal_event_type::remove_focus:
+                focused_ = false;
+                redraw();
+            break;
+            case internal_event_type::execute_focused:
+                if (selected_row_ != -1 && row_activate_callback)
+                {
+                    row_activate_callback(selected_row_);
+                }
+            break;
+            default: break;
+        }
+    }
+}
+
+void grid::set_position(const rect &position__, bool redraw)
+{
+    update_control_position(position_, position__, showed_ && redraw, parent_);
+
+    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+
+    vert_scroll->set_position({ position_.right - scrollbar_size - border_width,
+        position_.top + border_width,
+        position_.right - border_width,
+        position_.bottom - border_width - scrollbar_size });
+
+    hori_scroll->set_position({ position_.left + border_width,
+        position_.bottom - scrollbar_size - border_width,
+        position_.right - border_width - scrollbar_size,
+        position_.bottom - border_width });
+
+    update_scroll_areas();
+}
+
+rect grid::position() const
+{
+    return get_control_position(position_, parent_);
+}
+
+void grid::set_parent(std::shared_ptr<window> window)
+{
+    parent_ = window;
+
+    my_control_sid = window->subscribe(std::bind(&grid::receive_control_events, this, std::placeholders::_1),
+        wui::flags_map<wui::event_type>(3, wui::event_type::internal, wui::event_type::mouse, wui::event_type::keyboard),
+        shared_from_this());
+
+    window->add_control(vert_scroll, { 0 });
+    window->add_control(hori_scroll, { 0 });
+}
+
+std::weak_ptr<window> grid::parent() const
+{
+    return parent_;
+}
+
+void grid::clear_parent()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(vert_scroll);
+        parent__->remove_control(hori_scroll);
+
+        parent__->unsubscribe(my_control_sid);
+        my_control_sid.clear();
+    }
+
+    parent_.reset();
+}
+
+void grid::set_topmost(bool)
+{
+}
+
+bool grid::topmost() const
+{
+    return false;
+}
+
+bool grid::focused() const
+{
+    return enabled_ && showed_ && focused_;
+}
+
+bool grid::focusing() const
+{
+    return enabled_ && showed_;
+}
+
+error grid::get_error() const
+{
+    return content ? content->get_error() : error{};
+}
+
+void grid::update_theme_control_name(std::string_view theme_control_name)
+{
+    tcn = theme_control_name;
+    update_theme(theme_);
+}
+
+std::string_view grid::theme_control_name() const
+{
+    return tcn;
+}
+
+void grid::update_theme(std::shared_ptr<i_theme> theme__)
+{
+    if (theme_ && !theme__)
+    {
+        return;
+    }
+    theme_ = theme__;
+
+    text_font = theme_font_handle(tcn, tv_font, theme_);
+
+    /// The font can be changed
+    text_cache.clear();
+    text_height = 0;
+
+    redraw();
+}
+
+void grid::show()
+{
+    if (!showed_)
+    {
+        showed_ = true;
+        update_scroll_areas();
+        redraw();
+    }
+}
+
+void grid::hide()
+{
+    if (showed_)
+    {
+        showed_ = false;
+
+        vert_scroll->hide();
+        hori_scroll->hide();
+
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position(), true);
+        }
+    }
+}
+
+bool grid::showed() const
+{
+    return showed_;
+}
+
+void grid::enable()
+{
+    enabled_ = true;
+    redraw();
+}
+
+void grid::disable()
+{
+    enabled_ = false;
+    redraw();
+}
+
+bool grid::enabled() const
+{
+    return enabled_;
+}
+
+void grid::set_source(std::shared_ptr<i_grid_source> source__)
+{
+    source_ = source__;
+
+    text_cache.clear();
+    selected_row_ = -1;
+    vert_scroll->set_scroll_pos(0);
+    hori_scroll->set_scroll_pos(0);
+
+    update();
+}
+
+std::shared_ptr<i_grid_source> grid::source() const
+{
+    return source_;
+}
+
+void grid::update()
+{
+    rows_count = source_ ? source_->rows_count() : 0;
+    if (selected_row_ >= rows_count)
+    {
+        selected_row_ = -1;
+    }
+
+    update_columns();
+    update_scroll_areas();
+
+    redraw();
+}
+
+void grid::update_cell(int32_t row, int32_t column)
+{
+    if (!showed_ || column < 0 || column >= columns_count || row < -1 || row >= rows_count)
+    {
+        return;
+    }
+
+    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+    auto control_pos = position();
+
+    auto left = column_left(column);
+    /// The far row's top is clamped to just outside the view, the cell is not drawn then
+    auto row_top = static_cast<int64_t>(row + 1) * row_height_ - vert_scroll->get_scroll_pos();
+    auto top = row == -1 ? 0 : static_cast<int32_t>((std::max)((std::min)(row_top, static_cast<int64_t>(view_height())), static_cast<int64_t>(-row_height_)));
+
+    rect cell_rect = { (std::max)(left, 0), (std::max)(top, 0), (std::min)(left + widths[column], view_width()), (std::min)(top + row_height_, view_height()) };
+    if (cell_rect.right <= cell_rect.left || cell_rect.bottom <= cell_rect.top)
+    {
+        return;
+    }
+
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        cell_rect.move(control_pos.left + border_width, control_pos.top + border_width);
+        parent__->redraw(cell_rect);
+    }
+}
+
+void grid::set_default_column_width(int32_t width)
+{
+    default_column_width = width;
+}
+
+void grid::set_column_width(int32_t column, int32_t width)
+{
+    if (column < 0)
+    {
+        return;
+    }
+
+    if (column >= static_cast<int32_t>(widths.size()))
+    {
+        widths.resize(column + 1, default_column_width);
+        alignments.resize(column + 1, hori_alignment::left);
+    }
+    widths[column] = width;
+
+    update_columns();
+    update_scroll_areas();
+
+    redraw();
+}
+
+int32_t grid::column_width(int32_t column) const
+{
+    return column >= 0 && column < static_cast<int32_t>(widths.size()) ? widths[column] : default_column_width;
+}
+
+void grid::set_column_alignment(int32_t column, hori_alignment alignment)
+{
+    if (column < 0)
+    {
+        return;
+    }
+
+    if (column >= static_cast<int32_t>(widths.size()))
+    {
+        widths.resize(column + 1, default_column_width);
+        alignments.resize(column + 1, hori_alignment::left);
+    }
+    alignments[column] = alignment;
+
+    redraw();
+}
+
+void grid::set_row_height(int32_t height)
+{
+    row_height_ = (std::max)(height, 1);
+
+    update_scroll_areas();
+
+    redraw();
+}
+
+int32_t grid::row_height() const
+{
+    return row_height_;
+}
+
+void grid::set_frozen_columns(int32_t count)
+{
+    frozen_columns_ = (std::max)(count, 0);
+
+    hori_scroll->set_scroll_pos(0);
+    update_scroll_areas();
+
+    redraw();
+}
+
+int32_t grid::frozen_columns() const
+{
+    return frozen_columns_;
+}
+
+void grid::select_row(int32_t row)
+{
+    change_selected_row(row);
+}
+
+int32_t grid::selected_row() const
+{
+    return selected_row_;
+}
+
+void grid::set_row_change_callback(std::function<void(int32_t)> row_change_callback_)
+{
+    row_change_callback = row_change_callback_;
+}
+
+void grid::set_row_activate_callback(std::function<void(int32_t)> row_activate_callback_)
+{
+    row_activate_callback = row_activate_callback_;
+}
+
+void grid::set_cell_click_callback(std::function<void(int32_t, int32_t)> cell_click_callback_)
+{
+    cell_click_callback = cell_click_callback_;
+}
+
+void grid::update_columns()
+{
+    columns_count = source_ ? source_->columns_count() : 0;
+
+    if (static_cast<int32_t>(widths.size()) < columns_count)
+    {
+        widths.resize(columns_count, default_column_width);
+        alignments.resize(columns_count, hori_alignment::left);
+    }
+
+    lefts.resize(columns_count + 1);
+    lefts[0] = 0;
+    for (int32_t i = 0; i != columns_count; ++i)
+    {
+        lefts[i + 1] = lefts[i] + widths[i];
+    }
+}
+
+void grid::update_scroll_areas()
+{
+    auto frozen = (std::min)(frozen_columns_, columns_count);
+
+    auto vert_area = clamp_pixels((std::max)(static_cast<int64_t>(rows_count) * row_height_ - (view_height() - row_height_), static_cast<int64_t>(0)));
+    auto hori_area = (std::max)(lefts[columns_count] - lefts[frozen] - (view_width() - frozen_width()), 0);
+
+    vert_scroll->set_area(vert_area);
+    if (vert_scroll->get_scroll_pos() > vert_area)
+    {
+        vert_scroll->set_scroll_pos(vert_area);
+    }
+
+    hori_scroll->set_area(hori_area);
+    if (hori_scroll->get_scroll_pos() > hori_area)
+    {
+        hori_scroll->set_scroll_pos(hori_area);
+    }
+
+    if (vert_area > 0 && showed_)
+    {
+        vert_scroll->show();
+    }
+    else
+    {
+        vert_scroll->hide();
+    }
+
+    if (hori_area > 0 && showed_)
+    {
+        hori_scroll->show();
+    }
+    else
+    {
+        hori_scroll->hide();
+    }
+}
+
+int32_t grid::view_width() const
+{
+    return position_.width() - theme_dimension(tcn, tv_border_width, theme_) * 2;
+}
+
+int32_t grid::view_height() const
+{
+    return position_.height() - theme_dimension(tcn, tv_border_width, theme_) * 2;
+}
+
+int32_t grid::frozen_width() const
+{
+    return lefts[(std::min)(frozen_columns_, columns_count)];
+}
+
+int32_t grid::column_left(int32_t column) const
+{
+    auto frozen = (std::min)(frozen_columns_, columns_count);
+    if (column < frozen)
+    {
+        return lefts[column];
+    }
+
+    return frozen_width() + lefts[column] - lefts[frozen] - hori_scroll->get_scroll_pos();
+}
+
+int32_t grid::find_column(int32_t x) const
+{
+    auto frozen = (std::min)(frozen_columns_, columns_count);
+    auto frozen_w = frozen_width();
+
+    if (x < 0 || x >= view_width())
+    {
+        return -1;
+    }
+
+    auto content_x = x < frozen_w ? x : lefts[frozen] + x - frozen_w + hori_scroll->get_scroll_pos();
+
+    auto column = static_cast<int32_t>(std::upper_bound(lefts.begin(), lefts.begin() + columns_count + 1, content_x) - lefts.begin()) - 1;
+
+    return column < columns_count ? column : -1;
+}
+
+int32_t grid::find_row(int32_t y) const
+{
+    if (y < row_height_ || y >= view_height())
+    {
+        return -1;
+    }
+
+    auto row = (static_cast<int64_t>(y) - row_height_ + vert_scroll->get_scroll_pos()) / row_height_;
+
+    return row < rows_count ? static_cast<int32_t>(row) : -1;
+}
+
+void grid::make_row_visible(int32_t row)
+{
+    auto top = static_cast<int64_t>(row) * row_height_;
+    auto view = view_height() - row_height_;
+    auto scroll_pos = vert_scroll->get_scroll_pos();
+
+    if (top < scroll_pos)
+    {
+        vert_scroll->set_scroll_pos(clamp_pixels(top));
+    }
+    else if (top + row_height_ > static_cast<int64_t>(scroll_pos) + view)
+    {
+        vert_scroll->set_scroll_pos(clamp_pixels(top + row_height_ - view));
+    }
+}
+
+void grid::change_selected_row(int32_t row)
+{
+    if (row == selected_row_ || row < -1 || row >= rows_count)
+    {
+        return;
+    }
+
+    selected_row_ = row;
+
+    if (row != -1)
+    {
+        make_row_visible(row);
+    }
+
+    redraw();
+
+    if (row_change_callback)
+    {
+        row_change_callback(selected_row_);
+    }
+}
+
+void grid::on_scroll(scroll_state, int32_t)
+{
+    redraw();
+}
+
+void grid::redraw()
+{
+    if (showed_)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position());
+        }
+    }
+}
+
+}
@@ -13,6 +13,8 @@
 
 #include <wui/theme/theme.hpp>
 
+#include <wui/graphic/image_atlas.hpp>
+
 #include <wui/system/tools.hpp>
 #include <wui/system/path_tools.hpp>
 
@@ -24,6 +26,11 @@
 
 void load_image_from_data(const std::vector<uint8_t> &data, Gdiplus::Image **img)
 {
+    if (data.empty())
+    {
+        return;
+    }
+
     HGLOBAL h_buffer = ::GlobalAlloc(GMEM_MOVEABLE, data.size());
     if (h_buffer)
     {
@@ -89,6 +96,11 @@ void free_image(Gdiplus::Image **img)
 
 void load_image_from_data(const std::vector<uint8_t> &data_, cairo_surface_t **img)
 {
+    if (data_.empty())
+    {
+        return;
+    }
+
     struct png_reader_data
     {
         const uint8_t *data;
@@ -154,6 +166,9 @@ image::image(int32_t resource_index_, std::shared_ptr<i_theme> theme__)
     parent_(),
     showed_(true), topmost_(false),
     file_name(),
+    theme_image_name(),
+    atlas(),
+    atlas_rect{ 0 },
     resource_index(resource_index_),
     img(nullptr),
     err{}
@@ -168,6 +183,9 @@ image::image(std::string_view file_name_, std::shared_ptr<i_theme> theme__)
     parent_(),
     showed_(true), topmost_(false),
     file_name(file_name_),
+    theme_image_name(),
+    atlas(),
+    atlas_rect{ 0 },
 #ifdef _WIN32
     resource_index(0),
 #endif
@@ -183,10 +201,14 @@ image::image(const std::vector<uint8_t> &data)
     parent_(),
     showed_(true), topmost_(false),
     file_name(),
+    theme_image_name(),
+    atlas(),
+    atlas_rect{ 0 },
 #ifdef _WIN32
     resource_index(0),
 #endif
-    img(nullptr)
+    img(nullptr),
+    err{}
 {
     load_image_from_data(data, &img);
 }
@@ -209,26 +231,16 @@ void image::draw(graphic &gr_, const rect &)
         return;
     }
 
-#ifdef _WIN32
-    if (img)
+    if (atlas)
     {
-        Gdiplus::Graphics gr(gr_.drawable());
-
-        auto control_pos = position();
-
-        gr.DrawImage(
-            img,
-            Gdiplus::Rect(control_pos.left, control_pos.top, control_pos.width(), control_pos.height()),
-            0, 0, img->GetWidth(), img->GetHeight(),
-            Gdiplus::UnitPixel,
-            nullptr);
+        atlas->draw(gr_, atlas_rect, position());
+        return;
     }
-#elif __linux__
+
     if (img)
     {
         gr_.draw_surface(*img, position());
     }
-#endif
 }
 
 void image::set_position(const rect &position__, bool redraw)
@@ -285,6 +297,11 @@ void image::update_theme_control_name(std::string_view )
 {
 }
 
+std::string_view image::theme_control_name() const
+{
+    return tc;
+}
+
 void image::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -293,6 +310,11 @@ void image::update_theme(std::shared_ptr<i_theme> theme__)
     }
     theme_ = theme__;
 
+    if (!theme_image_name.empty())
+    {
+        change_theme_image(theme_image_name, theme_);
+    }
+    else
 #ifdef _WIN32
     if (resource_index)
     {
@@ -345,6 +367,7 @@ void image::change_image(int32_t resource_index_)
 {
     resource_index = resource_index_;
 
+    reset_atlas();
     free_image(&img);
     load_image_from_resource(resource_index, boost::nowide::widen(theme_string(tc, tv_resource, theme_)), &img);
     
@@ -356,6 +379,7 @@ void image::change_image(std::string_view file_name_)
 {
     file_name = file_name_;
 
+    reset_atlas();
     free_image(&img);
     load_image_from_file(file_name, theme_string(tc, tv_path, theme_), &img, err);
 
@@ -364,14 +388,49 @@ void image::change_image(std::string_view file_name_)
 
 void image::change_image(const std::vector<uint8_t> &data)
 {
+    reset_atlas();
     free_image(&img);
     load_image_from_data(data, &img);
 
     redraw();
 }
 
+void image::change_theme_image(std::string_view name, std::shared_ptr<i_theme> theme__)
+{
+    if (theme__)
+    {
+        theme_ = theme__;
+    }
+
+    std::string name_(name);
+
+    reset_atlas();
+    free_image(&img);
+
+    theme_image_name = name_;
+
+    atlas = theme_image_atlas(1.0, theme_);
+    if (atlas)
+    {
+        atlas_rect = atlas->find(name_);
+    }
+
+    if (atlas_rect.is_null())
+    {
+        /// Image is not packed, decode it as usual
+        atlas.reset();
+        load_image_from_data(theme_image(name_, theme_), &img);
+    }
+
+    redraw();
+}
+
 int32_t image::width() const
 {
+    if (atlas)
+    {
+        return atlas_rect.width();
+    }
     if (img)
     {
 #ifdef _WIN32
@@ -385,6 +444,10 @@ int32_t image::width() const
 
 int32_t image::height() const
 {
+    if (atlas)
+    {
+        return atlas_rect.height();
+    }
     if (img)
     {
 #ifdef _WIN32
@@ -396,6 +459,13 @@ int32_t image::height() const
     return 0;
 }
 
+void image::reset_atlas()
+{
+    theme_image_name.clear();
+    atlas.reset();
+    atlas_rect = { 0 };
+}
+
 void image::redraw()
 {
     if (showed_)
@@ -13,6 +13,8 @@
 
 #include <wui/theme/theme.hpp>
 
+#include <wui/graphic/font_registry.hpp>
+
 #include <wui/system/tools.hpp>
 
 #include <wui/system/clipboard_tools.hpp>
@@ -24,17 +26,25 @@
 #include <boost/nowide/convert.hpp>
 #include <utf8/utf8.h>
 
+#include <algorithm>
+
 namespace wui
 {
 
 static const int32_t input_horizontal_indent = 5;
+static const int32_t input_multiline_vertical_indent = 3;
 
 input::input(std::string_view text__, input_view input_view__, std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
     : input_view_(input_view__),
-    text_(text__),
+    text_(input_view__ != input_view::multiline ? text__ : ""),
+    buffer_(input_view__ == input_view::multiline ? text__ : ""),
+    journal(),
     change_callback(),
+    modify_callback(),
     tcn(theme_control_name_),
     theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)),
+    line_font{ 0 }, line_font_size(0),
     position_(),
     cursor_position(0), select_start_position(0), select_end_position(0),
     parent_(),
@@ -45,8 +55,20 @@ input::input(std::string_view text__, input_view input_view__, std::string_view
     focused_(false),
     cursor_visible(false),
     selecting(false),
-    left_shift(0)
+    mouse_on_control(false), mouse_on_slider(false),
+    left_shift(0),
+    content(), content_width(0), content_height(0),
+    line_height(0),
+    top_line(0),
+    follow_cursor(false),
+    line_buffer(),
+    boundaries(),
+    vert_scroll(std::make_shared<scroll>(0, 0, orientation::vertical, std::bind(&input::on_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__)),
+    scroll_area(0),
+    updating_scroll(false)
 {
+    update_line_font();
+
     menu_->set_items({
             { 0, menu_item_state::normal, locale(tc, cl_cut).data(), "Ctrl+X", nullptr, {}, [this](int32_t i) { buffer_cut(); } },
             { 1, menu_item_state::normal, locale(tc, cl_copy).data(), "Ctrl+C", nullptr, {}, [this](int32_t i) { buffer_copy(); } },
@@ -63,10 +85,9 @@ input::~input()
     }
 }
 
-int32_t get_text_width(graphic &gr, std::string text, size_t text_length, const font &font_)
+int32_t get_text_width(graphic &gr, std::string_view text, size_t text_length, font_handle font_)
 {
-    text.resize(text_length);
-    auto text_rect = gr.measure_text(text, font_);
+    auto text_rect = gr.measure_text(text.substr(0, text_length), font_);
 
     return text_rect.right;
 }
@@ -87,19 +108,16 @@ void input::draw(graphic &gr, const rect &)
         theme_dimension(tcn, tv_border_width, theme_),
         theme_dimension(tcn, tv_round, theme_));
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
-    if (input_view_ == input_view::password)
+    if (multiline())
     {
-#ifdef _WIN32
-        font_.name = "Courier New";
-#elif __linux__
-        font_.name = "monospace";
-#endif
+        return draw_multiline(gr, control_pos);
     }
 
+    auto font_ = line_font;
+
     /// Create memory dc for text and selection bar
     auto full_text_width = get_text_width(gr, text_, text_.size(), font_) + 2;
-    auto text_height = font_.size;
+    auto text_height = line_font_size;
 
     system_context ctx = { 0 };
     auto parent__ = parent_.lock();
@@ -167,8 +185,299 @@ void input::draw(graphic &gr, const rect &)
         mem_gr, left_shift, 0);
 }
 
-size_t input::calculate_mouse_cursor_position(int32_t x)
+void input::draw_multiline(graphic &gr, const rect &control_pos)
 {
+    auto indent = theme_dimension(tcn, tv_border_width, theme_) + input_multiline_vertical_indent;
+
+    system_context ctx = { 0 };
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+#ifdef _WIN32
+        ctx = parent__->context();
+#elif __linux__
+        ctx = { parent__->context().display, parent__->context().connection, parent__->context().screen, gr.drawable() };
+#endif
+    }
+
+    if (!update_content(ctx, position_.width() - input_horizontal_indent * 2, position_.height() - indent * 2))
+    {
+        return;
+    }
+
+    auto font_ = text_font;
+
+    if (follow_cursor)
+    {
+        make_cursor_visible(font_);
+        follow_cursor = false;
+    }
+
+    auto lines = buffer_.lines_count();
+    auto visible = static_cast<size_t>(visible_lines());
+    top_line = (std::min)(top_line, lines > visible ? lines - visible : 0);
+
+    update_scroll();
+
+    content->draw_rect({ 0, 0, content_width, content_height }, theme_color(tcn, tv_background, theme_));
+
+    auto text_color = theme_color(tcn, tv_text, theme_);
+    auto selection_color = theme_color(tcn, tv_selection, theme_);
+    auto cursor_color = theme_color(tcn, tv_cursor, theme_);
+
+    auto select_start = (std::min)(select_start_position, select_end_position),
+        select_end = (std::max)(select_start_position, select_end_position);
+
+    /// Only the visible lines are taken from the buffer and measured, the prefixes are measured for the selection and the cursor
+    int32_t y = 0;
+    for (auto n = top_line; n < lines && y < content_height; ++n, y += line_height)
+    {
+        auto start = buffer_.line_start(n);
+
+        line_buffer.clear();
+        buffer_.line(n, line_buffer);
+
+        auto end = start + line_buffer.size();
+
+        if (select_start < select_end && select_start <= end && select_end > start)
+        {
+            auto left = select_start > start ? line_text_width(select_start - start, font_) : 0;
+            auto right = select_end <= end ? line_text_width(select_end - start, font_) :
+                line_text_width(line_buffer.size(), font_) + line_height / 3; /// the selected line break
+
+            content->draw_rect({ left - left_shift, y, right - left_shift, y + line_height }, selection_color);
+        }
+
+        if (!line_buffer.empty())
+        {
+            content->draw_text({ -left_shift, y, 0, 0 }, line_buffer, text_color, font_);
+        }
+
+        if (cursor_visible && cursor_position >= start && cursor_position <= end)
+        {
+            auto x = line_text_width(cursor_position - start, font_) - left_shift;
+            content->draw_line({ x, y, x, y + line_height }, cursor_color);
+        }
+    }
+
+    gr.draw_graphic({ control_pos.left + input_horizontal_indent,
+            control_pos.top + indent,
+            content_width,
+            content_height },
+        *content, 0, 0);
+
+    if ((mouse_on_control || focused_) && has_scrollbar())
+    {
+        vert_scroll->draw(gr, {});
+    }
+}
+
+bool input::update_content(system_context &ctx, int32_t width, int32_t height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    if (!content || content_width != width || content_height != height)
+    {
+        content.reset(new graphic(ctx));
+        if (!content->init_image({ 0, 0, width, height }, theme_color(tcn, tv_background, theme_)))
+        {
+            content.reset();
+            return false;
+        }
+
+        content_width = width;
+        content_height = height;
+    }
+
+    if (line_height == 0)
+    {
+        line_height = content->measure_text("Qq", text_font).height();
+        if (line_height <= 0)
+        {
+            line_height = 1;
+        }
+    }
+
+    return true;
+}
+
+void input::make_cursor_visible(font_handle font_)
+{
+    auto visible = static_cast<size_t>(visible_lines());
+    auto cursor_line = buffer_.offset_line(cursor_position);
+
+    if (cursor_line < top_line)
+    {
+        top_line = cursor_line;
+    }
+    else if (cursor_line >= top_line + visible)
+    {
+        top_line = cursor_line - visible + 1;
+    }
+
+    auto start = buffer_.line_start(cursor_line);
+
+    line_buffer.clear();
+    buffer_.copy(start, cursor_position - start, line_buffer);
+
+    auto x = line_text_width(line_buffer.size(), font_);
+    if (x < left_shift)
+    {
+        left_shift = (std::max)(0, x - content_width / 4);
+    }
+    else if (x >= left_shift + content_width - 1)
+    {
+        left_shift = x - content_width * 3 / 4;
+    }
+}
+
+int32_t input::line_text_width(size_t count, font_handle font_)
+{
+    if (count == 0 || !content)
+    {
+        return 0;
+    }
+
+    return content->measure_text(std::string_view(line_buffer).substr(0, count), font_).width();
+}
+
+size_t input::line_position(size_t n, int32_t x)
+{
+    auto start = buffer_.line_start(n);
+
+    line_buffer.clear();
+    buffer_.line(n, line_buffer);
+
+    if (!content || line_buffer.empty() || x <= 0)
+    {
+        return start;
+    }
+
+    auto font_ = text_font;
+
+    /// The char boundaries are halved, so the long line is measured the log of its length times
+    boundaries.clear();
+    for (size_t i = 0; i != line_buffer.size(); ++i)
+    {
+        if ((line_buffer[i] & 0xC0) != 0x80)
+        {
+            boundaries.push_back(i);
+        }
+    }
+    boundaries.push_back(line_buffer.size());
+
+    size_t low = 0, high = boundaries.size() - 1;
+    while (low < high)
+    {
+        auto middle = (low + high + 1) / 2;
+        if (line_text_width(boundaries[middle], font_) <= x)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+
+    /// The nearest of the boundaries around the x
+    if (low + 1 < boundaries.size() &&
+        x - line_text_width(boundaries[low], font_) > line_text_width(boundaries[low + 1], font_) - x)
+    {
+        ++low;
+    }
+
+    return start + boundaries[low];
+}
+
+void input::move_cursor_line(int64_t lines, bool shift_pressed)
+{
+    auto cursor_line = buffer_.offset_line(cursor_position);
+    auto start = buffer_.line_start(cursor_line);
+
+    line_buffer.clear();
+    buffer_.copy(start, cursor_position - start, line_buffer);
+
+    auto x = line_text_width(line_buffer.size(), text_font);
+
+    auto target = (std::max)(static_cast<int64_t>(cursor_line) + lines, int64_t(0));
+    target = (std::min)(target, static_cast<int64_t>(buffer_.lines_count()) - 1);
+
+    auto prev_position = cursor_position;
+
+    cursor_position = line_position(static_cast<size_t>(target), x);
+
+    update_select_positions(shift_pressed, prev_position, cursor_position);
+
+    redraw();
+}
+
+int32_t input::visible_lines() const
+{
+    return line_height > 0 ? (std::max)(content_height / line_height, 1) : 1;
+}
+
+void input::update_scroll()
+{
+    auto lines = buffer_.lines_count();
+    auto visible = static_cast<size_t>(visible_lines());
+
+    int32_t area = lines > visible ? static_cast<int32_t>(lines - visible) * line_height : 0;
+    int32_t pos = static_cast<int32_t>(top_line) * line_height;
+
+    /// The scroll's callback is not needed for the positions set by the input
+    updating_scroll = true;
+
+    if (area != scroll_area)
+    {
+        scroll_area = area;
+        vert_scroll->set_area(area);
+    }
+    if (pos != vert_scroll->get_scroll_pos())
+    {
+        vert_scroll->set_scroll_pos(pos);
+    }
+
+    updating_scroll = false;
+}
+
+void input::on_scroll(scroll_state, int32_t scroll_pos)
+{
+    if (updating_scroll || line_height <= 0)
+    {
+        return;
+    }
+
+    top_line = static_cast<size_t>(scroll_pos / line_height);
+
+    redraw();
+}
+
+bool input::has_scrollbar() const
+{
+    return multiline() && scroll_area > 0;
+}
+
+size_t input::calculate_mouse_cursor_position(int32_t x, int32_t y)
+{
+    if (multiline())
+    {
+        if (!content || line_height <= 0)
+        {
+            return cursor_position;
+        }
+
+        auto control_pos = position();
+        auto top = y - control_pos.top - theme_dimension(tcn, tv_border_width, theme_) - input_multiline_vertical_indent;
+
+        auto n = (std::min)(top_line + (top > 0 ? top / line_height : 0), buffer_.lines_count() - 1);
+
+        return line_position(n, x - control_pos.left - input_horizontal_indent + left_shift);
+    }
+
     if (text_.empty())
     {
         return 0;
@@ -185,15 +494,7 @@ size_t input::calculate_mouse_cursor_position(int32_t x)
     graphic mem_gr(ctx);
     mem_gr.init(position_, 0);
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
-    if (input_view_ == input_view::password)
-    {
-#ifdef _WIN32
-        font_.name = "Courier New";
-#elif __linux__
-        font_.name = "monospace";
-#endif
-    }
+    auto font_ = line_font;
 
     int32_t text_width = 0;
     size_t count = 0;
@@ -252,7 +553,7 @@ bool input::clear_selected_text()
 
         cursor_position = start;
 
-        text_.erase(start, end - start);
+        erase_text(start, end - start);
 
         selecting = false;
         select_start_position = 0;
@@ -264,24 +565,26 @@ bool input::clear_selected_text()
     return false;
 }
 
-void input::select_current_word(int32_t x)
+void input::select_current_word(int32_t x, int32_t y)
 {
-    cursor_position = calculate_mouse_cursor_position(x);
+    cursor_position = calculate_mouse_cursor_position(x, y);
 
     select_start_position = cursor_position;
     select_end_position = cursor_position;
 
-    while (select_start_position != 0 && text_[select_start_position] != ' ')
+    auto is_space = [](char c) { return c == ' ' || c == '\n'; };
+
+    while (select_start_position != 0 && !is_space(char_at(select_start_position)))
     {
         --select_start_position;
     }
 
-    if (text_[select_start_position] == ' ') // remove first space from selection
+    if (is_space(char_at(select_start_position))) // remove first space from selection
     {
         ++select_start_position;
     }
 
-    while (select_end_position != text_.size() && text_[select_end_position] != ' ')
+    while (select_end_position != text_size() && !is_space(char_at(select_end_position)))
     {
         ++select_end_position;
     }
@@ -292,7 +595,7 @@ void input::select_current_word(int32_t x)
 void input::select_all()
 {
     select_start_position = 0;
-    select_end_position = text_.size();;
+    select_end_position = text_size();
 
     redraw();
 }
@@ -305,22 +608,154 @@ bool input::check_count_valid(size_t count)
 
 void input::move_cursor_left()
 {
-    --cursor_position;
-    while (!check_count_valid(cursor_position))
+    cursor_position = prev_char(cursor_position);
+}
+
+void input::move_cursor_right()
+{
+    cursor_position = next_char(cursor_position);
+}
+
+bool input::multiline() const
+{
+    return input_view_ == input_view::multiline;
+}
+
+size_t input::text_size() const
+{
+    return multiline() ? buffer_.size() : text_.size();
+}
+
+char input::char_at(size_t position) const
+{
+    if (multiline())
     {
-        --cursor_position;
+        return buffer_.at(position);
     }
+    return position < text_.size() ? text_[position] : 0;
 }
 
-void input::move_cursor_right()
+std::string input::text_part(size_t position, size_t count) const
+{
+    if (multiline())
+    {
+        std::string out;
+        buffer_.copy(position, count, out);
+        return out;
+    }
+    return text_.substr(position, count);
+}
+
+void input::insert_text(size_t position, std::string_view text, bool typing)
+{
+    journal.insert(position, text, typing);
+
+    apply_edit(edit_journal::operation::insert, position, text);
+}
+
+void input::erase_text(size_t position, size_t count, bool typing)
+{
+    auto text = text_part(position, count);
+
+    journal.erase(position, text, typing);
+
+    apply_edit(edit_journal::operation::erase, position, text);
+}
+
+void input::apply_edit(edit_journal::operation operation_, size_t position, std::string_view text)
 {
-    ++cursor_position;
-    while (!check_count_valid(cursor_position))
+    if (operation_ == edit_journal::operation::insert)
     {
-        ++cursor_position;
+        if (multiline())
+        {
+            buffer_.insert(position, text);
+        }
+        else
+        {
+            text_.insert(position, text);
+        }
+        cursor_position = position + text.size();
+    }
+    else
+    {
+        if (multiline())
+        {
+            buffer_.erase(position, text.size());
+        }
+        else
+        {
+            text_.erase(position, text.size());
+        }
+        cursor_position = position;
     }
 }
 
+void input::notify_change()
+{
+    if (modify_callback)
+    {
+        modify_callback();
+    }
+    if (change_callback)
+    {
+        change_callback(multiline() ? buffer_.to_string() : text_);
+    }
+}
+
+size_t input::prev_char(size_t position)
+{
+    if (position == 0)
+    {
+        return 0;
+    }
+
+    --position;
+    if (multiline())
+    {
+        /// The utf8 continuation bytes are 10xxxxxx
+        while (position != 0 && (buffer_.at(position) & 0xC0) == 0x80)
+        {
+            --position;
+        }
+    }
+    else
+    {
+        while (position != 0 && !check_count_valid(position))
+        {
+            --position;
+        }
+    }
+
+    return position;
+}
+
+size_t input::next_char(size_t position)
+{
+    auto size = text_size();
+    if (position >= size)
+    {
+        return size;
+    }
+
+    ++position;
+    if (multiline())
+    {
+        while (position != size && (buffer_.at(position) & 0xC0) == 0x80)
+        {
+            ++position;
+        }
+    }
+    else
+    {
+        while (position != size && !check_count_valid(position))
+        {
+            ++position;
+        }
+    }
+
+    return position;
+}
+
 void input::receive_control_events(const event &ev)
 {
     if (!showed_ || !enabled_)
@@ -330,10 +765,47 @@ void input::receive_control_events(const event &ev)
 
     if (ev.type == event_type::mouse)
     {
+        if (has_scrollbar())
+        {
+            if (vert_scroll->position().in(ev.mouse_event_.x, ev.mouse_event_.y))
+            {
+                if (!mouse_on_slider)
+                {
+                    mouse_on_slider = true;
+
+                    event sev = ev;
+                    sev.mouse_event_.type = wui::mouse_event_type::enter;
+
+                    return vert_scroll->receive_control_events(sev);
+                }
+
+                return vert_scroll->receive_control_events(ev);
+            }
+            else
+            {
+                if (mouse_on_slider)
+                {
+                    mouse_on_slider = false;
+
+                    event sev = ev;
+                    sev.mouse_event_.type = wui::mouse_event_type::leave;
+
+                    return vert_scroll->receive_control_events(sev);
+                }
+            }
+        }
+
         switch (ev.mouse_event_.type)
         {
             case mouse_event_type::enter:
             {
+                mouse_on_control = true;
+                if (has_scrollbar())
+                {
+                    vert_scroll->show();
+                    redraw();
+                }
+
                 auto parent__ = parent_.lock();
                 if (parent__)
                 {
@@ -343,11 +815,18 @@ void input::receive_control_events(const event &ev)
             break;
             case mouse_event_type::leave:
             {
+                mouse_on_control = false;
+                mouse_on_slider = false;
+                if (has_scrollbar())
+                {
+                    redraw();
+                }
+
                 if (selecting)
                 {
                     if (select_start_position < select_end_position)
                     {
-                        select_end_position = text_.size();
+                        select_end_position = text_size();
                         cursor_position = select_end_position;
                     }
                     else
@@ -365,7 +844,10 @@ void input::receive_control_events(const event &ev)
             }
             break;
             case mouse_event_type::left_down:
-                cursor_position = calculate_mouse_cursor_position(ev.mouse_event_.x);
+                journal.close_run();
+
+                cursor_position = calculate_mouse_cursor_position(ev.mouse_event_.x, ev.mouse_event_.y);
+                follow_cursor = true;
 
                 selecting = true;
                 select_start_position = cursor_position;
@@ -390,29 +872,46 @@ void input::receive_control_events(const event &ev)
             case mouse_event_type::move:
                 if (selecting)
                 {    
-                    auto measured_cursor_position = calculate_mouse_cursor_position(ev.mouse_event_.x);
+                    auto measured_cursor_position = calculate_mouse_cursor_position(ev.mouse_event_.x, ev.mouse_event_.y);
                     if (cursor_position != measured_cursor_position)
                     {
                         cursor_position = measured_cursor_position;
                         select_end_position = cursor_position;
+                        follow_cursor = true;
 
                         redraw();
                     }
                 }
             break;
             case mouse_event_type::left_double:
-                select_current_word(ev.mouse_event_.x);
+                select_current_word(ev.mouse_event_.x, ev.mouse_event_.y);
+            break;
+            case mouse_event_type::wheel:
+                if (has_scrollbar())
+                {
+                    if (ev.mouse_event_.wheel_delta > 0)
+                    {
+                        vert_scroll->scroll_up();
+                    }
+                    else
+                    {
+                        vert_scroll->scroll_down();
+                    }
+                }
             break;
             default: break;
         }
     }
     else if (ev.type == event_type::keyboard)
     {
+        follow_cursor = true;
+
         switch (ev.keyboard_event_.type)
         {
             case keyboard_event_type::down:
                 timer_.stop();
                 cursor_visible = true;
+
                 switch (ev.keyboard_event_.key[0])
                 {
                     case vk_left: case vk_nleft:
@@ -420,6 +919,7 @@ void input::receive_control_events(const event &ev)
                         {
                             return;
                         }
+                        journal.close_run(); /// the cursor move ends the typing run
                         if (cursor_position > 0)
                         {
                             auto prev_position = cursor_position;
@@ -438,7 +938,8 @@ void input::receive_control_events(const event &ev)
                         {
                             return;
                         }
-                        if (cursor_position < text_.size())
+                        journal.close_run();
+                        if (cursor_position < text_size())
                         {
                             auto prev_position = cursor_position;
 
@@ -456,29 +957,89 @@ void input::receive_control_events(const event &ev)
                         {
                             return;
                         }
-                        update_select_positions(ev.keyboard_event_.modifier == vk_lshift ||
-                            ev.keyboard_event_.modifier == vk_rshift,
-                            cursor_position, 0);
-                        cursor_position = 0;
-                        redraw();
+                        journal.close_run();
+                        {
+                            auto home = multiline() ? buffer_.line_start(buffer_.offset_line(cursor_position)) : 0;
+
+                            update_select_positions(ev.keyboard_event_.modifier == vk_lshift ||
+                                ev.keyboard_event_.modifier == vk_rshift,
+                                cursor_position, home);
+                            cursor_position = home;
+                            redraw();
+                        }
                     break;
                     case vk_end: case vk_nend:
                         if (ev.keyboard_event_.key[0] == vk_nend && ev.keyboard_event_.modifier == vk_numlock)
                         {
                             return;
                         }
-                        if (!text_.empty())
+                        journal.close_run();
+                        if (text_size() != 0)
                         {
+                            auto end = text_size();
+                            if (multiline())
+                            {
+                                auto cursor_line = buffer_.offset_line(cursor_position);
+                                if (cursor_line + 1 < buffer_.lines_count())
+                                {
+                                    end = buffer_.line_start(cursor_line + 1) - 1;
+                                }
+                            }
+
                             update_select_positions(ev.keyboard_event_.modifier == vk_lshift ||
                                 ev.keyboard_event_.modifier == vk_rshift,
                                 cursor_position,
-                                text_.size());
+                                end);
 
-                            cursor_position = text_.size();
+                            cursor_position = end;
 
                             redraw();
                         }
                     break;
+                    case vk_up: case vk_nup:
+                        if (ev.keyboard_event_.key[0] == vk_nup && ev.keyboard_event_.modifier == vk_numlock)
+                        {
+                            return;
+                        }
+                        journal.close_run();
+                        if (multiline())
+                        {
+                            move_cursor_line(-1, ev.keyboard_event_.modifier == vk_lshift || ev.keyboard_event_.modifier == vk_rshift);
+                        }
+                    break;
+                    case vk_down: case vk_ndown:
+                        if (ev.keyboard_event_.key[0] == vk_ndown && ev.keyboard_event_.modifier == vk_numlock)
+                        {
+                            return;
+                        }
+                        journal.close_run();
+                        if (multiline())
+                        {
+                            move_cursor_line(1, ev.keyboard_event_.modifier == vk_lshift || ev.keyboard_event_.modifier == vk_rshift);
+                        }
+                    break;
+                    case vk_page_up: case vk_npage_up:
+                        if (ev.keyboard_event_.key[0] == vk_npage_up && ev.keyboard_event_.modifier == vk_numlock)
+                        {
+                            return;
+                        }
+                        journal.close_run();
+                        if (multiline())
+                        {
+                            move_cursor_line(-visible_lines(), ev.keyboard_event_.modifier == vk_lshift || ev.keyboard_event_.modifier == vk_rshift);
+                        }
+                    break;
+                    case vk_page_down: case vk_npage_down:
+                        if (ev.keyboard_event_.key[0] == vk_npage_down && ev.keyboard_event_.modifier == vk_numlock)
+                        {
+                            return;
+                        }
+                        journal.close_run();
+                        if (multiline())
+                        {
+                            move_cursor_line(visible_lines(), ev.keyboard_event_.modifier == vk_lshift || ev.keyboard_event_.modifier == vk_rshift);
+                        }
+                    break;
                     case vk_back:
                         if (input_view_ != input_view::readonly)
                         {
@@ -488,41 +1049,30 @@ void input::receive_control_events(const event &ev)
 
                                 move_cursor_left();
 
-                                text_.erase(cursor_position, prev_position - cursor_position);
+                                erase_text(cursor_position, prev_position - cursor_position, true);
                             }
                             
                             redraw();
 
-                            if (change_callback)
-                            {
-                                change_callback(text_);
-                            }
+                            notify_change();
                         }
                     break;
                     case vk_del:
-                        if (input_view_ != input_view::readonly && !text_.empty())
+                        if (input_view_ != input_view::readonly && text_size() != 0)
                         {
                             if (!clear_selected_text())
                             {
-                                if (text_.size() == cursor_position)
+                                if (text_size() == cursor_position)
                                 {
                                     return;
                                 }
 
-                                size_t char_count = 1;
-                                while (!check_count_valid(cursor_position + char_count))
-                                {
-                                    ++char_count;
-                                }
-                                text_.erase(cursor_position, char_count);
+                                erase_text(cursor_position, next_char(cursor_position) - cursor_position, true);
                             }
                             
                             redraw();
 
-                            if (change_callback)
-                            {
-                                change_callback(text_);
-                            }
+                            notify_change();
                         }
                     break;
                     case vk_return: case vk_rreturn:
@@ -561,11 +1111,33 @@ void input::receive_control_events(const event &ev)
                 {
                     return select_all();
                 }
+                else if (ev.keyboard_event_.key[0] == 0x1a) // ctrl + z
+                {
+                    if (input_view_ != input_view::readonly)
+                    {
+                        return undo();
+                    }
+                }
+                else if (ev.keyboard_event_.key[0] == 0x19) // ctrl + y
+                {
+                    if (input_view_ != input_view::readonly)
+                    {
+                        return redo();
+                    }
+                }
                 else if (ev.keyboard_event_.key[0] == 0x7f) // ctrl + backspace
                 {
                     if (input_view_ != input_view::readonly)
                     {
-                        return set_text("");
+                        /// The clearing is journaled, so it can be undone
+                        erase_text(0, text_size());
+
+                        selecting = false;
+                        select_start_position = select_end_position = 0;
+
+                        redraw();
+
+                        return notify_change();
                     }
                 }
 
@@ -574,19 +1146,24 @@ void input::receive_control_events(const event &ev)
                 {
                     return;
                 }
+
+                /// The line break is inserted by the execute_focused event, the other control chars are skipped
+                if (multiline() && static_cast<uint8_t>(ev.keyboard_event_.key[0]) < 0x20)
+                {
+                    return;
+                }
                 
+                journal.begin_group();
+
                 clear_selected_text();
 
-                text_.insert(cursor_position, ev.keyboard_event_.key);
-                
-                cursor_position += ev.keyboard_event_.key_size;
+                insert_text(cursor_position, std::string_view(ev.keyboard_event_.key, ev.keyboard_event_.key_size), true);
+
+                journal.end_group();
 
                 redraw();
 
-                if (change_callback)
-                {
-                    change_callback(text_);
-                }
+                notify_change();
             break;
         }
     }
@@ -597,7 +1174,14 @@ void input::receive_control_events(const event &ev)
             case internal_event_type::set_focus:
                 focused_ = true;
 
-                cursor_position = text_.size();
+                if (!multiline())
+                {
+                    cursor_position = text_.size();
+                }
+                else if (has_scrollbar())
+                {
+                    vert_scroll->show();
+                }
 
                 redraw();
 
@@ -613,8 +1197,28 @@ void input::receive_control_events(const event &ev)
 
                 timer_.stop();
 
+                vert_scroll->hide();
+
                 redraw();
             break;
+            case internal_event_type::execute_focused:
+                if (multiline())
+                {
+                    journal.begin_group();
+
+                    clear_selected_text();
+
+                    insert_text(cursor_position, "\n");
+
+                    journal.end_group();
+
+                    follow_cursor = true;
+                    redraw();
+
+                    notify_change();
+                }
+            break;
+            default: break;
         }
     }
 }
@@ -630,6 +1234,13 @@ void input::receive_plain_events(const event &ev)
 void input::set_position(const rect &position__, bool redraw)
 {
     update_control_position(position_, position__, showed_ && redraw, parent_);
+
+    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+
+    vert_scroll->set_position({ position_.right - 14 - border_width,
+        position_.top + border_width,
+        position_.right - border_width,
+        position_.bottom - border_width });
 }
 
 rect input::position() const
@@ -646,6 +1257,7 @@ void input::set_parent(std::shared_ptr<window> window_)
     my_plain_sid = window_->subscribe(std::bind(&input::receive_plain_events, this, std::placeholders::_1), event_type::mouse);
 
     window_->add_control(menu_, { 0 });
+    window_->add_control(vert_scroll, { 0 });
 }
 
 std::weak_ptr<window> input::parent() const
@@ -658,6 +1270,8 @@ void input::clear_parent()
     auto parent__ = parent_.lock();
     if (parent__)
     {
+        parent__->remove_control(vert_scroll);
+
         parent__->unsubscribe(my_control_sid);
         parent__->unsubscribe(my_plain_sid);
     }
@@ -695,6 +1309,11 @@ void input::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view input::theme_control_name() const
+{
+    return tcn;
+}
+
 void input::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -703,7 +1322,14 @@ void input::update_theme(std::shared_ptr<i_theme> theme__)
     }
     theme_ = theme__;
 
+    text_font = theme_font_handle(tcn, tv_font, theme_);
+    update_line_font();
+
+    /// The font can be changed, so the line height is measured again
+    line_height = 0;
+
     menu_->update_theme(theme_);
+    vert_scroll->update_theme(theme_);
     redraw();
 }
 
@@ -716,6 +1342,7 @@ void input::show()
 void input::hide()
 {
     showed_ = false;
+    vert_scroll->hide();
     auto parent__ = parent_.lock();
     if (parent__)
     {
@@ -747,25 +1374,136 @@ bool input::enabled() const
 
 void input::set_text(std::string_view text__)
 {
-    text_ = text__;
+    if (multiline())
+    {
+        buffer_.assign(text__);
+        top_line = 0;
+        left_shift = 0;
+    }
+    else
+    {
+        text_ = text__;
+    }
     cursor_position = 0;
 
+    journal.clear();
+
     redraw();
 
-    if (change_callback)
-    {
-        change_callback(text_);
-    }
+    notify_change();
 }
 
 std::string input::text() const
 {
-    return text_;
+    return multiline() ? buffer_.to_string() : text_;
 }
 
 void input::set_input_view(input_view input_view__)
 {
+    if ((input_view__ == input_view::multiline) != multiline())
+    {
+        /// The text is moved to the storage of the new view
+        if (input_view__ == input_view::multiline)
+        {
+            buffer_.assign(text_);
+            text_.clear();
+        }
+        else
+        {
+            text_ = buffer_.to_string();
+            buffer_.clear();
+
+            vert_scroll->hide();
+        }
+
+        cursor_position = select_start_position = select_end_position = 0;
+        top_line = 0;
+        left_shift = 0;
+
+        journal.clear();
+    }
+
     input_view_ = input_view__;
+
+    update_line_font();
+}
+
+void input::update_line_font()
+{
+    auto font_ = theme_font(tcn, tv_font, theme_);
+    if (input_view_ == input_view::password)
+    {
+#ifdef _WIN32
+        font_.name = "Courier New";
+#elif __linux__
+        font_.name = "monospace";
+#endif
+    }
+
+    line_font = intern_font(font_);
+    line_font_size = font_.size;
+}
+
+size_t input::lines_count() const
+{
+    return multiline() ? buffer_.lines_count() : 1;
+}
+
+std::string input::line(size_t n) const
+{
+    std::string out;
+    if (multiline())
+    {
+        buffer_.line(n, out);
+    }
+    else if (n == 0)
+    {
+        out = text_;
+    }
+    return out;
+}
+
+void input::undo()
+{
+    if (journal.undo(std::bind(&input::apply_edit, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)))
+    {
+        selecting = false;
+        select_start_position = select_end_position = 0;
+
+        follow_cursor = true;
+        redraw();
+
+        notify_change();
+    }
+}
+
+void input::redo()
+{
+    if (journal.redo(std::bind(&input::apply_edit, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)))
+    {
+        selecting = false;
+        select_start_position = select_end_position = 0;
+
+        follow_cursor = true;
+        redraw();
+
+        notify_change();
+    }
+}
+
+bool input::can_undo() const
+{
+    return journal.can_undo();
+}
+
+bool input::can_redo() const
+{
+    return journal.can_redo();
+}
+
+void input::set_undo_memory_budget(size_t bytes)
+{
+    journal.set_memory_budget(bytes);
 }
 
 void input::set_change_callback(std::function<void(const std::string&)> change_callback_)
@@ -773,6 +1511,11 @@ void input::set_change_callback(std::function<void(const std::string&)> change_c
     change_callback = change_callback_;
 }
 
+void input::set_modify_callback(std::function<void()> modify_callback_)
+{
+    modify_callback = modify_callback_;
+}
+
 void input::set_return_callback(std::function<void()> return_callback_)
 {
     return_callback = return_callback_;
@@ -816,7 +1559,7 @@ void input::buffer_copy()
         end = select_start_position;
     }
 
-    clipboard_put(text_.substr(start, end - start), parent_.lock()->context());
+    clipboard_put(text_part(start, end - start), parent_.lock()->context());
 }
 
 void input::buffer_cut()
@@ -832,10 +1575,7 @@ void input::buffer_cut()
 
     redraw();
 
-    if (change_callback)
-    {
-        change_callback(text_);
-    }
+    notify_change();
 }
 
 void input::buffer_paste()
@@ -845,20 +1585,24 @@ void input::buffer_paste()
         return;
     }
 
-    clear_selected_text();
-
     auto paste_string = clipboard_get_text(parent_.lock()->context());
+    if (multiline())
+    {
+        /// The lines are separated by '\n' only
+        paste_string.erase(std::remove(paste_string.begin(), paste_string.end(), '\r'), paste_string.end());
+    }
+
+    journal.begin_group();
+
+    clear_selected_text();
     
-    text_.insert(cursor_position, paste_string);
+    insert_text(cursor_position, paste_string);
 
-    cursor_position += paste_string.size();
+    journal.end_group();
 
     redraw();
 
-    if (change_callback)
-    {
-        change_callback(text_);
-    }
+    notify_change();
 }
 
 }
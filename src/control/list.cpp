@@ -25,6 +25,7 @@ namespace wui
 list::list(std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
     : tcn(theme_control_name_),
     theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)),
     position_(),
     parent_(),
     my_control_sid(),
@@ -33,6 +34,7 @@ list::list(std::string_view theme_control_name_, std::shared_ptr<i_theme> theme_
     mode(list_mode::simple),
     item_count(0), selected_item_(0), active_item_(-1),
     title_height(-1),
+    fixed_item_height(-1),
     scroll_area(0),
     vert_scroll(std::make_shared<scroll>(0, 0, orientation::vertical, std::bind(&list::on_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__)),
     draw_callback(),
@@ -488,6 +490,11 @@ void list::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view list::theme_control_name() const
+{
+    return tcn;
+}
+
 void list::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -496,6 +503,8 @@ void list::update_theme(std::shared_ptr<i_theme> theme__)
     }
     theme_ = theme__;
 
+    text_font = theme_font_handle(tcn, tv_font, theme_);
+
     redraw();
 }
 
@@ -566,11 +575,14 @@ void list::set_mode(list_mode mode_)
     mode = mode_;
 }
 
-void list::select_item(int32_t n_item)
+void list::select_item(int32_t n_item, bool make_visible)
 {
     selected_item_ = n_item;
 
-    make_selected_visible();
+    if (make_visible)
+    {
+        make_selected_visible();
+    }
 
     redraw();
 
@@ -594,8 +606,22 @@ void list::set_column_width(int32_t n_column, int32_t width)
     }
 }
 
+void list::set_item_height(int32_t height)
+{
+    fixed_item_height = height;
+
+    update_scroll_area();
+
+    redraw();
+}
+
 int32_t list::get_item_height(int32_t n_item) const
 {
+    if (fixed_item_height != -1)
+    {
+        return fixed_item_height;
+    }
+
     int32_t height = -1;
     if (item_height_callback)
     {
@@ -642,6 +668,11 @@ int32_t list::get_item_top(int32_t n_item) const
         return 0;
     }
 
+    if (fixed_item_height != -1)
+    {
+        return n_item * fixed_item_height;
+    }
+
     int32_t top = 0;
 
     for (int32_t i = 0; i != n_item; ++i)
@@ -734,7 +765,7 @@ void list::redraw_item(int32_t item)
 
 void list::calc_title_height(graphic &gr_)
 {
-    auto font = theme_font(tcn, tv_font, theme_);
+    auto font = text_font;
     auto text_indent = 5;
 
     if (title_height == -1)
@@ -753,7 +784,7 @@ void list::calc_title_height(graphic &gr_)
 
 void list::draw_titles(graphic &gr_)
 {
-    auto font = theme_font(tcn, tv_font, theme_);
+    auto font = text_font;
     auto text_indent = 5;
 
     auto border_width = theme_dimension(tcn, tv_border_width, theme_);
@@ -781,18 +812,26 @@ void list::draw_items(graphic &gr_)
     }
 
     int32_t first_item = -1, item_bottom = 0;
+    int32_t last_item = -1, item_top = 0;
     auto scroll_pos = vert_scroll->get_scroll_pos();
-    while (scroll_pos >= item_bottom && first_item < item_count)
+    if (fixed_item_height > 0)
     {
-        ++first_item;
-        item_bottom = get_item_top(first_item) + get_item_height(first_item);
+        first_item = (std::min)(scroll_pos / fixed_item_height, static_cast<int32_t>(item_count));
+        last_item = (std::min)((scroll_pos + position_.height() + fixed_item_height - 1) / fixed_item_height, static_cast<int32_t>(item_count));
     }
-
-    int32_t last_item = -1, item_top = 0;
-    while (position_.height() > item_top && last_item < item_count)
+    else
     {
-        ++last_item;
-        item_top = get_item_top(last_item) - scroll_pos;
+        while (scroll_pos >= item_bottom && first_item < item_count)
+        {
+            ++first_item;
+            item_bottom = get_item_top(first_item) + get_item_height(first_item);
+        }
+
+        while (position_.height() > item_top && last_item < item_count)
+        {
+            ++last_item;
+            item_top = get_item_top(last_item) - scroll_pos;
+        }
     }
 
     if (last_item < first_item || last_item == first_item)
@@ -838,13 +877,12 @@ bool list::has_scrollbar()
     return scroll_area + position_.height() > position_.height();
 }
 
-void list::update_selected_item(int32_t y)
+int32_t list::find_item(int32_t pos) const
 {
-    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
-
-    auto scroll_pos = vert_scroll->get_scroll_pos();
-
-    auto pos = (y - position().top - title_height - border_width) + scroll_pos;
+    if (fixed_item_height > 0)
+    {
+        return pos >= 0 && pos / fixed_item_height < item_count ? pos / fixed_item_height : static_cast<int32_t>(item_count);
+    }
 
     int32_t item = -1, item_start = 0, item_end = 0;
     while (item != item_count)
@@ -858,11 +896,24 @@ void list::update_selected_item(int32_t y)
             ++item;
         }
         item_start = get_item_top(item);
-        
+
         auto height = get_item_height(item);
         item_end = height != -1 ? item_start + height : 0;
     }
 
+    return item;
+}
+
+void list::update_selected_item(int32_t y)
+{
+    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+
+    auto scroll_pos = vert_scroll->get_scroll_pos();
+
+    auto pos = (y - position().top - title_height - border_width) + scroll_pos;
+
+    auto item = find_item(pos);
+
     if (item != selected_item_)
     {
         int32_t old_selected = selected_item_;
@@ -889,24 +940,7 @@ void list::update_active_item(int32_t y)
 
     auto pos = (y - position().top - title_height - border_width) + scroll_pos;
 
-    active_item_ = -1;
-
-    int32_t item_start = 0, item_end = 0;
-    while (active_item_ != item_count)
-    {
-        if (item_start <= pos && item_end > pos)
-        {
-            break;
-        }
-        else
-        {
-            ++active_item_;
-        }
-        item_start = get_item_top(active_item_);
-
-        auto height = get_item_height(active_item_);
-        item_end = height != -1 ? item_start + height : 0;
-    }
+    active_item_ = find_item(pos);
    
     if (prev_active_item_ != active_item_)
     {
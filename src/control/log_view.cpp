@@ -0,0 +1,809 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/control/log_view.hpp>
+
+#include <wui/window/window.hpp>
+
+#include <wui/theme/theme.hpp>
+
+#include <wui/system/tools.hpp>
+
+#include <wui/common/flag_helpers.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace wui
+{
+
+static const int32_t text_indent = 5;
+static const int32_t row_indent = 2;
+
+log_view::log_view(size_t lines_capacity, size_t arena_size, std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
+    : tcn(theme_control_name_),
+    theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)),
+    position_(),
+    parent_(),
+    my_control_sid(), my_plain_sid(),
+    async_parent_mutex(),
+    async_parent(),
+    showed_(true), enabled_(true), focused_(false), mouse_on_control(false), mouse_on_slider(false),
+    lines_mutex(),
+    lines(lines_capacity),
+    head(0), count(0),
+    total(0),
+    arena(arena_size),
+    write_pos(0),
+    clear_epoch(0),
+    follow_tail_(true), severity_coloring_(true),
+    top_line(0),
+    repaint_requested(false),
+    front(), back(),
+    buffer_width(0), buffer_height(0),
+    buffer_valid(false),
+    rendered_top(0), rendered_end(0), rendered_epoch(0),
+    row_height(0),
+    scroll_area(0),
+    updating_scroll(false),
+    vert_scroll(std::make_shared<scroll>(0, 0, orientation::vertical, std::bind(&log_view::on_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__))
+{
+}
+
+log_view::~log_view()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(shared_from_this());
+    }
+}
+
+void log_view::draw(graphic &gr, const rect &)
+{
+    if (!showed_ || position_.is_null())
+    {
+        return;
+    }
+
+    repaint_requested = false;
+
+    auto control_pos = position();
+
+    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+
+    system_context ctx = { 0 };
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+#ifdef _WIN32
+        ctx = parent__->context();
+#elif __linux__
+        ctx = { parent__->context().display, parent__->context().connection, parent__->context().screen, gr.drawable() };
+#endif
+    }
+
+    if (update_buffers(ctx, position_.width() - border_width * 2, position_.height() - border_width * 2))
+    {
+        render();
+        update_scroll();
+
+        gr.draw_graphic({ control_pos.left + border_width,
+                control_pos.top + border_width,
+                buffer_width,
+                buffer_height },
+            *front, 0, 0);
+    }
+
+    if ((mouse_on_control || focused_) && has_scrollbar())
+    {
+        vert_scroll->draw(gr, {});
+    }
+
+    gr.draw_rect(control_pos,
+        !focused_ ? theme_color(tcn, tv_border, theme_) : theme_color(tcn, tv_focused_border, theme_),
+        make_color(0, 0, 0, 255),
+        border_width,
+        theme_dimension(tcn, tv_round, theme_));
+}
+
+bool log_view::update_buffers(system_context &ctx, int32_t width, int32_t height)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return false;
+    }
+
+    if (!front || buffer_width != width || buffer_height != height)
+    {
+        auto background = theme_color(tcn, tv_background, theme_);
+
+        front.reset(new graphic(ctx));
+        back.reset(new graphic(ctx));
+        if (!front->init_image({ 0, 0, width, height }, background) || !back->init_image({ 0, 0, width, height }, background))
+        {
+            front.reset();
+            back.reset();
+            return false;
+        }
+
+        buffer_width = width;
+        buffer_height = height;
+        buffer_valid = false;
+    }
+
+    if (row_height == 0)
+    {
+        row_height = front->measure_text("Qq", text_font).height() + row_indent * 2;
+        if (row_height <= 0)
+        {
+            row_height = 1;
+        }
+        buffer_valid = false;
+    }
+
+    return true;
+}
+
+void log_view::render()
+{
+    auto background = theme_color(tcn, tv_background, theme_);
+    uint64_t rows = (buffer_height + row_height - 1) / row_height;
+
+    std::lock_guard<std::mutex> lock(lines_mutex);
+
+    auto top = visible_top();
+    auto end = (std::min)(total, top + rows);
+
+    if (buffer_valid && rendered_epoch == clear_epoch && top >= rendered_top && top - rendered_top < rows)
+    {
+        /// The drawn rows are moved up, the new rows are drawn in the freed space
+        auto shift = static_cast<int32_t>(top - rendered_top) * row_height;
+        if (shift != 0)
+        {
+            back->draw_graphic({ 0, 0, buffer_width, buffer_height - shift }, *front, 0, shift);
+            back->draw_rect({ 0, buffer_height - shift, buffer_width, buffer_height }, background);
+            std::swap(front, back);
+        }
+
+        draw_rows(*front, (std::max)(rendered_end, top), end, top);
+    }
+    else
+    {
+        front->draw_rect({ 0, 0, buffer_width, buffer_height }, background);
+
+        draw_rows(*front, top, end, top);
+    }
+
+    buffer_valid = true;
+    rendered_top = top;
+    rendered_end = end;
+    rendered_epoch = clear_epoch;
+}
+
+void log_view::draw_rows(graphic &gr_, uint64_t from, uint64_t to, uint64_t top)
+{
+    if (from >= to)
+    {
+        return;
+    }
+
+    auto font = text_font;
+
+    color colors[] = { theme_color(tcn, tv_debug_text, theme_),
+        theme_color(tcn, tv_text, theme_),
+        theme_color(tcn, tv_warning_text, theme_),
+        theme_color(tcn, tv_error_text, theme_) };
+
+    auto oldest = total - count;
+
+    for (auto n = from; n != to; ++n)
+    {
+        auto &l = lines[(head + static_cast<size_t>(n - oldest)) % lines.size()];
+
+        gr_.draw_text({ text_indent, static_cast<int32_t>(n - top) * row_height + row_indent, 0, 0 },
+            std::string_view(arena.data() + l.offset, l.size),
+            colors[severity_coloring_ ? static_cast<int32_t>(l.severity_) : static_cast<int32_t>(severity::info)],
+            font);
+    }
+}
+
+void log_view::receive_control_events(const event &ev)
+{
+    if (!showed_ || !enabled_)
+    {
+        return;
+    }
+
+    if (ev.type == event_type::mouse)
+    {
+        if (has_scrollbar())
+        {
+            if (vert_scroll->position().in(ev.mouse_event_.x, ev.mouse_event_.y))
+            {
+                if (!mouse_on_slider)
+                {
+                    mouse_on_slider = true;
+
+                    event sev = ev;
+                    sev.mouse_event_.type = wui::mouse_event_type::enter;
+
+                    return vert_scroll->receive_control_events(sev);
+                }
+
+                return vert_scroll->receive_control_events(ev);
+            }
+            else
+            {
+                if (mouse_on_slider)
+                {
+                    mouse_on_slider = false;
+
+                    event sev = ev;
+                    sev.mouse_event_.type = wui::mouse_event_type::leave;
+
+                    return vert_scroll->receive_control_events(sev);
+                }
+            }
+        }
+
+        switch (ev.mouse_event_.type)
+        {
+            case mouse_event_type::enter:
+                if (has_scrollbar())
+                {
+                    vert_scroll->show();
+                }
+                mouse_on_control = true;
+                redraw();
+            break;
+            case mouse_event_type::leave:
+                mouse_on_control = false;
+                mouse_on_slider = false;
+                redraw();
+            break;
+            case mouse_event_type::wheel:
+                if (ev.mouse_event_.wheel_delta > 0)
+                {
+                    vert_scroll->scroll_up();
+                }
+                else
+                {
+                    vert_scroll->scroll_down();
+                }
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::keyboard)
+    {
+        if (ev.keyboard_event_.type != keyboard_event_type::down)
+        {
+            return;
+        }
+
+        uint64_t top = 0, oldest = 0;
+        {
+            std::lock_guard<std::mutex> lock(lines_mutex);
+            top = visible_top();
+            oldest = total - count;
+        }
+        uint64_t page = rows_fit();
+
+        switch (ev.keyboard_event_.key[0])
+        {
+            case vk_home: case vk_nhome:
+                scroll_to(oldest);
+            break;
+            case vk_end: case vk_nend:
+                set_follow_tail(true);
+            break;
+            case vk_up: case vk_nup:
+                scroll_to(top > oldest ? top - 1 : oldest);
+            break;
+            case vk_down: case vk_ndown:
+                scroll_to(top + 1);
+            break;
+            case vk_page_up: case vk_npage_up:
+                scroll_to(top > oldest + page ? top - page : oldest);
+            break;
+            case vk_page_down: case vk_npage_down:
+                scroll_to(top + page);
+            break;
+        }
+    }
+    else if (ev.type == event_type::internal)
+    {
+        switch (ev.internal_event_.type)
+        {
+            case internal_event_type::set_focus:
+                focused_ = true;
+
+                if (has_scrollbar())
+                {
+                    vert_scroll->show();
+                }
+
+                redraw();
+            break;
+            case internal_event_type::remove_focus:
+                focused_ = false;
+
+                vert_scroll->hide();
+
+                redraw();
+            break;
+            default: break;
+        }
+    }
+}
+
+void log_view::set_position(const rect &position__, bool redraw)
+{
+    update_control_position(position_, position__, showed_ && redraw, parent_);
+
+    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+
+    vert_scroll->set_position({ position_.right - 14 - border_width,
+        position_.top + border_width,
+        position_.right - border_width,
+        position_.bottom - border_width });
+}
+
+rect log_view::position() const
+{
+    return get_control_position(position_, parent_);
+}
+
+void log_view::set_parent(std::shared_ptr<window> window)
+{
+    parent_ = window;
+
+    my_control_sid = window->subscribe(std::bind(&log_view::receive_control_events, this, std::placeholders::_1),
+        wui::flags_map<wui::event_type>(3, wui::event_type::internal, wui::event_type::mouse, wui::event_type::keyboard),
+        shared_from_this());
+    my_plain_sid = window->subscribe(std::bind(&log_view::receive_plain_events, this, std::placeholders::_1), event_type::internal);
+
+    {
+        std::lock_guard<std::mutex> lock(async_parent_mutex);
+        async_parent = window;
+    }
+
+    window->add_control(vert_scroll, { 0 });
+}
+
+std::weak_ptr<window> log_view::parent() const
+{
+    return parent_;
+}
+
+void log_view::clear_parent()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(vert_scroll);
+
+        parent__->unsubscribe(my_control_sid);
+        my_control_sid.clear();
+        parent__->unsubscribe(my_plain_sid);
+        my_plain_sid.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(async_parent_mutex);
+        async_parent.reset();
+    }
+
+    parent_.reset();
+}
+
+void log_view::set_topmost(bool)
+{
+}
+
+bool log_view::topmost() const
+{
+    return false;
+}
+
+bool log_view::focused() const
+{
+    return enabled_ && showed_ && focused_;
+}
+
+bool log_view::focusing() const
+{
+    return enabled_ && showed_;
+}
+
+error log_view::get_error() const
+{
+    return front ? front->get_error() : error{};
+}
+
+void log_view::update_theme_control_name(std::string_view theme_control_name)
+{
+    tcn = theme_control_name;
+    update_theme(theme_);
+}
+
+std::string_view log_view::theme_control_name() const
+{
+    return tcn;
+}
+
+void log_view::update_theme(std::shared_ptr<i_theme> theme__)
+{
+    if (theme_ && !theme__)
+    {
+        return;
+    }
+    theme_ = theme__;
+
+    text_font = theme_font_handle(tcn, tv_font, theme_);
+
+    /// The font can be changed, so the row height is measured again and all the rows are redrawn
+    row_height = 0;
+    buffer_valid = false;
+
+    vert_scroll->update_theme(theme_);
+
+    redraw();
+}
+
+void log_view::show()
+{
+    if (!showed_)
+    {
+        showed_ = true;
+        buffer_valid = false;
+
+        redraw();
+    }
+}
+
+void log_view::hide()
+{
+    if (showed_)
+    {
+        showed_ = false;
+
+        vert_scroll->hide();
+
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position(), true);
+        }
+    }
+}
+
+bool log_view::showed() const
+{
+    return showed_;
+}
+
+void log_view::enable()
+{
+    enabled_ = true;
+    redraw();
+}
+
+void log_view::disable()
+{
+    enabled_ = false;
+    redraw();
+}
+
+bool log_view::enabled() const
+{
+    return enabled_;
+}
+
+void log_view::append(std::string_view text, severity severity_)
+{
+    if (!text.empty() && text.back() == '\n')
+    {
+        text.remove_suffix(1);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+
+        size_t start = 0;
+        while (true)
+        {
+            auto end = text.find('\n', start);
+
+            auto line_ = text.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+            if (!line_.empty() && line_.back() == '\r')
+            {
+                line_.remove_suffix(1);
+            }
+
+            push_line(line_, severity_);
+
+            if (end == std::string_view::npos)
+            {
+                break;
+            }
+            start = end + 1;
+        }
+    }
+
+    /// The appends made before the paint are drawn together. The repaint is posted, because the control's position
+    /// and parent are used by the UI thread only
+    if (!repaint_requested.exchange(true))
+    {
+        post_redraw();
+    }
+}
+
+void log_view::push_line(std::string_view text, severity severity_)
+{
+    if (lines.empty() || arena.empty())
+    {
+        return;
+    }
+
+    auto size = (std::min)(text.size(), arena.size());
+    auto used = (std::max)(size, static_cast<size_t>(1)); /// the empty line takes a byte too, so the full arena is distinguished
+
+    if (count == lines.size())
+    {
+        drop_oldest();
+    }
+
+    /// The text is not split at the arena's end, the rest of the arena is skipped
+    while (true)
+    {
+        if (count == 0)
+        {
+            write_pos = 0;
+            break;
+        }
+
+        auto tail = lines[head].offset;
+        if (write_pos > tail)
+        {
+            if (used <= arena.size() - write_pos)
+            {
+                break;
+            }
+            write_pos = 0;
+        }
+        else if (write_pos < tail && used <= tail - write_pos)
+        {
+            break;
+        }
+        else
+        {
+            drop_oldest();
+        }
+    }
+
+    memcpy(arena.data() + write_pos, text.data(), size);
+
+    lines[(head + count) % lines.size()] = { static_cast<uint32_t>(write_pos), static_cast<uint32_t>(size), severity_ };
+    ++count;
+    ++total;
+
+    write_pos += used;
+}
+
+void log_view::drop_oldest()
+{
+    head = (head + 1) % lines.size();
+    --count;
+}
+
+void log_view::clear()
+{
+    {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+
+        head = 0;
+        count = 0;
+        write_pos = 0;
+        top_line = total;
+        ++clear_epoch;
+    }
+
+    if (!repaint_requested.exchange(true))
+    {
+        post_redraw();
+    }
+}
+
+size_t log_view::lines_count() const
+{
+    std::lock_guard<std::mutex> lock(lines_mutex);
+    return count;
+}
+
+std::string log_view::line(size_t n) const
+{
+    std::lock_guard<std::mutex> lock(lines_mutex);
+
+    if (n >= count)
+    {
+        return "";
+    }
+
+    auto &l = lines[(head + n) % lines.size()];
+    return std::string(arena.data() + l.offset, l.size);
+}
+
+void log_view::set_follow_tail(bool yes)
+{
+    {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+        if (follow_tail_ == yes)
+        {
+            return;
+        }
+
+        if (!yes)
+        {
+            top_line = visible_top();
+        }
+        follow_tail_ = yes;
+    }
+
+    redraw();
+}
+
+bool log_view::follow_tail() const
+{
+    std::lock_guard<std::mutex> lock(lines_mutex);
+    return follow_tail_;
+}
+
+void log_view::set_severity_coloring(bool yes)
+{
+    {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+        severity_coloring_ = yes;
+    }
+
+    buffer_valid = false;
+    redraw();
+}
+
+bool log_view::severity_coloring() const
+{
+    std::lock_guard<std::mutex> lock(lines_mutex);
+    return severity_coloring_;
+}
+
+int32_t log_view::rows_fit() const
+{
+    if (row_height <= 0)
+    {
+        return 1;
+    }
+    return (std::max)(buffer_height / row_height, 1);
+}
+
+uint64_t log_view::visible_top() const
+{
+    auto oldest = total - count;
+
+    auto top = top_line;
+    if (follow_tail_)
+    {
+        uint64_t fit = rows_fit();
+        top = total > fit ? total - fit : 0;
+    }
+
+    return (std::max)(top, oldest);
+}
+
+void log_view::scroll_to(uint64_t line_)
+{
+    {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+
+        uint64_t fit = rows_fit();
+        auto end = total > fit ? total - fit : 0;
+
+        follow_tail_ = line_ >= end;
+        top_line = (std::min)(line_, end);
+    }
+
+    redraw();
+}
+
+void log_view::update_scroll()
+{
+    int32_t area = 0, pos = 0;
+    {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+
+        size_t fit = rows_fit();
+        area = count > fit ? static_cast<int32_t>(count - fit) * row_height : 0;
+        pos = static_cast<int32_t>(visible_top() - (total - count)) * row_height;
+    }
+
+    /// The scroll's callback is not needed for the positions set by the view
+    updating_scroll = true;
+
+    if (area != scroll_area)
+    {
+        scroll_area = area;
+        vert_scroll->set_area(area);
+    }
+    if (pos != vert_scroll->get_scroll_pos())
+    {
+        vert_scroll->set_scroll_pos(pos);
+    }
+
+    updating_scroll = false;
+}
+
+void log_view::on_scroll(scroll_state ss, int32_t scroll_pos)
+{
+    if (updating_scroll || row_height <= 0)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(lines_mutex);
+
+        top_line = total - count + scroll_pos / row_height;
+        follow_tail_ = ss == scroll_state::down_end || scroll_pos >= scroll_area;
+    }
+
+    redraw();
+}
+
+bool log_view::has_scrollbar()
+{
+    return scroll_area > 0;
+}
+
+void log_view::post_redraw()
+{
+    std::shared_ptr<window> parent__;
+    {
+        std::lock_guard<std::mutex> lock(async_parent_mutex);
+        parent__ = async_parent.lock();
+    }
+
+    if (parent__)
+    {
+        parent__->emit_event(repaint_event_id, 0);
+    }
+}
+
+void log_view::receive_plain_events(const event &ev)
+{
+    if (ev.type == event_type::internal && ev.internal_event_.type == internal_event_type::user_emitted && ev.internal_event_.x == repaint_event_id &&
+        repaint_requested)
+    {
+        redraw();
+    }
+}
+
+void log_view::redraw()
+{
+    if (showed_)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position());
+        }
+    }
+}
+
+}
@@ -15,6 +15,7 @@
 #include <wui/control/list.hpp>
 
 #include <wui/theme/theme.hpp>
+#include <wui/theme/theme_overlay.hpp>
 
 #include <wui/system/tools.hpp>
 #include <wui/common/flag_helpers.hpp>
@@ -24,61 +25,20 @@
 namespace wui
 {
 
-int32_t calc_items_count(const menu_items_t &items)
-{
-    int32_t count = 0;
-    for (auto &item : items)
-    {
-        ++count;
-        if (!item.children.empty() && item.state == menu_item_state::expanded)
-        {
-            count += calc_items_count(item.children);
-        }
-    }
-    return count;
-}
-
-menu_item *get_item(menu_items_t &items, int32_t n_item, int32_t pos = 0, int32_t level = 0)
-{
-    int32_t count = pos;
-    for (auto &item : items)
-    {
-        if (count == n_item)
-        {
-            item.level = level;
-            return &item;
-        }
-
-        if (!item.children.empty() && item.state == menu_item_state::expanded)
-        {
-            auto children_count = calc_items_count(item.children);
-            if (n_item <= count + children_count)
-            {
-                return get_item(item.children, n_item - 1, count, level + 1);
-            }
-            else
-            {
-                count += children_count;
-            }
-        }
-
-        ++count;
-    }
-
-    return nullptr;
-}
-
 menu::menu(std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
-    : list_theme(make_custom_theme()),
+    : list_theme(std::make_shared<theme_overlay>(theme__)),
     list_(std::make_shared<list>(list::tc, list_theme)),
     tcn(theme_control_name),
     theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)),
     position_(),
     parent_(),
     my_subscriber_id(),
     activation_control(),
     indent(0), x(-1), y(-1),
     items(),
+    items_by_id(),
+    rows(), subtree_rows(),
     max_text_width(0), max_hotkey_width(0),
     item_height_(32),
     showed_(false),
@@ -149,7 +109,7 @@ void menu::clear_parent()
 
 void menu::update_list_theme()
 {
-    list_theme->load_theme(theme_ ? *theme_ : *get_default_theme());
+    list_theme->set_parent(theme_);
 
     list_theme->set_color(list::tc, list::tv_background, theme_color(tcn, tv_background, theme_));
     list_theme->set_color(list::tc, list::tv_border, theme_color(tcn, tv_border, theme_));
@@ -221,6 +181,11 @@ void menu::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view menu::theme_control_name() const
+{
+    return tcn;
+}
+
 void menu::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -229,6 +194,8 @@ void menu::update_theme(std::shared_ptr<i_theme> theme__)
     }
     theme_ = theme__;
 
+    text_font = theme_font_handle(tcn, tv_font, theme_);
+
     update_list_theme();
 
     size_updated = false;
@@ -274,43 +241,240 @@ bool menu::enabled() const
 void menu::set_items(const menu_items_t &items_)
 {
     items = items_;
-    list_->set_item_count(calc_items_count(items));
+
+    items_by_id.clear();
+    index_items(items, nullptr);
+
+    update_rows();
     size_updated = false;
 }
 
 void menu::update_item(const menu_item &mi)
 {
-    auto it = std::find(items.begin(), items.end(), mi.id);
-    if (it != items.end())
+    auto it = items_by_id.find(mi.id);
+    if (it == items_by_id.end())
+    {
+        return;
+    }
+
+    auto node = it->second;
+    auto level = node.item->level, row_ = node.item->row;
+
+    /// The rows of the old children are found before they are freed
+    auto row = find_row(node.item);
+    auto end = row != -1 ? subtree_end(row) : -1;
+
+    unindex_items(node.item->children);
+    *node.item = mi;
+    node.item->level = level;
+    node.item->row = row_;
+    index_items(node.item->children, node.item);
+
+    if (row != -1)
     {
-        *it = mi;
+        update_subtree_rows(row, end);
+        renumber_rows(row + 1);
+        list_->set_item_count(static_cast<int32_t>(rows.size()));
     }
-    list_->set_item_count(calc_items_count(items));
+    size_updated = false;
 }
 
 void menu::swap_items(int32_t first_item_id, int32_t second_item_id)
 {
-    auto first_it = std::find(items.begin(), items.end(), first_item_id);
-    if (first_it != items.end())
+    auto first_it = items_by_id.find(first_item_id), second_it = items_by_id.find(second_item_id);
+    if (first_it == items_by_id.end() || second_it == items_by_id.end() || first_item_id == second_item_id ||
+        is_ancestor(first_it->second.item, second_item_id) || is_ancestor(second_it->second.item, first_item_id))
+    {
+        return;
+    }
+
+    auto first = first_it->second, second = second_it->second;
+
+    /// The later row is updated first to keep the index of the earlier one
+    auto first_row = find_row(first.item), second_row = find_row(second.item);
+    if (first_row > second_row)
+    {
+        std::swap(first_row, second_row);
+    }
+    auto first_end = first_row != -1 ? subtree_end(first_row) : -1, second_end = second_row != -1 ? subtree_end(second_row) : -1;
+
+    /// The items exchange the places, their children vectors are moved with them, the level and the row are the place's
+    std::swap(*first.item, *second.item);
+    std::swap(first.item->level, second.item->level);
+    std::swap(first.item->row, second.item->row);
+
+    items_by_id[first.item->id] = first;
+    items_by_id[second.item->id] = second;
+    for (auto &child : first.item->children)
+    {
+        items_by_id[child.id].parent = first.item;
+    }
+    for (auto &child : second.item->children)
+    {
+        items_by_id[child.id].parent = second.item;
+    }
+
+    if (second_row != -1)
+    {
+        update_subtree_rows(second_row, second_end);
+    }
+    if (first_row != -1)
+    {
+        update_subtree_rows(first_row, first_end);
+    }
+    if (second_row != -1)
+    {
+        renumber_rows(first_row != -1 ? first_row + 1 : second_row + 1);
+    }
+    list_->set_item_count(static_cast<int32_t>(rows.size()));
+    size_updated = false;
+}
+
+void menu::delete_item(int32_t id)
+{
+    auto it = items_by_id.find(id);
+    if (it == items_by_id.end())
+    {
+        return;
+    }
+
+    auto node = it->second;
+    auto &siblings = node.parent ? node.parent->children : items;
+    auto pos = node.item - siblings.data();
+
+    /// The item's rows are removed, the rows of the next siblings will point to the shifted places
+    auto row = find_row(node.item);
+    if (row != -1)
+    {
+        auto level = node.item->level;
+
+        rows.erase(rows.begin() + row, rows.begin() + subtree_end(row));
+        for (auto i = static_cast<size_t>(row); i < rows.size() && rows[i]->level >= level; ++i)
+        {
+            if (rows[i]->level == level)
+            {
+                --rows[i];
+            }
+        }
+    }
+
+    unindex_items(node.item->children);
+    items_by_id.erase(it);
+
+    siblings.erase(siblings.begin() + pos);
+
+    /// The next siblings are shifted, their children keep the places
+    for (auto i = static_cast<size_t>(pos); i < siblings.size(); ++i)
+    {
+        items_by_id[siblings[i].id] = item_node{ &siblings[i], node.parent };
+        for (auto &child : siblings[i].children)
+        {
+            items_by_id[child.id].parent = &siblings[i];
+        }
+    }
+
+    /// The rows are renumbered after the siblings are shifted to their places
+    if (row != -1)
+    {
+        renumber_rows(row);
+    }
+    list_->set_item_count(static_cast<int32_t>(rows.size()));
+    size_updated = false;
+}
+
+void menu::index_items(menu_items_t &items_, menu_item *parent)
+{
+    for (auto &item : items_)
     {
-        auto second_it = std::find(items.begin(), items.end(), second_item_id);
-        if (second_it != items.end())
+        items_by_id[item.id] = item_node{ &item, parent };
+        index_items(item.children, &item);
+    }
+}
+
+void menu::unindex_items(const menu_items_t &items_)
+{
+    for (auto &item : items_)
+    {
+        items_by_id.erase(item.id);
+        unindex_items(item.children);
+    }
+}
+
+void menu::append_rows(std::vector<menu_item*> &out, menu_items_t &items_, int32_t level)
+{
+    for (auto &item : items_)
+    {
+        item.level = level;
+        out.emplace_back(&item);
+
+        if (!item.children.empty() && item.state == menu_item_state::expanded)
         {
-            std::swap(*first_it, *second_it);
+            append_rows(out, item.children, level + 1);
         }
     }
-    list_->set_item_count(calc_items_count(items));
 }
 
-void menu::delete_item(int32_t id)
+void menu::update_rows()
+{
+    rows.clear();
+    append_rows(rows, items, 0);
+    renumber_rows(0);
+
+    list_->set_item_count(static_cast<int32_t>(rows.size()));
+}
+
+int32_t menu::find_row(const menu_item *item) const
 {
-    auto it = std::find(items.begin(), items.end(), id);
-    if (it != items.end())
+    /// The row of the hidden item is left from the time it was shown, so it is checked
+    auto row = item->row;
+    return row >= 0 && row < static_cast<int32_t>(rows.size()) && rows[row] == item ? row : -1;
+}
+
+int32_t menu::subtree_end(int32_t row) const
+{
+    /// The visible descendants are the next rows of the deeper level
+    auto end = row + 1;
+    while (end < static_cast<int32_t>(rows.size()) && rows[end]->level > rows[row]->level)
     {
-        items.erase(it);
-        size_updated = false;
+        ++end;
+    }
+    return end;
+}
+
+void menu::update_subtree_rows(int32_t row, int32_t end)
+{
+    auto item = rows[row];
+
+    subtree_rows.clear();
+    if (!item->children.empty() && item->state == menu_item_state::expanded)
+    {
+        append_rows(subtree_rows, item->children, item->level + 1);
+    }
+
+    rows.erase(rows.begin() + row + 1, rows.begin() + end);
+    rows.insert(rows.begin() + row + 1, subtree_rows.begin(), subtree_rows.end());
+}
+
+void menu::renumber_rows(int32_t from)
+{
+    for (auto i = from; i < static_cast<int32_t>(rows.size()); ++i)
+    {
+        rows[i]->row = i;
     }
-    list_->set_item_count(calc_items_count(items));
+}
+
+bool menu::is_ancestor(const menu_item *ancestor, int32_t id) const
+{
+    auto it = items_by_id.find(id);
+    while (it != items_by_id.end() && it->second.parent)
+    {
+        if (it->second.parent == ancestor)
+        {
+            return true;
+        }
+        it = items_by_id.find(it->second.parent->id);
+    }
+    return false;
 }
 
 void menu::set_item_height(int32_t item_height__)
@@ -347,19 +511,13 @@ void menu::update_size()
     graphic mem_gr(ctx);
     mem_gr.init({ 0, 0, 1920, 1080 }, 0);
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = text_font;
 
     max_text_width = 0, max_hotkey_width = 0;
 
-    auto items_count = calc_items_count(items);
-    for (int i = 0; i != items_count; ++i)
+    auto items_count = static_cast<int32_t>(rows.size());
+    for (auto *item : rows)
     {
-        auto *item = get_item(items, i);
-        if (!item)
-        {
-            continue;
-        }
-
         auto text_width = mem_gr.measure_text(item->text, font_).right;
         auto hotkey_width = mem_gr.measure_text(item->hotkey, font_).right;
         if (hotkey_width != 0)
@@ -448,11 +606,11 @@ void menu::draw_arrow_down(graphic &gr, rect pos, bool expanded)
 
 void menu::draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect, list::item_state state)
 {
-    auto item = get_item(items, n_item);
-    if (!item)
+    if (n_item < 0 || n_item >= static_cast<int32_t>(rows.size()))
     {
         return;
     }
+    auto item = rows[n_item];
 
     auto border_width = theme_dimension(tcn, tv_border_width);
 
@@ -477,7 +635,7 @@ void menu::draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect, li
     }
 
     auto text_color = item->state != menu_item_state::disabled ? theme_color(tcn, tv_text) : theme_color(tcn, tv_disabled_text);
-    auto font = theme_font(tcn, tv_font);
+    auto font = text_font;
 
     auto text_height = gr.measure_text("Qq", font).height();
     
@@ -506,11 +664,11 @@ void menu::draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect, li
 
 void menu::activate_list_item(int32_t n_item)
 {
-    auto item = get_item(items, n_item);
-    if (!item)
+    if (n_item < 0 || n_item >= static_cast<int32_t>(rows.size()))
     {
         return;
     }
+    auto item = rows[n_item];
 
     if (!item->children.empty())
     {
@@ -518,13 +676,18 @@ void menu::activate_list_item(int32_t n_item)
         {
             item->prev_state = item->state;
             item->state = menu_item_state::expanded;
+
+            update_subtree_rows(n_item, n_item + 1);
         }
         else
         {
             item->state = item->prev_state;
+
+            update_subtree_rows(n_item, subtree_end(n_item));
         }
+        renumber_rows(n_item + 1);
         size_updated = false;
-        list_->set_item_count(calc_items_count(items));
+        list_->set_item_count(static_cast<int32_t>(rows.size()));
         show_on_control(activation_control, indent, x, y);
     }
     
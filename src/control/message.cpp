@@ -63,16 +63,16 @@ void message::show(std::string_view message_,
     switch (icon_)
     {
         case message_icon::alert:
-            icon->change_image(theme_image("message_alert", theme_));
+            icon->change_theme_image("message_alert", theme_);
         break;
         case message_icon::information:
-            icon->change_image(theme_image("message_info", theme_));
+            icon->change_theme_image("message_info", theme_);
         break;
         case message_icon::question:
-            icon->change_image(theme_image("message_question", theme_));
+            icon->change_theme_image("message_question", theme_);
         break;
         case message_icon::stop:
-            icon->change_image(theme_image("message_stop", theme_));
+            icon->change_theme_image("message_stop", theme_);
         break;
     }
 
@@ -268,7 +268,7 @@ rect message::get_text_size()
     graphic mem_gr(ctx);
     mem_gr.init(transient_window_->position(), 0);
 
-    auto text_size = mem_gr.measure_text(max_line, theme_font(text::tc, text::tv_font, theme_));
+    auto text_size = mem_gr.measure_text(max_line, theme_font_handle(text::tc, text::tv_font, theme_));
 
     return { 0, 0, text_size.width(), static_cast<int32_t>(text_size.height() * 1.2 * lines_count) };
 }
@@ -118,6 +118,11 @@ void panel::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view panel::theme_control_name() const
+{
+    return tcn;
+}
+
 void panel::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -139,6 +139,11 @@ void progress::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view progress::theme_control_name() const
+{
+    return tcn;
+}
+
 void progress::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -169,6 +169,11 @@ void scroll::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view scroll::theme_control_name() const
+{
+    return tcn;
+}
+
 void scroll::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
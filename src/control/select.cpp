@@ -14,6 +14,7 @@
 #include <wui/window/window.hpp>
 
 #include <wui/theme/theme.hpp>
+#include <wui/theme/theme_overlay.hpp>
 
 #include <wui/system/tools.hpp>
 
@@ -29,15 +30,44 @@ namespace wui
 
 static const int32_t select_horizontal_indent = 5;
 
+/// The typed characters are appended to the search prefix until the pause
+static const std::chrono::milliseconds type_ahead_pause(1000);
+
+static inline char fold_char(char c)
+{
+    return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+/// Compare the texts case folded for ASCII only, the other bytes are compared as is
+static int32_t compare_folded(std::string_view first, std::string_view second)
+{
+    auto size = (std::min)(first.size(), second.size());
+    for (size_t i = 0; i != size; ++i)
+    {
+        auto a = static_cast<uint8_t>(fold_char(first[i])), b = static_cast<uint8_t>(fold_char(second[i]));
+        if (a != b)
+        {
+            return a < b ? -1 : 1;
+        }
+    }
+    return first.size() == second.size() ? 0 : (first.size() < second.size() ? -1 : 1);
+}
+
 select::select(std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
     : items_(),
+    numbers_by_id(),
+    text_order(),
+    max_visible_items(0),
+    typed_prefix(),
+    last_typed(),
     change_callback(),
     tcn(theme_control_name),
     theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)),
     position_(),
     parent_(),
     my_control_sid(), my_plain_sid(),
-    list_theme(make_custom_theme()),
+    list_theme(std::make_shared<theme_overlay>(theme__)),
     list_(std::make_shared<list>(list::tc, list_theme)),
     showed_(true), enabled_(true), active(false), topmost_(false),
     focused_(false),
@@ -90,7 +120,7 @@ void select::draw(graphic &gr, const rect &)
     draw_arrow_down(gr, { control_pos.right - static_cast<int32_t>(control_pos.height() / 1.5),
             control_pos.top + static_cast<int32_t>(control_pos.height() / 2.1)});
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = text_font;
 
     if (static_cast<int32_t>(items_.size()) <= list_->selected_item())
     {
@@ -146,7 +176,13 @@ void select::select_down()
 
 void select::show_list()
 {
-    list_->set_position({ position_.left, position_.top, position_.right, position_.top + item_height_ * static_cast<int32_t>(items_.size()) });
+    auto visible_items = static_cast<int32_t>(items_.size());
+    if (max_visible_items > 0 && visible_items > max_visible_items)
+    {
+        visible_items = max_visible_items;
+    }
+
+    list_->set_position({ position_.left, position_.top, position_.right, position_.top + item_height_ * visible_items });
     auto pos = get_popup_position(parent_, position(), list_->position(), 0);
 
     list_->set_position(pos, true);
@@ -230,6 +266,9 @@ void select::receive_control_events(const event &ev)
                     break;
                 }
             break;
+            case keyboard_event_type::key:
+                type_ahead(ev.keyboard_event_);
+            break;
         }
     }
     else if (ev.type == event_type::internal)
@@ -277,13 +316,17 @@ void select::receive_plain_events(const event &ev)
                 list_->hide();
             }
         }
+        else if (ev.keyboard_event_.type == keyboard_event_type::key)
+        {
+            type_ahead(ev.keyboard_event_);
+        }
         break;
     }
 }
 
 void select::update_list_theme()
 {
-    list_theme->load_theme(theme_ ? *theme_ : *get_default_theme());
+    list_theme->set_parent(theme_);
 
     list_theme->set_color(list::tc, list::tv_background, theme_color(tcn, tv_background, theme_));
     list_theme->set_color(list::tc, list::tv_border, theme_color(tcn, tv_border, theme_));
@@ -375,6 +418,11 @@ void select::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view select::theme_control_name() const
+{
+    return tcn;
+}
+
 void select::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -383,6 +431,8 @@ void select::update_theme(std::shared_ptr<i_theme> theme__)
     }
     theme_ = theme__;
 
+    text_font = theme_font_handle(tcn, tv_font, theme_);
+
     update_list_theme();
 }
 
@@ -427,43 +477,134 @@ bool select::enabled() const
 void select::set_items(const select_items_t &items__)
 {
     items_ = items__;
+
+    numbers_by_id.clear();
+    numbers_by_id.reserve(items_.size());
+    text_order.resize(items_.size());
+    for (int32_t i = 0; i != static_cast<int32_t>(items_.size()); ++i)
+    {
+        numbers_by_id[items_[i].id] = i;
+        text_order[i] = items_[i].id;
+    }
+
+    std::sort(text_order.begin(), text_order.end(), [this](int64_t first, int64_t second) { return text_less(first, second); });
+
     list_->set_item_count(static_cast<int32_t>(items_.size()));
 }
 
 void select::update_item(const select_item &si)
 {
-    auto it = std::find(items_.begin(), items_.end(), si.id);
-    if (it != items_.end())
+    auto it = numbers_by_id.find(si.id);
+    if (it != numbers_by_id.end())
     {
-        *it = si;
+        unindex_text(si.id);
+        items_[it->second] = si;
+        index_text(si.id);
     }
     list_->set_item_count(static_cast<int32_t>(items_.size()));
 }
 
 void select::swap_items(int64_t first_item_id, int64_t second_item_id)
 {
-    auto first_it = std::find(items_.begin(), items_.end(), first_item_id);
-    if (first_it != items_.end())
+    auto first_it = numbers_by_id.find(first_item_id), second_it = numbers_by_id.find(second_item_id);
+    if (first_it != numbers_by_id.end() && second_it != numbers_by_id.end() && first_it != second_it)
     {
-        auto second_it = std::find(items_.begin(), items_.end(), second_item_id);
-        if (second_it != items_.end())
-        {
-            std::swap(*first_it, *second_it);
-        }
+        std::swap(items_[first_it->second], items_[second_it->second]);
+        std::swap(first_it->second, second_it->second);
     }
     list_->set_item_count(static_cast<int32_t>(items_.size()));
 }
 
 void select::delete_item(int64_t id)
 {
-    auto it = std::find(items_.begin(), items_.end(), id);
-    if (it != items_.end())
+    auto it = numbers_by_id.find(id);
+    if (it != numbers_by_id.end())
     {
-        items_.erase(it);
+        auto number = it->second;
+
+        unindex_text(id);
+        numbers_by_id.erase(it);
+
+        items_.erase(items_.begin() + number);
+
+        /// The next items are shifted by one
+        for (auto i = number; i != static_cast<int32_t>(items_.size()); ++i)
+        {
+            numbers_by_id[items_[i].id] = i;
+        }
     }
     list_->set_item_count(static_cast<int32_t>(items_.size()));
 }
 
+const std::string &select::item_text(int64_t id) const
+{
+    return items_[numbers_by_id.find(id)->second].text;
+}
+
+/// The equal texts are ordered by the id
+bool select::text_less(int64_t first, int64_t second) const
+{
+    auto result = compare_folded(item_text(first), item_text(second));
+    return result < 0 || (result == 0 && first < second);
+}
+
+void select::index_text(int64_t id)
+{
+    text_order.insert(std::lower_bound(text_order.begin(), text_order.end(), id,
+        [this](int64_t first, int64_t second) { return text_less(first, second); }), id);
+}
+
+void select::unindex_text(int64_t id)
+{
+    auto it = std::lower_bound(text_order.begin(), text_order.end(), id,
+        [this](int64_t first, int64_t second) { return text_less(first, second); });
+    if (it != text_order.end() && *it == id)
+    {
+        text_order.erase(it);
+    }
+}
+
+int32_t select::find_item(std::string_view prefix) const
+{
+    auto it = std::lower_bound(text_order.begin(), text_order.end(), prefix,
+        [this](int64_t id, std::string_view prefix_) { return compare_folded(item_text(id), prefix_) < 0; });
+
+    if (it == text_order.end() || compare_folded(std::string_view(item_text(*it)).substr(0, prefix.size()), prefix) != 0)
+    {
+        return -1;
+    }
+
+    return numbers_by_id.find(*it)->second;
+}
+
+void select::set_max_visible_items(int32_t count)
+{
+    max_visible_items = count;
+}
+
+void select::type_ahead(const keyboard_event &ev)
+{
+    if (ev.key_size == 0 || static_cast<uint8_t>(ev.key[0]) < 0x20)
+    {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_typed > type_ahead_pause)
+    {
+        typed_prefix.clear();
+    }
+    last_typed = now;
+
+    typed_prefix.append(ev.key, ev.key_size);
+
+    auto number = find_item(typed_prefix);
+    if (number != -1)
+    {
+        select_item_number(number);
+    }
+}
+
 void select::set_item_height(int32_t item_height__)
 {
     item_height_ = item_height__;
@@ -477,13 +618,10 @@ void select::select_item_number(int32_t index)
 
 void select::select_item_id(int64_t id)
 {
-    for (int32_t i = 0; i != static_cast<int32_t>(items_.size()); ++i)
+    auto it = numbers_by_id.find(id);
+    if (it != numbers_by_id.end())
     {
-        if (items_[i].id == id)
-        {
-            select_item_number(i);
-            break;
-        }
+        select_item_number(it->second);
     }
 }
 
@@ -545,7 +683,7 @@ void select::draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect,
     }
 
     auto text_color = theme_color(tcn, tv_text);
-    auto font = theme_font(tcn, tv_font);
+    auto font = text_font;
 
     auto text = items_[n_item].text;
 
@@ -323,6 +323,11 @@ void slider::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view slider::theme_control_name() const
+{
+    return tcn;
+}
+
 void slider::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -218,6 +218,11 @@ void splitter::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view splitter::theme_control_name() const
+{
+    return tcn;
+}
+
 void splitter::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -28,6 +28,7 @@ text::text(std::string_view text__,
     std::shared_ptr<i_theme> theme_)
     : tcn(theme_control_name),
     theme_(theme_),
+    text_font(theme_font_handle(tcn, tv_font, theme_)),
     position_(),
     parent_(),
     showed_(true), topmost_(false),
@@ -54,7 +55,7 @@ void text::draw(graphic &gr, const rect &)
 
     const auto space_coeff = 1.2;
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = text_font;
 
     std::stringstream text__(text_);
     std::string line;
@@ -175,6 +176,11 @@ void text::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view text::theme_control_name() const
+{
+    return tcn;
+}
+
 void text::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -183,6 +189,8 @@ void text::update_theme(std::shared_ptr<i_theme> theme__)
     }
     theme_ = theme__;
 
+    text_font = theme_font_handle(tcn, tv_font, theme_);
+
     redraw();
 }
 
@@ -21,6 +21,7 @@ namespace wui
 tooltip::tooltip(std::string_view text_, std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
     : tcn(theme_control_name),
     theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)),
     position_(),
     parent_(),
     showed_(false),
@@ -52,7 +53,7 @@ void tooltip::draw(graphic &gr, const rect &)
         theme_dimension(tcn, tv_border_width, theme_),
         theme_dimension(tcn, tv_round, theme_));
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = text_font;
 
     auto text_indent = theme_dimension(tcn, tv_text_indent, theme_);
 
@@ -117,6 +118,11 @@ void tooltip::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view tooltip::theme_control_name() const
+{
+    return tcn;
+}
+
 void tooltip::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -125,6 +131,8 @@ void tooltip::update_theme(std::shared_ptr<i_theme> theme__)
     }
     theme_ = theme__;
 
+    text_font = theme_font_handle(tcn, tv_font, theme_);
+
     redraw();
 }
 
@@ -208,7 +216,7 @@ void tooltip::update_size()
     graphic mem_gr(ctx);
     mem_gr.init({ 0, 0, 1024, 500 }, 0);
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = text_font;
 
     auto old_position = position_;
 
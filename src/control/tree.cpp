@@ -0,0 +1,797 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/control/tree.hpp>
+
+#include <wui/window/window.hpp>
+
+#include <wui/theme/theme.hpp>
+#include <wui/theme/theme_overlay.hpp>
+
+#include <wui/locale/locale.hpp>
+
+#include <wui/system/tools.hpp>
+#include <wui/common/flag_helpers.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+tree::tree(std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
+    : list_theme(std::make_shared<theme_overlay>(theme__)),
+    list_(std::make_shared<list>(list::tc, list_theme)),
+    tcn(theme_control_name),
+    theme_(theme__),
+    text_font(theme_font_handle(tcn, tv_font, theme_)),
+    parent_(),
+    my_subscriber_id(),
+    nodes(),
+    free_nodes(),
+    children_provider(),
+    async_children_provider(),
+    loaded(std::make_shared<loaded_queue>()),
+    node_change_callback(), node_activate_callback(),
+    selected(-1),
+    selecting(false),
+    item_height_(28)
+{
+    nodes.push_back({ { "", true, 0 }, -1, 0, -1, node_state::expanded, true, 0, {}, { 0 }, 1 });
+
+    update_list_theme();
+
+    list_->set_item_height(item_height_);
+    list_->set_draw_callback(std::bind(&tree::draw_list_item, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+    list_->set_item_click_callback([this](list::click_button btn, int32_t n_item, int32_t x, int32_t) {
+        if (btn != list::click_button::left)
+        {
+            return;
+        }
+
+        /// The click on the expander
+        auto r = find_row(n_item);
+        if (r.node > 0 && !r.loading && x - list_->position().left < (nodes[r.node].level + 1) * item_height_)
+        {
+            nodes[r.node].state == node_state::collapsed ? expand(r.node) : collapse(r.node);
+        }
+    });
+    list_->set_item_activate_callback(std::bind(&tree::activate_list_item, this, std::placeholders::_1));
+    list_->set_item_change_callback(std::bind(&tree::change_list_item, this, std::placeholders::_1));
+}
+
+tree::~tree()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(list_);
+        parent__->unsubscribe(my_subscriber_id);
+    }
+}
+
+void tree::draw(graphic &gr, const rect &)
+{
+}
+
+void tree::set_position(const rect &position__, bool redraw)
+{
+    list_->set_position(position__, redraw);
+}
+
+rect tree::position() const
+{
+    return list_->position();
+}
+
+void tree::set_parent(std::shared_ptr<window> window)
+{
+    parent_ = window;
+
+    if (window)
+    {
+        window->add_control(list_, list_->position());
+
+        my_subscriber_id = window->subscribe(std::bind(&tree::receive_event, this, std::placeholders::_1),
+            wui::flags_map<wui::event_type>(2, wui::event_type::internal, wui::event_type::keyboard));
+    }
+}
+
+std::weak_ptr<window> tree::parent() const
+{
+    return parent_;
+}
+
+void tree::clear_parent()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(list_);
+        parent__->unsubscribe(my_subscriber_id);
+        my_subscriber_id.clear();
+    }
+
+    parent_.reset();
+}
+
+void tree::update_list_theme()
+{
+    list_theme->set_parent(theme_);
+
+    list_theme->set_color(list::tc, list::tv_background, theme_color(tcn, tv_background, theme_));
+    list_theme->set_color(list::tc, list::tv_border, theme_color(tcn, tv_border, theme_));
+    list_theme->set_color(list::tc, list::tv_focused_border, theme_color(tcn, tv_focused_border, theme_));
+    list_theme->set_dimension(list::tc, list::tv_border_width, theme_dimension(tcn, tv_border_width, theme_));
+    list_theme->set_color(scroll::tc, scroll::tv_background, theme_color(tcn, tv_scrollbar, theme_));
+    list_theme->set_color(scroll::tc, scroll::tv_slider, theme_color(tcn, tv_scrollbar_slider, theme_));
+    list_theme->set_color(scroll::tc, scroll::tv_slider_acive, theme_color(tcn, tv_scrollbar_slider_acive, theme_));
+    list_theme->set_dimension(list::tc, list::tv_round, theme_dimension(tcn, tv_round, theme_));
+}
+
+void tree::receive_event(const event &ev)
+{
+    if (ev.type == event_type::internal && ev.internal_event_.type == internal_event_type::user_emitted && ev.internal_event_.x == loaded_event_id)
+    {
+        return apply_loaded();
+    }
+
+    /// The list moves the selection by the other keys itself
+    if (ev.type != event_type::keyboard || ev.keyboard_event_.type != keyboard_event_type::down || !list_->focused() || !valid(selected) || selected == root_node)
+    {
+        return;
+    }
+
+    switch (ev.keyboard_event_.key[0])
+    {
+        case vk_right:
+            if (nodes[selected].state == node_state::collapsed)
+            {
+                expand(selected);
+            }
+            else if (nodes[selected].state == node_state::expanded && !nodes[selected].children.empty())
+            {
+                select_node(nodes[selected].children.front());
+            }
+        break;
+        case vk_left:
+            if (nodes[selected].state != node_state::collapsed)
+            {
+                collapse(selected);
+            }
+            else if (nodes[selected].parent != root_node)
+            {
+                select_node(nodes[selected].parent);
+            }
+        break;
+    }
+}
+
+void tree::set_topmost(bool)
+{
+}
+
+bool tree::topmost() const
+{
+    return false;
+}
+
+bool tree::focused() const
+{
+    return list_->focused();
+}
+
+bool tree::focusing() const
+{
+    return false; /// the list is focused
+}
+
+error tree::get_error() const
+{
+    return list_->get_error();
+}
+
+void tree::update_theme_control_name(std::string_view theme_control_name)
+{
+    tcn = theme_control_name;
+    update_theme(theme_);
+}
+
+std::string_view tree::theme_control_name() const
+{
+    return tcn;
+}
+
+void tree::update_theme(std::shared_ptr<i_theme> theme__)
+{
+    if (theme_ && !theme__)
+    {
+        return;
+    }
+    theme_ = theme__;
+
+    text_font = theme_font_handle(tcn, tv_font, theme_);
+
+    update_list_theme();
+
+    list_->update_theme(list_theme);
+}
+
+void tree::show()
+{
+    list_->show();
+}
+
+void tree::hide()
+{
+    list_->hide();
+}
+
+bool tree::showed() const
+{
+    return list_->showed();
+}
+
+void tree::enable()
+{
+    list_->enable();
+}
+
+void tree::disable()
+{
+    list_->disable();
+}
+
+bool tree::enabled() const
+{
+    return list_->enabled();
+}
+
+void tree::set_items(const std::vector<tree_item> &items)
+{
+    free_children(root_node);
+
+    auto items_ = items;
+    set_children(root_node, items_);
+
+    nodes[root_node].state = node_state::expanded;
+    nodes[root_node].rows = 1 + children_rows_sum(nodes[root_node], static_cast<int32_t>(items_.size()));
+
+    selected = -1;
+    update_count();
+}
+
+void tree::set_children_provider(std::function<void(int32_t, std::vector<tree_item>&)> children_provider_)
+{
+    children_provider = children_provider_;
+}
+
+void tree::set_async_children_provider(std::function<void(int32_t, std::function<void(std::vector<tree_item>&&)>)> async_children_provider_)
+{
+    async_children_provider = async_children_provider_;
+}
+
+const tree_item &tree::item(int32_t node_) const
+{
+    return nodes[valid(node_) ? node_ : root_node].item;
+}
+
+int32_t tree::parent_node(int32_t node_) const
+{
+    return valid(node_) ? nodes[node_].parent : -1;
+}
+
+int32_t tree::node_level(int32_t node_) const
+{
+    return valid(node_) ? nodes[node_].level : -1;
+}
+
+void tree::expand(int32_t node_)
+{
+    if (!valid(node_) || !nodes[node_].item.has_children || nodes[node_].state != node_state::collapsed)
+    {
+        return;
+    }
+
+    if (nodes[node_].loaded)
+    {
+        nodes[node_].state = node_state::expanded;
+        add_rows(node_, children_rows_sum(nodes[node_], static_cast<int32_t>(nodes[node_].children.size())));
+    }
+    else if (children_provider)
+    {
+        std::vector<tree_item> children;
+        children_provider(node_, children);
+
+        set_children(node_, children);
+
+        nodes[node_].state = node_state::expanded;
+        add_rows(node_, static_cast<int32_t>(children.size()));
+    }
+    else if (async_children_provider)
+    {
+        auto ticket = ++nodes[node_].ticket;
+
+        /// The loading row is shown till the children are loaded
+        nodes[node_].state = node_state::loading;
+        add_rows(node_, 1);
+        update_count();
+
+        /// The ready() function holds the queue and the window taken on the UI thread, not the tree,
+        /// so the tree is not read and not destroyed on the provider's thread
+        auto queue = loaded;
+        auto window_ = parent_;
+
+        async_children_provider(node_, [queue, window_, node_, ticket](std::vector<tree_item> &&children) {
+            {
+                std::lock_guard<std::mutex> lock(queue->mutex);
+                queue->items.push_back({ node_, ticket, std::move(children) });
+            }
+
+            /// Applied on the UI thread
+            auto parent__ = window_.lock();
+            if (parent__)
+            {
+                parent__->emit_event(loaded_event_id, 0);
+            }
+        });
+
+        return;
+    }
+    else
+    {
+        return;
+    }
+
+    update_count();
+}
+
+void tree::collapse(int32_t node_)
+{
+    if (!valid(node_) || node_ == root_node || nodes[node_].state == node_state::collapsed)
+    {
+        return;
+    }
+
+    auto delta = nodes[node_].state == node_state::expanded ? -children_rows_sum(nodes[node_], static_cast<int32_t>(nodes[node_].children.size())) : -1;
+
+    nodes[node_].state = node_state::collapsed;
+    add_rows(node_, delta);
+
+    update_count();
+}
+
+bool tree::expanded(int32_t node_) const
+{
+    return valid(node_) && nodes[node_].state == node_state::expanded;
+}
+
+void tree::reload(int32_t node_)
+{
+    if (!valid(node_))
+    {
+        return;
+    }
+
+    auto state = nodes[node_].state;
+
+    if (node_ != root_node)
+    {
+        collapse(node_);
+    }
+    else
+    {
+        add_rows(root_node, -(nodes[root_node].rows - 1));
+        nodes[root_node].state = node_state::collapsed;
+    }
+
+    free_children(node_);
+    ++nodes[node_].ticket; /// the loading in progress is not applied
+
+    if (state != node_state::collapsed)
+    {
+        expand(node_);
+    }
+
+    update_count();
+}
+
+void tree::select_node(int32_t node_)
+{
+    if (!valid(node_) || node_ == root_node)
+    {
+        return;
+    }
+
+    for (auto p = nodes[node_].parent; p != root_node; p = nodes[p].parent)
+    {
+        if (nodes[p].state == node_state::collapsed)
+        {
+            expand(p);
+        }
+    }
+
+    auto n_row = node_row(node_);
+    if (n_row != -1)
+    {
+        list_->select_item(n_row);
+    }
+}
+
+int32_t tree::selected_node() const
+{
+    return selected;
+}
+
+int32_t tree::visible_count() const
+{
+    return nodes[root_node].rows - 1;
+}
+
+void tree::set_item_height(int32_t item_height)
+{
+    item_height_ = item_height;
+    list_->set_item_height(item_height_);
+}
+
+void tree::set_node_change_callback(std::function<void(int32_t)> node_change_callback_)
+{
+    node_change_callback = node_change_callback_;
+}
+
+void tree::set_node_activate_callback(std::function<void(int32_t)> node_activate_callback_)
+{
+    node_activate_callback = node_activate_callback_;
+}
+
+int32_t tree::new_node(const tree_item &item_, int32_t parent, int32_t index)
+{
+    int32_t id = 0;
+    uint32_t ticket = 0;
+    if (!free_nodes.empty())
+    {
+        id = free_nodes.back();
+        free_nodes.pop_back();
+
+        ticket = nodes[id].ticket + 1; /// the loading of the previous node is not applied to the new one
+    }
+    else
+    {
+        id = static_cast<int32_t>(nodes.size());
+        nodes.emplace_back();
+    }
+
+    auto &n = nodes[id];
+    n.item = item_;
+    n.parent = parent;
+    n.index = index;
+    n.level = nodes[parent].level + 1;
+    n.state = node_state::collapsed;
+    n.loaded = false;
+    n.ticket = ticket;
+    n.children.clear();
+    n.children_rows.clear();
+    n.rows = 1;
+
+    return id;
+}
+
+void tree::free_children(int32_t node_)
+{
+    for (auto c : nodes[node_].children)
+    {
+        free_children(c);
+
+        nodes[c].index = -1;
+        nodes[c].item.text.clear();
+        free_nodes.push_back(c);
+    }
+
+    std::vector<int32_t>().swap(nodes[node_].children);
+    nodes[node_].children_rows.assign(1, 0);
+    nodes[node_].loaded = false;
+
+    if (selected != -1 && !valid(selected))
+    {
+        selected = -1;
+    }
+}
+
+void tree::set_children(int32_t node_, std::vector<tree_item> &children)
+{
+    std::vector<int32_t> ids;
+    ids.reserve(children.size());
+    for (size_t i = 0; i != children.size(); ++i)
+    {
+        ids.emplace_back(new_node(children[i], node_, static_cast<int32_t>(i)));
+    }
+
+    auto &n = nodes[node_];
+    n.children.swap(ids);
+    n.loaded = true;
+
+    /// Each new child is one row, the Fenwick tree is built for the linear time
+    auto count = static_cast<int32_t>(n.children.size());
+    n.children_rows.assign(count + 1, 0);
+    for (int32_t i = 1; i <= count; ++i)
+    {
+        n.children_rows[i] += 1;
+
+        auto j = i + (i & -i);
+        if (j <= count)
+        {
+            n.children_rows[j] += n.children_rows[i];
+        }
+    }
+}
+
+void tree::add_rows(int32_t node_, int32_t delta)
+{
+    while (delta != 0)
+    {
+        auto &n = nodes[node_];
+        n.rows += delta;
+
+        if (node_ == root_node)
+        {
+            break;
+        }
+
+        auto &p = nodes[n.parent];
+        auto count = static_cast<int32_t>(p.children.size());
+        for (auto i = n.index + 1; i <= count; i += i & -i)
+        {
+            p.children_rows[i] += delta;
+        }
+
+        /// The rows of the collapsed node are not changed by its descendants
+        if (p.state != node_state::expanded)
+        {
+            break;
+        }
+
+        node_ = n.parent;
+    }
+}
+
+int32_t tree::children_rows_sum(const node &n, int32_t count) const
+{
+    int32_t sum = 0;
+    for (auto i = count; i > 0; i -= i & -i)
+    {
+        sum += n.children_rows[i];
+    }
+    return sum;
+}
+
+tree::row tree::find_row(int32_t n_row) const
+{
+    if (n_row < 0 || n_row >= visible_count())
+    {
+        return { -1, false };
+    }
+
+    int32_t n = root_node;
+    while (true)
+    {
+        auto &nd = nodes[n];
+        if (nd.state == node_state::loading)
+        {
+            return { n, true };
+        }
+
+        /// The last child having the rows sum before it not greater than the row
+        auto count = static_cast<int32_t>(nd.children.size());
+        int32_t pos = 0, step = 1;
+        while (step * 2 <= count)
+        {
+            step *= 2;
+        }
+        for (; step != 0; step /= 2)
+        {
+            if (pos + step <= count && nd.children_rows[pos + step] <= n_row)
+            {
+                pos += step;
+                n_row -= nd.children_rows[pos];
+            }
+        }
+
+        if (pos >= count)
+        {
+            return { -1, false };
+        }
+
+        auto c = nd.children[pos];
+        if (n_row == 0)
+        {
+            return { c, false };
+        }
+
+        --n_row;
+        n = c;
+    }
+}
+
+int32_t tree::node_row(int32_t node_) const
+{
+    int32_t n_row = -1;
+    for (auto n = node_; n != root_node; n = nodes[n].parent)
+    {
+        auto &p = nodes[nodes[n].parent];
+        if (p.state != node_state::expanded)
+        {
+            return -1;
+        }
+
+        n_row += 1 + children_rows_sum(p, nodes[n].index);
+    }
+    return n_row;
+}
+
+void tree::apply_loaded()
+{
+    std::vector<loaded_children> loaded_;
+    {
+        std::lock_guard<std::mutex> lock(loaded->mutex);
+        loaded_.swap(loaded->items);
+    }
+
+    for (auto &l : loaded_)
+    {
+        if (!valid(l.node) || nodes[l.node].ticket != l.ticket || nodes[l.node].loaded)
+        {
+            continue;
+        }
+
+        set_children(l.node, l.children);
+
+        /// The node collapsed while loading keeps the children hidden
+        if (nodes[l.node].state == node_state::loading)
+        {
+            nodes[l.node].state = node_state::expanded;
+            add_rows(l.node, static_cast<int32_t>(l.children.size()) - 1);
+        }
+    }
+
+    if (!loaded_.empty())
+    {
+        update_count();
+    }
+}
+
+void tree::update_count()
+{
+    list_->set_item_count(visible_count());
+
+    if (!valid(selected) || selected == root_node)
+    {
+        return;
+    }
+
+    /// The selection stays on the node, the node hidden by the collapsing passes it to the collapsed ancestor
+    auto n = selected;
+    auto n_row = node_row(n);
+    while (n_row == -1 && nodes[n].parent != root_node)
+    {
+        n = nodes[n].parent;
+        n_row = node_row(n);
+    }
+
+    /// The view is scrolled only if the selection is moved to the ancestor, the expanding or the loading keeps it
+    if (n_row != -1)
+    {
+        selecting = n == selected;
+        list_->select_item(n_row, n != selected);
+        selecting = false;
+    }
+}
+
+bool tree::valid(int32_t node_) const
+{
+    return node_ >= 0 && node_ < static_cast<int32_t>(nodes.size()) && nodes[node_].index != -1;
+}
+
+void tree::draw_expander(graphic &gr, const rect &pos, bool expanded_)
+{
+    auto color = theme_color(tcn, tv_expander, theme_);
+
+    int32_t w = 8, h = 4;
+
+    for (int32_t j = 0; j != h; ++j)
+    {
+        if (expanded_)
+        {
+            gr.draw_line({ pos.left + j, pos.top + j, pos.left + j + w, pos.top + j }, color);
+        }
+        else
+        {
+            gr.draw_line({ pos.left + j, pos.top + j, pos.left + j, pos.top + j + w }, color);
+        }
+        w -= 2;
+    }
+}
+
+void tree::draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect, list::item_state state)
+{
+    auto r = find_row(n_item);
+    if (r.node == -1)
+    {
+        return;
+    }
+    auto &n = nodes[r.node];
+
+    if (state == list::item_state::selected)
+    {
+        gr.draw_rect(item_rect, theme_color(tcn, tv_selected_item, theme_));
+    }
+    else if (state == list::item_state::active)
+    {
+        gr.draw_rect(item_rect, theme_color(tcn, tv_active_item, theme_));
+    }
+
+    auto font = text_font;
+    auto text_height = gr.measure_text("Qq", font).height();
+    auto height = item_rect.height();
+
+    auto left = item_rect.left + height * (r.loading ? n.level + 1 : n.level);
+
+    if (r.loading)
+    {
+        gr.draw_text({ left + height, item_rect.top + (height - text_height) / 2 }, locale(tc, cl_loading), theme_color(tcn, tv_loading_text, theme_), font);
+        return;
+    }
+
+    if (n.item.has_children && !(n.loaded && n.children.empty()))
+    {
+        draw_expander(gr, { left + (height - 8) / 2, item_rect.top + (height - 8) / 2 }, n.state != node_state::collapsed);
+    }
+
+    gr.draw_text({ left + height, item_rect.top + (height - text_height) / 2 }, n.item.text, theme_color(tcn, tv_text, theme_), font);
+}
+
+void tree::activate_list_item(int32_t n_item)
+{
+    auto r = find_row(n_item);
+    if (r.node == -1 || r.loading)
+    {
+        return;
+    }
+
+    if (nodes[r.node].item.has_children)
+    {
+        nodes[r.node].state == node_state::collapsed ? expand(r.node) : collapse(r.node);
+    }
+
+    if (node_activate_callback)
+    {
+        node_activate_callback(r.node);
+    }
+}
+
+void tree::change_list_item(int32_t n_item)
+{
+    if (selecting)
+    {
+        return;
+    }
+
+    auto r = find_row(n_item);
+    if (r.loading)
+    {
+        return;
+    }
+
+    selected = r.node;
+
+    if (node_change_callback)
+    {
+        node_change_callback(selected);
+    }
+}
+
+}
@@ -0,0 +1,152 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/graphic/decimation.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define WUI_DECIMATION_SIMD
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define WUI_TARGET_AVX2
+#else
+#define WUI_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#endif
+
+namespace wui
+{
+
+static void min_max_scalar(const float *values, size_t count, float &min_value, float &max_value)
+{
+    auto mn = values[0], mx = values[0];
+    for (size_t i = 1; i < count; ++i)
+    {
+        mn = values[i] < mn ? values[i] : mn;
+        mx = values[i] > mx ? values[i] : mx;
+    }
+
+    min_value = mn;
+    max_value = mx;
+}
+
+#ifdef WUI_DECIMATION_SIMD
+
+static inline float reduce_min_sse2(__m128 v)
+{
+    v = _mm_min_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_min_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+static inline float reduce_max_sse2(__m128 v)
+{
+    v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_max_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+/// Two accumulators for each bound hide the latency of min and max
+static void min_max_sse2(const float *values, size_t count, float &min_value, float &max_value)
+{
+    if (count < 8)
+    {
+        return min_max_scalar(values, count, min_value, max_value);
+    }
+
+    auto mn0 = _mm_loadu_ps(values), mn1 = _mm_loadu_ps(values + 4);
+    auto mx0 = mn0, mx1 = mn1;
+
+    size_t i = 8;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto a = _mm_loadu_ps(values + i), b = _mm_loadu_ps(values + i + 4);
+        mn0 = _mm_min_ps(mn0, a); mx0 = _mm_max_ps(mx0, a);
+        mn1 = _mm_min_ps(mn1, b); mx1 = _mm_max_ps(mx1, b);
+    }
+
+    auto mn = reduce_min_sse2(_mm_min_ps(mn0, mn1)), mx = reduce_max_sse2(_mm_max_ps(mx0, mx1));
+
+    for (; i < count; ++i)
+    {
+        mn = values[i] < mn ? values[i] : mn;
+        mx = values[i] > mx ? values[i] : mx;
+    }
+
+    min_value = mn;
+    max_value = mx;
+}
+
+WUI_TARGET_AVX2 static void min_max_avx2(const float *values, size_t count, float &min_value, float &max_value)
+{
+    if (count < 16)
+    {
+        return min_max_sse2(values, count, min_value, max_value);
+    }
+
+    auto mn0 = _mm256_loadu_ps(values), mn1 = _mm256_loadu_ps(values + 8);
+    auto mx0 = mn0, mx1 = mn1;
+
+    size_t i = 16;
+    for (; i + 16 <= count; i += 16)
+    {
+        auto a = _mm256_loadu_ps(values + i), b = _mm256_loadu_ps(values + i + 8);
+        mn0 = _mm256_min_ps(mn0, a); mx0 = _mm256_max_ps(mx0, a);
+        mn1 = _mm256_min_ps(mn1, b); mx1 = _mm256_max_ps(mx1, b);
+    }
+
+    mn0 = _mm256_min_ps(mn0, mn1);
+    mx0 = _mm256_max_ps(mx0, mx1);
+
+    auto mn = reduce_min_sse2(_mm_min_ps(_mm256_castps256_ps128(mn0), _mm256_extractf128_ps(mn0, 1)));
+    auto mx = reduce_max_sse2(_mm_max_ps(_mm256_castps256_ps128(mx0), _mm256_extractf128_ps(mx0, 1)));
+
+    for (; i < count; ++i)
+    {
+        mn = values[i] < mn ? values[i] : mn;
+        mx = values[i] > mx ? values[i] : mx;
+    }
+
+    min_value = mn;
+    max_value = mx;
+}
+
+#endif
+
+void min_max(const float *values, size_t count, float &min_value, float &max_value, pixel_kernel kernel)
+{
+    if (!values || count == 0)
+    {
+        return;
+    }
+
+    /// Not supported kernel is replaced by the best available
+    auto best = best_pixel_kernel();
+    if (kernel == pixel_kernel::best || static_cast<int32_t>(kernel) > static_cast<int32_t>(best))
+    {
+        kernel = best;
+    }
+
+#ifdef WUI_DECIMATION_SIMD
+    if (kernel == pixel_kernel::avx2)
+    {
+        return min_max_avx2(values, count, min_value, max_value);
+    }
+    else if (kernel == pixel_kernel::sse2)
+    {
+        return min_max_sse2(values, count, min_value, max_value);
+    }
+#endif
+
+    min_max_scalar(values, count, min_value, max_value);
+}
+
+}
@@ -0,0 +1,429 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/graphic/display_list.hpp>
+#include <wui/graphic/graphic.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+static rect normalized(const rect &r)
+{
+    return { (std::min)(r.left, r.right), (std::min)(r.top, r.bottom), (std::max)(r.left, r.right), (std::max)(r.top, r.bottom) };
+}
+
+static rect united(const rect &a, const rect &b)
+{
+    if (a.is_null())
+    {
+        return b;
+    }
+    if (b.is_null())
+    {
+        return a;
+    }
+    return { (std::min)(a.left, b.left), (std::min)(a.top, b.top), (std::max)(a.right, b.right), (std::max)(a.bottom, b.bottom) };
+}
+
+static bool same(const rect &a, const rect &b)
+{
+    return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+
+display_list::display_list()
+    : commands(), texts(), points(), bounds_{ 0 }, thread_safe_(true), unsafe_bounds_{ 0 }
+{
+}
+
+void display_list::clear()
+{
+    commands.clear();
+    texts.clear();
+    points.clear();
+    bounds_ = { 0 };
+    thread_safe_ = true;
+    unsafe_bounds_ = { 0 };
+}
+
+bool display_list::empty() const
+{
+    return commands.empty();
+}
+
+size_t display_list::size() const
+{
+    return commands.size();
+}
+
+rect display_list::bounds() const
+{
+    return bounds_;
+}
+
+bool display_list::thread_safe() const
+{
+    return thread_safe_;
+}
+
+rect display_list::unsafe_bounds() const
+{
+    return unsafe_bounds_;
+}
+
+display_list::command &display_list::add(command_type type, const rect &position, const rect &bounds)
+{
+    commands.push_back(command{ type, position, bounds, { 0 }, 0, 0, 0, 0, 0, 0, 0, 0, pixel_format::native, false, 0, 0, 0, 0, nullptr });
+    bounds_ = united(bounds_, bounds);
+
+    return commands.back();
+}
+
+void display_list::add_clear(const rect &position)
+{
+    add(command_type::clear, position, normalized(position));
+}
+
+void display_list::add_pixel(const rect &position, color color_)
+{
+    add(command_type::pixel, position, { position.left, position.top, position.left + 1, position.top + 1 }).color_ = color_;
+}
+
+void display_list::add_line(const rect &position, color color_, uint32_t width)
+{
+    auto bounds = normalized(position);
+    auto half = static_cast<int32_t>(width / 2) + 1;
+    bounds = { bounds.left - half, bounds.top - half, bounds.right + half, bounds.bottom + half };
+
+    auto &c = add(command_type::line, position, bounds);
+    c.color_ = color_;
+    c.width = width;
+}
+
+display_list::command &display_list::add_point_command(command_type type, const point *points_, size_t count, int32_t outset)
+{
+    rect bounds = { points_[0].x, points_[0].y, points_[0].x, points_[0].y };
+    for (size_t i = 1; i != count; ++i)
+    {
+        bounds = { (std::min)(bounds.left, points_[i].x), (std::min)(bounds.top, points_[i].y),
+            (std::max)(bounds.right, points_[i].x), (std::max)(bounds.bottom, points_[i].y) };
+    }
+    bounds = { bounds.left - outset, bounds.top - outset, bounds.right + outset, bounds.bottom + outset };
+
+    /// The position is the bounds too, so the commands are compared by the points
+    auto &c = add(type, bounds, bounds);
+    c.points_offset = points.size();
+    c.points_size = count;
+
+    points.insert(points.end(), points_, points_ + count);
+
+    return c;
+}
+
+display_list::command &display_list::add_rect_command(command_type type, const rect *positions, size_t count, int32_t outset)
+{
+    auto offset = points.size();
+    for (size_t i = 0; i != count; ++i)
+    {
+        points.push_back({ positions[i].left, positions[i].top });
+        points.push_back({ positions[i].right, positions[i].bottom });
+    }
+
+    rect bounds = { 0 };
+    for (size_t i = 0; i != count; ++i)
+    {
+        bounds = united(bounds, normalized(positions[i]));
+    }
+    bounds = { bounds.left - outset, bounds.top - outset, bounds.right + outset, bounds.bottom + outset };
+
+    auto &c = add(type, bounds, bounds);
+    c.points_offset = offset;
+    c.points_size = count * 2;
+
+    return c;
+}
+
+void display_list::add_polyline(const point *points_, size_t count, color color_, uint32_t width)
+{
+    auto &c = add_point_command(command_type::polyline, points_, count, static_cast<int32_t>(width / 2) + 1);
+    c.color_ = color_;
+    c.width = width;
+}
+
+void display_list::add_pixels(const point *points_, size_t count, color color_)
+{
+    auto &c = add_point_command(command_type::pixels, points_, count, 0);
+    c.bounds.right += 1;
+    c.bounds.bottom += 1;
+    c.color_ = color_;
+}
+
+void display_list::add_lines(const rect *positions, size_t count, color color_)
+{
+    add_rect_command(command_type::lines, positions, count, 1).color_ = color_;
+}
+
+void display_list::add_rects(const rect *positions, size_t count, color fill_color)
+{
+    add_rect_command(command_type::rects, positions, count, 0).fill_color = fill_color;
+}
+
+void display_list::add_text(const rect &position, const rect &bounds, std::string_view text, color color_, font_handle font_)
+{
+    auto &c = add(command_type::text, position, bounds);
+    c.color_ = color_;
+    c.font_id = font_.id;
+    c.text_offset = texts.size();
+    c.text_size = text.size();
+
+    texts.append(text.data(), text.size());
+}
+
+void display_list::add_rect(const rect &position, color fill_color)
+{
+    add(command_type::rect, position, normalized(position)).fill_color = fill_color;
+}
+
+void display_list::add_rect(const rect &position, color border_color, color fill_color, uint32_t border_width, uint32_t round)
+{
+    auto &c = add(command_type::rounded_rect, position, normalized(position));
+    c.color_ = border_color;
+    c.fill_color = fill_color;
+    c.width = border_width;
+    c.round = round;
+}
+
+void display_list::add_buffer(const rect &position, uint8_t *buffer, int32_t left_shift, int32_t top_shift)
+{
+    auto &c = add(command_type::buffer, position, normalized(position));
+    c.pointer = buffer;
+    c.left_shift = left_shift;
+    c.top_shift = top_shift;
+}
+
+void display_list::add_buffer(const rect &position, const uint8_t *buffer, pixel_format format, int32_t stride, int32_t left_shift, int32_t top_shift, bool premultiply)
+{
+    auto &c = add(command_type::format_buffer, position, normalized(position));
+    c.pointer = buffer;
+    c.format = format;
+    c.stride = stride;
+    c.left_shift = left_shift;
+    c.top_shift = top_shift;
+    c.premultiply = premultiply;
+}
+
+void display_list::add_graphic(const rect &position, graphic &graphic_, int32_t left_shift, int32_t top_shift)
+{
+    /// position's right and bottom are the width and height here
+    auto &c = add(command_type::graphic, position, { position.left, position.top, position.left + position.right, position.top + position.bottom });
+    c.pointer = &graphic_;
+    c.left_shift = left_shift;
+    c.top_shift = top_shift;
+
+    thread_safe_ = false;
+    unsafe_bounds_ = united(unsafe_bounds_, c.bounds);
+}
+
+#ifdef _WIN32
+/// The gdi+ image can't be drawn by the two threads at once, so the list with the image is not thread safe
+void display_list::add_surface(Gdiplus::Image &surface, const rect &position)
+{
+    auto &c = add(command_type::surface, position, normalized(position));
+    c.pointer = &surface;
+
+    thread_safe_ = false;
+    unsafe_bounds_ = united(unsafe_bounds_, c.bounds);
+}
+
+void display_list::add_surface(Gdiplus::Image &surface, const rect &source, const rect &position)
+{
+    auto &c = add(command_type::scaled_surface, position, normalized(position));
+    c.pointer = &surface;
+    c.source = source;
+
+    thread_safe_ = false;
+    unsafe_bounds_ = united(unsafe_bounds_, c.bounds);
+}
+#elif __linux__
+void display_list::add_surface(_cairo_surface &surface, const rect &position)
+{
+    add(command_type::surface, position, normalized(position)).pointer = &surface;
+}
+
+void display_list::add_surface(_cairo_surface &surface, const rect &source, const rect &position)
+{
+    auto &c = add(command_type::scaled_surface, position, normalized(position));
+    c.pointer = &surface;
+    c.source = source;
+}
+#endif
+
+void display_list::replay(graphic &gr, const rect &area, int32_t x_origin, int32_t y_origin) const
+{
+    auto moved = [x_origin, y_origin](const rect &r) {
+        return rect{ r.left - x_origin, r.top - y_origin, r.right - x_origin, r.bottom - y_origin };
+    };
+
+    std::vector<point> moved_points;
+    std::vector<rect> moved_rects;
+
+    auto move_points = [&](const command &c) {
+        moved_points.assign(points.begin() + c.points_offset, points.begin() + c.points_offset + c.points_size);
+        for (auto &p : moved_points)
+        {
+            p.x -= x_origin;
+            p.y -= y_origin;
+        }
+    };
+    auto move_rects = [&](const command &c) {
+        moved_rects.resize(c.points_size / 2);
+        for (size_t i = 0; i != moved_rects.size(); ++i)
+        {
+            auto &lt = points[c.points_offset + i * 2], &rb = points[c.points_offset + i * 2 + 1];
+            moved_rects[i] = { lt.x - x_origin, lt.y - y_origin, rb.x - x_origin, rb.y - y_origin };
+        }
+    };
+
+    for (auto &c : commands)
+    {
+        if (!area.is_null() && !c.bounds.in(area))
+        {
+            continue;
+        }
+
+        auto position = moved(c.position);
+
+        switch (c.type)
+        {
+            case command_type::clear:
+                gr.clear(position);
+            break;
+            case command_type::pixel:
+                gr.draw_pixel(position, c.color_);
+            break;
+            case command_type::line:
+                gr.draw_line(position, c.color_, c.width);
+            break;
+            case command_type::polyline:
+                move_points(c);
+                gr.draw_polyline(moved_points.data(), moved_points.size(), c.color_, c.width);
+            break;
+            case command_type::pixels:
+                move_points(c);
+                gr.draw_pixels(moved_points.data(), moved_points.size(), c.color_);
+            break;
+            case command_type::lines:
+                move_rects(c);
+                gr.draw_lines(moved_rects.data(), moved_rects.size(), c.color_);
+            break;
+            case command_type::rects:
+                move_rects(c);
+                gr.draw_rects(moved_rects.data(), moved_rects.size(), c.fill_color);
+            break;
+            case command_type::text:
+                gr.draw_text(position, std::string_view(texts.data() + c.text_offset, c.text_size), c.color_, font_handle{ c.font_id });
+            break;
+            case command_type::rect:
+                gr.draw_rect(position, c.fill_color);
+            break;
+            case command_type::rounded_rect:
+                gr.draw_rect(position, c.color_, c.fill_color, c.width, c.round);
+            break;
+            case command_type::buffer:
+                gr.draw_buffer(position, static_cast<uint8_t*>(const_cast<void*>(c.pointer)), c.left_shift, c.top_shift);
+            break;
+            case command_type::format_buffer:
+                gr.draw_buffer(position, static_cast<const uint8_t*>(c.pointer), c.format, c.stride, c.left_shift, c.top_shift, c.premultiply);
+            break;
+            case command_type::graphic:
+                /// position's right and bottom are the width and height here
+                position = { c.position.left - x_origin, c.position.top - y_origin, c.position.right, c.position.bottom };
+                gr.draw_graphic(position, *static_cast<graphic*>(const_cast<void*>(c.pointer)), c.left_shift, c.top_shift);
+            break;
+#ifdef _WIN32
+            case command_type::surface:
+                gr.draw_surface(*static_cast<Gdiplus::Image*>(const_cast<void*>(c.pointer)), position);
+            break;
+            case command_type::scaled_surface:
+                gr.draw_surface(*static_cast<Gdiplus::Image*>(const_cast<void*>(c.pointer)), c.source, position);
+            break;
+#elif __linux__
+            case command_type::surface:
+                gr.draw_surface(*static_cast<_cairo_surface*>(const_cast<void*>(c.pointer)), position);
+            break;
+            case command_type::scaled_surface:
+                gr.draw_surface(*static_cast<_cairo_surface*>(const_cast<void*>(c.pointer)), c.source, position);
+            break;
+#endif
+            default: break;
+        }
+    }
+}
+
+bool display_list::equal(const command &a, const command &b, const display_list &b_list) const
+{
+    if (a.type != b.type || !same(a.position, b.position) || !same(a.bounds, b.bounds))
+    {
+        return false;
+    }
+
+    switch (a.type)
+    {
+        case command_type::clear:
+            return true;
+        case command_type::pixel:
+            return a.color_ == b.color_;
+        case command_type::line:
+            return a.color_ == b.color_ && a.width == b.width;
+        case command_type::polyline: case command_type::pixels: case command_type::lines: case command_type::rects:
+            return a.color_ == b.color_ && a.fill_color == b.fill_color && a.width == b.width && a.points_size == b.points_size &&
+                std::equal(points.begin() + a.points_offset, points.begin() + a.points_offset + a.points_size, b_list.points.begin() + b.points_offset);
+        case command_type::text:
+            return a.color_ == b.color_ && a.font_id == b.font_id &&
+                std::string_view(texts.data() + a.text_offset, a.text_size) == std::string_view(b_list.texts.data() + b.text_offset, b.text_size);
+        case command_type::rect:
+            return a.fill_color == b.fill_color;
+        case command_type::rounded_rect:
+            return a.color_ == b.color_ && a.fill_color == b.fill_color && a.width == b.width && a.round == b.round;
+        default:
+            return false; /// the sources content is unknown
+    }
+}
+
+void display_list::diff(const display_list &prev, const display_list &next, std::vector<rect> &damage)
+{
+    auto common = (std::min)(prev.commands.size(), next.commands.size());
+
+    size_t i = 0;
+    for (; i != common; ++i)
+    {
+        auto &a = prev.commands[i], &b = next.commands[i];
+        if (!prev.equal(a, b, next))
+        {
+            damage.emplace_back(a.bounds);
+            if (!same(a.bounds, b.bounds))
+            {
+                damage.emplace_back(b.bounds);
+            }
+        }
+    }
+
+    /// The added or removed commands, the shift of the tail is already caught above
+    for (auto j = i; j < prev.commands.size(); ++j)
+    {
+        damage.emplace_back(prev.commands[j].bounds);
+    }
+    for (auto j = i; j < next.commands.size(); ++j)
+    {
+        damage.emplace_back(next.commands[j].bounds);
+    }
+}
+
+}
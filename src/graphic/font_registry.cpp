@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/graphic/font_registry.hpp>
+
+#include <map>
+#include <tuple>
+#include <string_view>
+#include <vector>
+#include <mutex>
+
+namespace wui
+{
+
+/// The fonts are not removed, the handles are kept by the display lists and the controls without the owning.
+/// The registry grows by the distinct fonts only, not by the calls
+static std::mutex registry_mutex;
+static std::vector<font> registry_fonts;
+static std::map<std::tuple<std::string, int32_t, decorations>, int32_t, std::less<>> registry_ids;
+
+font_handle intern_font(const font &font_)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+
+    /// The search by the name's view does not copy it
+    auto it = registry_ids.find(std::make_tuple(std::string_view(font_.name), font_.size, font_.decorations_));
+    if (it != registry_ids.end())
+    {
+        return font_handle{ it->second };
+    }
+
+    registry_fonts.emplace_back(font_);
+
+    auto id = static_cast<int32_t>(registry_fonts.size());
+    registry_ids.emplace(std::make_tuple(font_.name, font_.size, font_.decorations_), id);
+
+    return font_handle{ id };
+}
+
+font get_interned_font(font_handle handle)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+
+    if (handle.id > 0 && handle.id <= static_cast<int32_t>(registry_fonts.size()))
+    {
+        return registry_fonts[handle.id - 1];
+    }
+
+    return font();
+}
+
+}
@@ -8,13 +8,25 @@
 //
 
 #include <wui/graphic/graphic.hpp>
+#include <wui/graphic/font_registry.hpp>
 #include <wui/common/flag_helpers.hpp>
 #include <wui/system/tools.hpp>
+#include <wui/system/tracer.hpp>
 
 #include <boost/nowide/convert.hpp>
 
+#ifdef _WIN32
+#include <gdiplus.h>
+#endif
+
 #ifdef __linux__
 #include <xcb/xcb_image.h>
+#include <xcb/shm.h>
+
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include <cstring>
 
 #include <cairo.h>
 #include <cairo-xcb.h>
@@ -44,18 +56,49 @@ xcb_visualtype_t *default_visual_type(wui::system_context &context_)
 namespace wui
 {
 
+#ifdef __linux__
+/// The request's size is limited, the batches are split to the requests of this count
+static const size_t max_request_items = 16384;
+
+static inline int16_t xcb_coord(int32_t v)
+{
+    return static_cast<int16_t>((std::max)((std::min)(v, 32767), -32768));
+}
+#endif
+
 graphic::graphic(system_context &context__)
     : context_(context__),
       pc(context_),
       max_size(),
-      background_color(0)
+      background_color(0),
+      convert_buffer(),
+      text_buffer(),
+      batch_rects(),
+      batch_points(),
+      overdraw_tracking_(false),
+      overdraw(),
+      recording_list(nullptr),
+      last_font(),
+      last_font_handle{ 0 },
+      clip_{ 0 }
 #ifdef _WIN32
-    , mem_dc(0),
+    , wide_text_buffer(),
+      poly_points(),
+      mem_dc(0),
       mem_bitmap(0),
 #elif __linux__
-    , mem_pixmap(0),
+    , poly_points(),
+      poly_segments(),
+      mem_pixmap(0),
       surface(nullptr),
       device(nullptr),
+      shm_checked(false),
+      shm_available(false),
+      shm_segment(0),
+      shm_data(nullptr),
+      shm_size(0),
+      shm_pending(false),
+      shm_put_cookie(),
 #endif
     err{}
 {
@@ -70,6 +113,7 @@ bool graphic::init(const rect &max_size_, color background_color_)
 {
     max_size = max_size_;
     background_color = background_color_;
+    clip_ = { 0 };
 
 #ifdef _WIN32
     if (mem_dc)
@@ -106,7 +150,7 @@ bool graphic::init(const rect &max_size_, color background_color_)
 
     ReleaseDC(context_.hwnd, wnd_dc);
 #elif __linux__
-    if (!context_.display || mem_pixmap)
+    if (!context_.display || mem_pixmap || surface)
     {
         err.type = error_type::already_runned;
         err.component = "graphic::init()";
@@ -149,6 +193,83 @@ bool graphic::init(const rect &max_size_, color background_color_)
     return true;
 }
 
+bool graphic::init_image(const rect &max_size_, color background_color_)
+{
+    max_size = max_size_;
+    background_color = background_color_;
+    clip_ = { 0 };
+
+#ifdef _WIN32
+    if (mem_dc)
+    {
+        err.type = error_type::already_runned;
+        err.component = "graphic::init_image()";
+        return false;
+    }
+
+    err.reset();
+
+    mem_dc = CreateCompatibleDC(NULL);
+
+    BITMAPINFO bmi = { 0 };
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = max_size.width();
+    bmi.bmiHeader.biHeight = -max_size.height();
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void *bits = nullptr;
+    mem_bitmap = CreateDIBSection(mem_dc, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (!mem_bitmap)
+    {
+        err.type = error_type::no_handle;
+        err.component = "graphic::init_image()";
+        err.message = "CreateDIBSection returns null";
+
+        DeleteDC(mem_dc);
+        mem_dc = 0;
+
+        return false;
+    }
+
+    SelectObject(mem_dc, mem_bitmap);
+
+    SetMapMode(mem_dc, MM_TEXT);
+
+    RECT filling_rect = { 0, 0, max_size.width(), max_size.height() };
+    FillRect(mem_dc, &filling_rect, pc.get_brush(background_color));
+#elif __linux__
+    if (surface)
+    {
+        err.type = error_type::already_runned;
+        err.component = "graphic::init_image()";
+        return false;
+    }
+
+    err.reset();
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, max_size.width(), max_size.height());
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS)
+    {
+        cairo_surface_destroy(surface);
+        surface = nullptr;
+
+        err.type = error_type::no_handle;
+        err.component = "graphic::init_image() cairo_image_surface_create";
+        err.message = "Can't create the cairo image surface";
+
+        return false;
+    }
+
+    clear(max_size_);
+#endif
+
+    pc.init();
+
+    return true;
+}
+
 void graphic::release()
 {
 #ifdef _WIN32
@@ -158,6 +279,8 @@ void graphic::release()
     DeleteDC(mem_dc);
     mem_dc = 0;
 #elif __linux__
+    release_shm();
+
     if (surface)
     {
         cairo_surface_destroy(surface);
@@ -184,6 +307,13 @@ void graphic::set_background_color(color background_color_)
 
 void graphic::clear(const rect &position)
 {
+    if (recording_list)
+    {
+        return recording_list->add_clear(position);
+    }
+
+    track_write(position);
+
 #ifdef _WIN32
     if (!mem_dc)
     {
@@ -193,12 +323,13 @@ void graphic::clear(const rect &position)
     RECT filling_rect = { position.left, position.top, position.right, position.bottom };
     FillRect(mem_dc, &filling_rect, pc.get_brush(background_color));
 #elif __linux__
-    if (!mem_pixmap)
+    if (!surface)
     {
         return;
     }
 
     auto cr = cairo_create(surface);
+    clip_context(cr);
 
     cairo_set_source_rgb(cr, static_cast<double>(wui::get_red(background_color)) / 255,
         static_cast<double>(wui::get_green(background_color)) / 255,
@@ -212,6 +343,8 @@ void graphic::clear(const rect &position)
 
 void graphic::flush(const rect &updated_size)
 {
+    tracer::span span_("graphic::flush", "paint");
+
 #ifdef _WIN32
     auto wnd_dc = GetDC(context_.hwnd);
 
@@ -230,7 +363,7 @@ void graphic::flush(const rect &updated_size)
 
     ReleaseDC(context_.hwnd, wnd_dc);
 #elif __linux__
-    if (context_.wnd)
+    if (context_.wnd && mem_pixmap)
     {
         auto copy_area_cookie = xcb_copy_area(context_.connection,
             mem_pixmap,
@@ -253,16 +386,51 @@ void graphic::flush(const rect &updated_size)
 
 void graphic::draw_pixel(const rect &position, color color_)
 {
+    if (recording_list)
+    {
+        return recording_list->add_pixel(position, color_);
+    }
+
+    track_write({ position.left, position.top, position.left, position.top });
+
 #ifdef _WIN32
     SetPixel(mem_dc, position.left, position.top, color_);
 #elif __linux__
+    if (!mem_pixmap)
+    {
+        auto cr = cairo_create(surface);
+        clip_context(cr);
+
+        cairo_set_source_rgb(cr, static_cast<double>(wui::get_red(color_)) / 255,
+            static_cast<double>(wui::get_green(color_)) / 255,
+            static_cast<double>(wui::get_blue(color_)) / 255);
+        cairo_rectangle(cr, position.left, position.top, 1, 1);
+        cairo_fill(cr);
+
+        cairo_destroy(cr);
+
+        return;
+    }
+
+    auto gc = pc.get_gc(color_);
+    clip_gc(gc);
+
     xcb_point_t points[] = { { static_cast<int16_t>(position.left), static_cast<int16_t>(position.top) } };
-    xcb_poly_point(context_.connection, XCB_COORD_MODE_ORIGIN, mem_pixmap, pc.get_gc(color_), 1, points);
+    xcb_poly_point(context_.connection, XCB_COORD_MODE_ORIGIN, mem_pixmap, gc, 1, points);
+
+    unclip_gc(gc);
 #endif
 }
 
 void graphic::draw_line(const rect &position, color color_, uint32_t width)
 {
+    if (recording_list)
+    {
+        return recording_list->add_line(position, color_, width);
+    }
+
+    track_write(position);
+
 #ifdef _WIN32
     auto old_pen = (HPEN)SelectObject(mem_dc, pc.get_pen(PS_SOLID, width, color_));
 
@@ -271,141 +439,508 @@ void graphic::draw_line(const rect &position, color color_, uint32_t width)
 
     SelectObject(mem_dc, old_pen);
 #elif __linux__
+    if (!mem_pixmap)
+    {
+        /// The same one pixel line as the pixmap's gc draws, so the image and the pixmap look equal
+        auto cr = cairo_create(surface);
+        clip_context(cr);
+
+        cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
+        cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+        cairo_set_line_width(cr, 1);
+        cairo_set_source_rgb(cr, static_cast<double>(wui::get_red(color_)) / 255,
+            static_cast<double>(wui::get_green(color_)) / 255,
+            static_cast<double>(wui::get_blue(color_)) / 255);
+        cairo_move_to(cr, position.left + 0.5, position.top + 0.5);
+        cairo_line_to(cr, position.right + 0.5, position.bottom + 0.5);
+        cairo_stroke(cr);
+
+        cairo_destroy(cr);
+
+        return;
+    }
+
+    auto gc = pc.get_gc(color_);
+    clip_gc(gc);
+
     xcb_point_t polyline[] = { { static_cast<int16_t>(position.left), static_cast<int16_t>(position.top) },
         { static_cast<int16_t>(position.right), static_cast<int16_t>(position.bottom) } };
-    xcb_poly_line(context_.connection, XCB_COORD_MODE_ORIGIN, mem_pixmap, pc.get_gc(color_), 2, polyline);
+    xcb_poly_line(context_.connection, XCB_COORD_MODE_ORIGIN, mem_pixmap, gc, 2, polyline);
+
+    unclip_gc(gc);
 #endif
 }
 
-rect graphic::measure_text(std::string_view text_, const font &font__)
+void graphic::draw_polyline(const point *points, size_t count, color color_, uint32_t width)
 {
+    if (count < 2)
+    {
+        return;
+    }
+
+    if (recording_list)
+    {
+        return recording_list->add_polyline(points, count, color_, width);
+    }
+
+    if (overdraw_tracking_)
+    {
+        rect bounds = { points[0].x, points[0].y, points[0].x, points[0].y };
+        for (size_t i = 1; i != count; ++i)
+        {
+            bounds = { (std::min)(bounds.left, points[i].x), (std::min)(bounds.top, points[i].y),
+                (std::max)(bounds.right, points[i].x), (std::max)(bounds.bottom, points[i].y) };
+        }
+        overdraw.add_write(bounds);
+    }
+
 #ifdef _WIN32
-    auto old_font = (HFONT)SelectObject(mem_dc, pc.get_font(font__));
+    poly_points.resize(count);
+    for (size_t i = 0; i != count; ++i)
+    {
+        poly_points[i] = { points[i].x, points[i].y };
+    }
 
-    RECT text_rect = { 0 };
-    auto wide_str = boost::nowide::widen(text_);
-    DrawTextW(mem_dc, wide_str.c_str(), static_cast<int32_t>(wide_str.size()), &text_rect, DT_CALCRECT);
+    auto old_pen = (HPEN)SelectObject(mem_dc, pc.get_pen(PS_SOLID, width, color_));
 
-    SelectObject(mem_dc, old_font);
+    Polyline(mem_dc, poly_points.data(), static_cast<int>(count));
 
-    return {0, 0, text_rect.right, text_rect.bottom};
+    SelectObject(mem_dc, old_pen);
 #elif __linux__
-    if (!surface)
+    if (!mem_pixmap)
     {
-        err.type = error_type::no_handle;
-        err.component = "graphic::measure_text()";
-        err.message = "No cairo surface";
-        return rect{ 0 };
+        /// The one path is stroked, drawn without antialiasing like draw_line()
+        auto cr = cairo_create(surface);
+        clip_context(cr);
+
+        cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
+        cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+        cairo_set_line_join(cr, CAIRO_LINE_JOIN_BEVEL);
+        cairo_set_line_width(cr, width != 0 ? width : 1);
+        cairo_set_source_rgb(cr, static_cast<double>(wui::get_red(color_)) / 255,
+            static_cast<double>(wui::get_green(color_)) / 255,
+            static_cast<double>(wui::get_blue(color_)) / 255);
+
+        cairo_move_to(cr, points[0].x + 0.5, points[0].y + 0.5);
+        for (size_t i = 1; i != count; ++i)
+        {
+            cairo_line_to(cr, points[i].x + 0.5, points[i].y + 0.5);
+        }
+        cairo_stroke(cr);
+
+        cairo_destroy(cr);
+
+        return;
     }
 
-    auto cr = pc.get_font(font__, surface);
-    if (!cr)
+    poly_points.resize(count);
+    for (size_t i = 0; i != count; ++i)
     {
-        err.type = error_type::no_handle;
-        err.component = "graphic::measure_text()";
-        err.message = "No cairo font context";
-        return rect{ 0 };
+        poly_points[i] = { xcb_coord(points[i].x), xcb_coord(points[i].y) };
     }
 
-    cairo_text_extents_t extents;
+    auto gc = pc.get_gc(color_);
+    clip_gc(gc);
 
-    std::string text__(text_.begin(), text_.end());
-    std::replace(text__.begin(), text__.end(), ' ', 't');
+    if (width > 1)
+    {
+        uint32_t line_width = width;
+        xcb_change_gc(context_.connection, gc, XCB_GC_LINE_WIDTH, &line_width);
+    }
 
-    cairo_text_extents(cr, text__.c_str(), &extents);
+    /// The next part starts from the last point of the previous one
+    for (size_t start = 0; start + 1 < count; start += max_request_items - 1)
+    {
+        auto part = (std::min)(count - start, max_request_items);
+        xcb_poly_line(context_.connection, XCB_COORD_MODE_ORIGIN, mem_pixmap, gc, static_cast<uint32_t>(part), poly_points.data() + start);
+    }
 
-    return { 0, 0, static_cast<int32_t>(ceil(extents.width)), static_cast<int32_t>(ceil(extents.height)) };
+    if (width > 1)
+    {
+        uint32_t line_width = 0;
+        xcb_change_gc(context_.connection, gc, XCB_GC_LINE_WIDTH, &line_width);
+    }
+
+    unclip_gc(gc);
 #endif
 }
 
-void graphic::draw_text(const rect &position, std::string_view text_, color color_, const font &font__)
+void graphic::draw_pixels(const point *points, size_t count, color color_)
 {
-#ifdef _WIN32
-    auto old_font = (HFONT)SelectObject(mem_dc, pc.get_font(font__));
-    
-    SetTextColor(mem_dc, color_);
-    SetBkMode(mem_dc, TRANSPARENT);
+    if (count == 0)
+    {
+        return;
+    }
 
-    auto wide_str = boost::nowide::widen(text_);
-    TextOutW(mem_dc, position.left, position.top, wide_str.c_str(), static_cast<int32_t>(wide_str.size()));
+    if (recording_list)
+    {
+        return recording_list->add_pixels(points, count, color_);
+    }
 
-    SelectObject(mem_dc, old_font);
+    if (overdraw_tracking_)
+    {
+        for (size_t i = 0; i != count; ++i)
+        {
+            overdraw.add_write({ points[i].x, points[i].y, points[i].x, points[i].y });
+        }
+    }
+
+#ifdef _WIN32
+    for (size_t i = 0; i != count; ++i)
+    {
+        SetPixel(mem_dc, points[i].x, points[i].y, color_);
+    }
 #elif __linux__
-    if (!surface)
+    if (!mem_pixmap)
     {
-        err.type = error_type::no_handle;
-        err.component = "graphic::draw_text()";
-        err.message = "No cairo surface";
+        auto cr = cairo_create(surface);
+        clip_context(cr);
+
+        cairo_set_source_rgb(cr, static_cast<double>(wui::get_red(color_)) / 255,
+            static_cast<double>(wui::get_green(color_)) / 255,
+            static_cast<double>(wui::get_blue(color_)) / 255);
+        for (size_t i = 0; i != count; ++i)
+        {
+            cairo_rectangle(cr, points[i].x, points[i].y, 1, 1);
+        }
+        cairo_fill(cr);
+
+        cairo_destroy(cr);
+
         return;
     }
 
-    auto cr = pc.get_font(font__, surface);
-    if (!cr)
+    poly_points.resize(count);
+    for (size_t i = 0; i != count; ++i)
     {
-        err.type = error_type::no_handle;
-        err.component = "graphic::draw_text()";
-        err.message = "No cairo font context";
-        return;
+        poly_points[i] = { xcb_coord(points[i].x), xcb_coord(points[i].y) };
     }
 
-    cairo_set_source_rgb(cr,
-        static_cast<double>(wui::get_red(color_)) / 255,
-        static_cast<double>(wui::get_green(color_)) / 255,
-        static_cast<double>(wui::get_blue(color_)) / 255);
+    auto gc = pc.get_gc(color_);
+    clip_gc(gc);
 
-    cairo_move_to(cr, position.left, (double)position.top + font__.size * 5 / 6);
-    
-    std::string text__(text_); /// Workaround to prevent crashes
-    text__ += '\0';
-    
-    cairo_show_text(cr, text__.c_str());
+    for (size_t start = 0; start < count; start += max_request_items)
+    {
+        auto part = (std::min)(count - start, max_request_items);
+        xcb_poly_point(context_.connection, XCB_COORD_MODE_ORIGIN, mem_pixmap, gc, static_cast<uint32_t>(part), poly_points.data() + start);
+    }
+
+    unclip_gc(gc);
 #endif
 }
 
-void graphic::draw_rect(const rect &position, color fill_color)
+void graphic::draw_lines(const rect *positions, size_t count, color color_)
 {
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (recording_list)
+    {
+        return recording_list->add_lines(positions, count, color_);
+    }
+
+    if (overdraw_tracking_)
+    {
+        for (size_t i = 0; i != count; ++i)
+        {
+            overdraw.add_write(positions[i]);
+        }
+    }
+
 #ifdef _WIN32
-    RECT position_rect = { position.left, position.top, position.right, position.bottom };
-    FillRect(mem_dc, &position_rect, pc.get_brush(fill_color));
+    auto old_pen = (HPEN)SelectObject(mem_dc, pc.get_pen(PS_SOLID, 1, color_));
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        MoveToEx(mem_dc, positions[i].left, positions[i].top, (LPPOINT)NULL);
+        LineTo(mem_dc, positions[i].right, positions[i].bottom);
+    }
+
+    SelectObject(mem_dc, old_pen);
 #elif __linux__
-    auto pos = position;
-    if (pos.left > pos.right)
+    if (!mem_pixmap)
     {
-        std::swap(pos.left, pos.right);
+        auto cr = cairo_create(surface);
+        clip_context(cr);
+
+        cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
+        cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+        cairo_set_line_width(cr, 1);
+        cairo_set_source_rgb(cr, static_cast<double>(wui::get_red(color_)) / 255,
+            static_cast<double>(wui::get_green(color_)) / 255,
+            static_cast<double>(wui::get_blue(color_)) / 255);
+        for (size_t i = 0; i != count; ++i)
+        {
+            cairo_move_to(cr, positions[i].left + 0.5, positions[i].top + 0.5);
+            cairo_line_to(cr, positions[i].right + 0.5, positions[i].bottom + 0.5);
+        }
+        cairo_stroke(cr);
+
+        cairo_destroy(cr);
+
+        return;
     }
-    if (pos.top > pos.bottom)
+
+    poly_segments.resize(count);
+    for (size_t i = 0; i != count; ++i)
     {
-        std::swap(pos.top, pos.bottom);
+        poly_segments[i] = { xcb_coord(positions[i].left), xcb_coord(positions[i].top), xcb_coord(positions[i].right), xcb_coord(positions[i].bottom) };
     }
 
-    auto cr = cairo_create(surface);
+    auto gc = pc.get_gc(color_);
+    clip_gc(gc);
 
-    cairo_set_source_rgba(cr, static_cast<double>(wui::get_red(fill_color)) / 255,
-        static_cast<double>(wui::get_green(fill_color)) / 255,
-        static_cast<double>(wui::get_blue(fill_color)) / 255,
-        static_cast<double>(wui::get_alpha(fill_color)) / 255);
-    cairo_rectangle(cr, pos.left, pos.top, pos.width(), pos.height());
-    cairo_fill(cr);
+    for (size_t start = 0; start < count; start += max_request_items)
+    {
+        auto part = (std::min)(count - start, max_request_items);
+        xcb_poly_segment(context_.connection, mem_pixmap, gc, static_cast<uint32_t>(part), poly_segments.data() + start);
+    }
 
-    cairo_destroy(cr);
+    unclip_gc(gc);
 #endif
 }
 
-void graphic::draw_rect(const rect &position, color border_color, color fill_color, uint32_t border_width, uint32_t rnd)
+rect graphic::measure_text(std::string_view text_, const font &font__)
 {
 #ifdef _WIN32
-    auto old_pen = (HPEN)SelectObject(mem_dc, pc.get_pen(border_width != 0 ? PS_SOLID : PS_NULL, border_width, border_color));
+    return measure_text(text_, pc.get_font(font__));
+#elif __linux__
+    return measure_text(text_, surface ? pc.get_font(font__, surface) : nullptr);
+#endif
+}
 
-    auto old_brush = (HBRUSH)SelectObject(mem_dc, pc.get_brush(fill_color));
+rect graphic::measure_text(std::string_view text_, font_handle font__)
+{
+#ifdef _WIN32
+    return measure_text(text_, pc.get_font(font__));
+#elif __linux__
+    return measure_text(text_, surface ? pc.get_font(font__, surface) : nullptr);
+#endif
+}
 
-    RoundRect(mem_dc, position.left, position.top, position.right, position.bottom, rnd, rnd);
+void graphic::draw_text(const rect &position, std::string_view text_, color color_, const font &font__)
+{
+    if (recording_list)
+    {
+        if (!last_font_handle.valid() || last_font.size != font__.size || last_font.decorations_ != font__.decorations_ || last_font.name != font__.name)
+        {
+            last_font = font__;
+            last_font_handle = intern_font(font__);
+        }
+        return draw_text(position, text_, color_, last_font_handle);
+    }
 
-    SelectObject(mem_dc, old_brush);
+    if (overdraw_tracking_)
+    {
+        auto text_rect = measure_text(text_, font__);
+        text_rect.move(position.left, position.top);
+        overdraw.add_write(text_rect);
+    }
 
-    SelectObject(mem_dc, old_pen);
+#ifdef _WIN32
+    draw_text(position, text_, color_, pc.get_font(font__));
 #elif __linux__
+    draw_text(position, text_, color_, surface ? pc.get_font(font__, surface) : nullptr, font__.size);
+#endif
+}
+
+void graphic::draw_text(const rect &position, std::string_view text_, color color_, font_handle font__)
+{
+    if (recording_list)
+    {
+        auto text_rect = measure_text(text_, font__);
+        text_rect.move(position.left, position.top);
+        return recording_list->add_text(position, text_rect, text_, color_, font__);
+    }
+
+    if (overdraw_tracking_)
+    {
+        auto text_rect = measure_text(text_, font__);
+        text_rect.move(position.left, position.top);
+        overdraw.add_write(text_rect);
+    }
+
+#ifdef _WIN32
+    draw_text(position, text_, color_, pc.get_font(font__));
+#elif __linux__
+    auto cr = surface ? pc.get_font(font__, surface) : nullptr;
+    draw_text(position, text_, color_, cr, pc.get_font_size(font__));
+#endif
+}
+
+#ifdef _WIN32
+/// The wide buffer is reused between the calls to not allocate on every text
+static const wchar_t *widen_text(std::wstring &buffer, std::string_view text_, int32_t &length)
+{
+    buffer.resize(text_.size() + 1);
+    boost::nowide::widen(&buffer[0], buffer.size(), text_.data(), text_.data() + text_.size());
+    length = static_cast<int32_t>(wcslen(buffer.c_str()));
+
+    return buffer.c_str();
+}
+
+rect graphic::measure_text(std::string_view text_, HFONT font__)
+{
+    auto old_font = (HFONT)SelectObject(mem_dc, font__);
+
+    RECT text_rect = { 0 };
+    int32_t length = 0;
+    auto wide_str = widen_text(wide_text_buffer, text_, length);
+    DrawTextW(mem_dc, wide_str, length, &text_rect, DT_CALCRECT);
+
+    SelectObject(mem_dc, old_font);
+
+    return {0, 0, text_rect.right, text_rect.bottom};
+}
+
+void graphic::draw_text(const rect &position, std::string_view text_, color color_, HFONT font__)
+{
+    auto old_font = (HFONT)SelectObject(mem_dc, font__);
+    
+    SetTextColor(mem_dc, color_);
+    SetBkMode(mem_dc, TRANSPARENT);
+
+    int32_t length = 0;
+    auto wide_str = widen_text(wide_text_buffer, text_, length);
+    TextOutW(mem_dc, position.left, position.top, wide_str, length);
+
+    SelectObject(mem_dc, old_font);
+}
+#elif __linux__
+rect graphic::measure_text(std::string_view text_, _cairo *cr)
+{
+    if (!surface)
+    {
+        err.type = error_type::no_handle;
+        err.component = "graphic::measure_text()";
+        err.message = "No cairo surface";
+        return rect{ 0 };
+    }
+
+    if (!cr)
+    {
+        err.type = error_type::no_handle;
+        err.component = "graphic::measure_text()";
+        err.message = "No cairo font context";
+        return rect{ 0 };
+    }
+
+    cairo_text_extents_t extents;
+
+    /// The buffer is reused between the calls to not allocate on every text
+    text_buffer.assign(text_.begin(), text_.end());
+    std::replace(text_buffer.begin(), text_buffer.end(), ' ', 't');
+
+    cairo_text_extents(cr, text_buffer.c_str(), &extents);
+
+    return { 0, 0, static_cast<int32_t>(ceil(extents.width)), static_cast<int32_t>(ceil(extents.height)) };
+}
+
+void graphic::draw_text(const rect &position, std::string_view text_, color color_, _cairo *cr, int32_t font_size)
+{
+    if (!surface)
+    {
+        err.type = error_type::no_handle;
+        err.component = "graphic::draw_text()";
+        err.message = "No cairo surface";
+        return;
+    }
+
+    if (!cr)
+    {
+        err.type = error_type::no_handle;
+        err.component = "graphic::draw_text()";
+        err.message = "No cairo font context";
+        return;
+    }
+
+    cairo_set_source_rgb(cr,
+        static_cast<double>(wui::get_red(color_)) / 255,
+        static_cast<double>(wui::get_green(color_)) / 255,
+        static_cast<double>(wui::get_blue(color_)) / 255);
+
+    /// The font context is cached, so the clip is removed after the drawing
+    if (!clip_.is_null())
+    {
+        cairo_save(cr);
+        clip_context(cr);
+    }
+
+    cairo_move_to(cr, position.left, (double)position.top + font_size * 5 / 6);
+    
+    text_buffer.assign(text_.begin(), text_.end()); /// Workaround to prevent crashes, the text must be zero terminated
+    
+    cairo_show_text(cr, text_buffer.c_str());
+
+    if (!clip_.is_null())
+    {
+        cairo_restore(cr);
+    }
+}
+#endif
+
+void graphic::draw_rect(const rect &position, color fill_color)
+{
+    if (recording_list)
+    {
+        return recording_list->add_rect(position, fill_color);
+    }
+
+    track_write(position);
+
+#ifdef _WIN32
+    RECT position_rect = { position.left, position.top, position.right, position.bottom };
+    FillRect(mem_dc, &position_rect, pc.get_brush(fill_color));
+#elif __linux__
+    auto pos = position;
+    if (pos.left > pos.right)
+    {
+        std::swap(pos.left, pos.right);
+    }
+    if (pos.top > pos.bottom)
+    {
+        std::swap(pos.top, pos.bottom);
+    }
 
     auto cr = cairo_create(surface);
+    clip_context(cr);
+
+    cairo_set_source_rgba(cr, static_cast<double>(wui::get_red(fill_color)) / 255,
+        static_cast<double>(wui::get_green(fill_color)) / 255,
+        static_cast<double>(wui::get_blue(fill_color)) / 255,
+        static_cast<double>(wui::get_alpha(fill_color)) / 255);
+    cairo_rectangle(cr, pos.left, pos.top, pos.width(), pos.height());
+    cairo_fill(cr);
+
+    cairo_destroy(cr);
+#endif
+}
+
+void graphic::draw_rect(const rect &position, color border_color, color fill_color, uint32_t border_width, uint32_t rnd)
+{
+    if (recording_list)
+    {
+        return recording_list->add_rect(position, border_color, fill_color, border_width, rnd);
+    }
+
+    track_write(position);
+
+#ifdef _WIN32
+    auto old_pen = (HPEN)SelectObject(mem_dc, pc.get_pen(border_width != 0 ? PS_SOLID : PS_NULL, border_width, border_color));
+
+    auto old_brush = (HBRUSH)SelectObject(mem_dc, pc.get_brush(fill_color));
+
+    RoundRect(mem_dc, position.left, position.top, position.right, position.bottom, rnd, rnd);
+
+    SelectObject(mem_dc, old_brush);
+
+    SelectObject(mem_dc, old_pen);
+#elif __linux__
+
+    auto cr = cairo_create(surface);
+    clip_context(cr);
 
     double l = position.left,
        t     = position.top,
@@ -462,8 +997,126 @@ void graphic::draw_rect(const rect &position, color border_color, color fill_col
 #endif
 }
 
+void graphic::draw_rects(const rect *positions, size_t count, color fill_color)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (recording_list)
+    {
+        return recording_list->add_rects(positions, count, fill_color);
+    }
+
+    if (overdraw_tracking_)
+    {
+        for (size_t i = 0; i != count; ++i)
+        {
+            overdraw.add_write(positions[i]);
+        }
+    }
+
+#ifdef _WIN32
+    auto brush = pc.get_brush(fill_color);
+    for (size_t i = 0; i != count; ++i)
+    {
+        RECT position_rect = { positions[i].left, positions[i].top, positions[i].right, positions[i].bottom };
+        FillRect(mem_dc, &position_rect, brush);
+    }
+#elif __linux__
+    /// All the rects are one path filled once
+    auto cr = cairo_create(surface);
+    clip_context(cr);
+
+    cairo_set_source_rgba(cr, static_cast<double>(wui::get_red(fill_color)) / 255,
+        static_cast<double>(wui::get_green(fill_color)) / 255,
+        static_cast<double>(wui::get_blue(fill_color)) / 255,
+        static_cast<double>(wui::get_alpha(fill_color)) / 255);
+    for (size_t i = 0; i != count; ++i)
+    {
+        auto pos = positions[i];
+        if (pos.left > pos.right)
+        {
+            std::swap(pos.left, pos.right);
+        }
+        if (pos.top > pos.bottom)
+        {
+            std::swap(pos.top, pos.bottom);
+        }
+        cairo_rectangle(cr, pos.left, pos.top, pos.width(), pos.height());
+    }
+    cairo_fill(cr);
+
+    cairo_destroy(cr);
+#endif
+}
+
+void graphic::draw_batch(const primitive_batch &batch)
+{
+    using kind = primitive_batch::kind;
+
+    auto &order = batch.sorted_items();
+
+    size_t i = 0;
+    while (i != order.size())
+    {
+        auto &first = batch.items[order[i]];
+
+        if (first.kind_ == kind::polyline)
+        {
+            draw_polyline(batch.points.data() + first.offset, first.count, first.color_);
+            ++i;
+            continue;
+        }
+
+        /// The items of the same kind and color are joined to the one call
+        batch_rects.clear();
+        batch_points.clear();
+
+        for (; i != order.size(); ++i)
+        {
+            auto &item = batch.items[order[i]];
+            if (item.kind_ != first.kind_ || item.color_ != first.color_)
+            {
+                break;
+            }
+
+            if (item.kind_ == kind::pixel)
+            {
+                batch_points.insert(batch_points.end(), batch.points.begin() + item.offset, batch.points.begin() + item.offset + item.count);
+            }
+            else
+            {
+                batch_rects.insert(batch_rects.end(), batch.rects.begin() + item.offset, batch.rects.begin() + item.offset + item.count);
+            }
+        }
+
+        switch (first.kind_)
+        {
+            case kind::rect:
+                draw_rects(batch_rects.data(), batch_rects.size(), first.color_);
+            break;
+            case kind::line:
+                draw_lines(batch_rects.data(), batch_rects.size(), first.color_);
+            break;
+            case kind::pixel:
+                draw_pixels(batch_points.data(), batch_points.size(), first.color_);
+            break;
+            default: break;
+        }
+    }
+}
+
 void graphic::draw_buffer(const rect &position, uint8_t *buffer, int32_t left_shift, int32_t top_shift)
 {
+    if (recording_list)
+    {
+        return recording_list->add_buffer(position, buffer, left_shift, top_shift);
+    }
+
+    track_write(position);
+
 #ifdef _WIN32
     auto source_bitmap = pc.get_bitmap(position.width(), position.height(), buffer, mem_dc);
     auto source_dc = CreateCompatibleDC(mem_dc);
@@ -481,6 +1134,45 @@ void graphic::draw_buffer(const rect &position, uint8_t *buffer, int32_t left_sh
 
     DeleteDC(source_dc);
 #elif __linux__
+    if (shm_data && buffer == shm_data && static_cast<size_t>(position.width()) * position.height() * 4 > shm_size)
+    {
+        err.type = error_type::invalid_value;
+        err.component = "graphic::draw_buffer()";
+        err.message = "the shared buffer is smaller than the position";
+
+        return;
+    }
+
+    if (!mem_pixmap)
+    {
+        if (!surface || position.width() <= 0 || position.height() <= 0)
+        {
+            return;
+        }
+
+        auto source = cairo_image_surface_create_for_data(buffer, CAIRO_FORMAT_RGB24, position.width(), position.height(), position.width() * 4);
+
+        auto cr = cairo_create(surface);
+        clip_context(cr);
+
+        cairo_rectangle(cr, position.left, position.top, position.width(), position.height());
+        cairo_clip(cr);
+
+        cairo_set_source_surface(cr, source, position.left - left_shift, position.top - top_shift);
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_paint(cr);
+
+        cairo_destroy(cr);
+        cairo_surface_destroy(source);
+
+        return;
+    }
+
+    if (draw_buffer_shm(position, buffer, left_shift, top_shift))
+    {
+        return;
+    }
+
     auto pixmap = xcb_generate_id(context_.connection);
     auto pixmap_cookie = xcb_create_pixmap(context_.connection,
         context_.screen->root_depth,
@@ -512,14 +1204,18 @@ void graphic::draw_buffer(const rect &position, uint8_t *buffer, int32_t left_sh
 
     image->data = buffer;
 
-    xcb_image_put(context_.connection, pixmap, pc.get_gc(background_color), image, 0, 0, 0);
+    auto gc = pc.get_gc(background_color);
+
+    xcb_image_put(context_.connection, pixmap, gc, image, 0, 0, 0);
 
     xcb_image_destroy(image);
 
+    clip_gc(gc);
+
     auto copy_area_cookie = xcb_copy_area(context_.connection,
         pixmap,
         mem_pixmap,
-        pc.get_gc(background_color),
+        gc,
         left_shift,
         top_shift,
         position.left,
@@ -527,6 +1223,8 @@ void graphic::draw_buffer(const rect &position, uint8_t *buffer, int32_t left_sh
         position.right,
         position.bottom);
 
+    unclip_gc(gc);
+
     xcb_free_pixmap(context_.connection, pixmap);
 
     if (!check_cookie(copy_area_cookie, context_.connection, err, "graphic::draw_buffer() xcb_copy_area"))
@@ -536,8 +1234,200 @@ void graphic::draw_buffer(const rect &position, uint8_t *buffer, int32_t left_sh
 #endif
 }
 
+void graphic::draw_buffer(const rect &position, const uint8_t *buffer, pixel_format format, int32_t stride, int32_t left_shift, int32_t top_shift, bool premultiply)
+{
+    if (recording_list)
+    {
+        return recording_list->add_buffer(position, buffer, format, stride, left_shift, top_shift, premultiply);
+    }
+
+    auto width = position.width(), height = position.height();
+    if (!buffer || width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    uint8_t *native_buffer = nullptr;
+#ifdef __linux__
+    /// Converting directly to the shm segment saves the copy in draw_buffer()
+    native_buffer = shared_buffer(width, height);
+#endif
+    if (!native_buffer)
+    {
+        convert_buffer.resize(static_cast<size_t>(width) * height * 4);
+        native_buffer = convert_buffer.data();
+    }
+
+    convert_pixels(buffer, stride, format, native_buffer, width, height, premultiply);
+
+    draw_buffer(position, native_buffer, left_shift, top_shift);
+}
+
+#ifdef __linux__
+bool graphic::prepare_shm(size_t size)
+{
+    if (!shm_checked)
+    {
+        shm_checked = true;
+
+        auto ext = xcb_get_extension_data(context_.connection, &xcb_shm_id);
+        if (ext && ext->present)
+        {
+            auto version = xcb_shm_query_version_reply(context_.connection, xcb_shm_query_version(context_.connection), nullptr);
+            shm_available = version != nullptr;
+            free(version);
+        }
+    }
+
+    if (!shm_available)
+    {
+        return false;
+    }
+
+    if (shm_data && shm_size >= size)
+    {
+        return true;
+    }
+
+    release_shm();
+
+    auto shm_id = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+    if (shm_id == -1)
+    {
+        shm_available = false;
+        return false;
+    }
+
+    auto data = shmat(shm_id, nullptr, 0);
+    if (data == reinterpret_cast<void*>(-1))
+    {
+        shmctl(shm_id, IPC_RMID, nullptr);
+        shm_available = false;
+        return false;
+    }
+
+    shm_segment = xcb_generate_id(context_.connection);
+
+    /// The server can be on the other host, in this case attaching fails and the socket path is used
+    error attach_err;
+    auto attached = check_cookie(xcb_shm_attach_checked(context_.connection, shm_segment, shm_id, 0), context_.connection, attach_err, "graphic::prepare_shm() xcb_shm_attach");
+
+    /// The segment will be removed by the system after the last detach
+    shmctl(shm_id, IPC_RMID, nullptr);
+
+    if (!attached)
+    {
+        shmdt(data);
+        shm_segment = 0;
+        shm_available = false;
+        return false;
+    }
+
+    shm_data = static_cast<uint8_t*>(data);
+    shm_size = size;
+
+    return true;
+}
+
+void graphic::release_shm()
+{
+    if (shm_data)
+    {
+        wait_shm();
+
+        xcb_shm_detach(context_.connection, shm_segment);
+        shmdt(shm_data);
+
+        shm_data = nullptr;
+        shm_segment = 0;
+        shm_size = 0;
+    }
+}
+
+bool graphic::draw_buffer_shm(const rect &position, uint8_t *buffer, int32_t left_shift, int32_t top_shift)
+{
+    auto buffer_size = static_cast<size_t>(position.width()) * position.height() * 4;
+
+    if (!mem_pixmap || buffer_size == 0 || !prepare_shm(buffer_size))
+    {
+        return false;
+    }
+
+    if (buffer != shm_data)
+    {
+        wait_shm();
+        if (!shm_available)
+        {
+            return false;
+        }
+        memcpy(shm_data, buffer, buffer_size);
+    }
+
+    auto gc = pc.get_gc(background_color);
+    clip_gc(gc);
+
+    /// The put is not waited here. Its error is taken by wait_shm() before the next write of the segment,
+    /// by then the cookie is usually completed by the later round trip of the frame (end_drawing())
+    shm_put_cookie = xcb_shm_put_image_checked(context_.connection,
+        mem_pixmap,
+        gc,
+        position.width(), position.height(),
+        left_shift, top_shift,
+        position.width() - left_shift, position.height() - top_shift,
+        position.left, position.top,
+        context_.screen->root_depth,
+        XCB_IMAGE_FORMAT_Z_PIXMAP,
+        0,
+        shm_segment,
+        0);
+    shm_pending = true;
+
+    unclip_gc(gc);
+
+    return true;
+}
+
+void graphic::wait_shm()
+{
+    if (!shm_pending)
+    {
+        return;
+    }
+    shm_pending = false;
+
+    /// The completed put also means the server has read the segment, so it can be refilled
+    error put_err;
+    if (!check_cookie(shm_put_cookie, context_.connection, put_err, "graphic::draw_buffer() xcb_shm_put_image"))
+    {
+        /// The next buffers are sent by the socket, the segment is kept mapped until release()
+        shm_available = false;
+        err = put_err;
+    }
+}
+
+uint8_t *graphic::shared_buffer(int32_t width, int32_t height)
+{
+    if (!mem_pixmap || width <= 0 || height <= 0 || !prepare_shm(static_cast<size_t>(width) * height * 4))
+    {
+        return nullptr;
+    }
+
+    wait_shm();
+
+    return shm_available ? shm_data : nullptr;
+}
+#endif
+
 void graphic::draw_graphic(const rect &position, graphic &graphic_, int32_t left_shift, int32_t top_shift)
 {
+    if (recording_list)
+    {
+        return recording_list->add_graphic(position, graphic_, left_shift, top_shift);
+    }
+
+    /// position's right and bottom are the width and height here
+    track_write({ position.left, position.top, position.left + position.right, position.top + position.bottom });
+
 #ifdef _WIN32
     if (graphic_.drawable())
     {
@@ -552,12 +1442,15 @@ void graphic::draw_graphic(const rect &position, graphic &graphic_, int32_t left
             SRCCOPY);
     }
 #elif __linux__
-    if (graphic_.drawable())
+    if (graphic_.drawable() && mem_pixmap)
     {
+        auto gc = pc.get_gc(background_color);
+        clip_gc(gc);
+
         auto copy_area_cookie = xcb_copy_area(context_.connection,
             graphic_.drawable(),
             mem_pixmap,
-            pc.get_gc(background_color),
+            gc,
             left_shift,
             top_shift,
             position.left,
@@ -565,11 +1458,30 @@ void graphic::draw_graphic(const rect &position, graphic &graphic_, int32_t left
             position.right,
             position.bottom);
 
+        unclip_gc(gc);
+
         if (!check_cookie(copy_area_cookie, context_.connection, err, "graphic::draw_graphic() xcb_copy_area"))
         {
             return;
         }
     }
+    else if (graphic_.surface && surface)
+    {
+        /// The image graphic is composited by cairo
+        cairo_surface_flush(graphic_.surface);
+
+        auto cr = cairo_create(surface);
+        clip_context(cr);
+
+        cairo_rectangle(cr, position.left, position.top, position.right, position.bottom);
+        cairo_clip(cr);
+
+        cairo_set_source_surface(cr, graphic_.surface, position.left - left_shift, position.top - top_shift);
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_paint(cr);
+
+        cairo_destroy(cr);
+    }
 #endif
 }
 
@@ -578,6 +1490,47 @@ HDC graphic::drawable()
 {
     return mem_dc;
 }
+
+void graphic::draw_surface(Gdiplus::Image &image, const rect &position__)
+{
+    if (recording_list)
+    {
+        return recording_list->add_surface(image, position__);
+    }
+
+    track_write(position__);
+
+    Gdiplus::Graphics gr(mem_dc);
+
+    gr.DrawImage(&image,
+        Gdiplus::Rect(position__.left, position__.top, position__.width(), position__.height()),
+        0, 0, image.GetWidth(), image.GetHeight(),
+        Gdiplus::UnitPixel,
+        nullptr);
+}
+
+void graphic::draw_surface(Gdiplus::Image &image, const rect &source, const rect &position__)
+{
+    if (recording_list)
+    {
+        return recording_list->add_surface(image, source, position__);
+    }
+
+    track_write(position__);
+
+    if (source.width() == 0 || source.height() == 0)
+    {
+        return;
+    }
+
+    Gdiplus::Graphics gr(mem_dc);
+
+    gr.DrawImage(&image,
+        Gdiplus::Rect(position__.left, position__.top, position__.width(), position__.height()),
+        source.left, source.top, source.width(), source.height(),
+        Gdiplus::UnitPixel,
+        nullptr);
+}
 #elif __linux__
 xcb_drawable_t graphic::drawable()
 {
@@ -605,7 +1558,15 @@ void graphic::end_cairo_device()
 
 void graphic::draw_surface(cairo_surface_t &surface_, const rect &position__)
 {
+    if (recording_list)
+    {
+        return recording_list->add_surface(surface_, position__);
+    }
+
+    track_write(position__);
+
     auto cr = cairo_create(surface);
+    clip_context(cr);
 
     auto surface_width = cairo_image_surface_get_width(&surface_);
     auto surface_height = cairo_image_surface_get_height(&surface_);
@@ -630,6 +1591,38 @@ void graphic::draw_surface(cairo_surface_t &surface_, const rect &position__)
     cairo_destroy(cr);
 }
 
+void graphic::draw_surface(cairo_surface_t &surface_, const rect &source, const rect &position__)
+{
+    if (recording_list)
+    {
+        return recording_list->add_surface(surface_, source, position__);
+    }
+
+    track_write(position__);
+
+    if (source.width() == 0 || source.height() == 0)
+    {
+        return;
+    }
+
+    auto cr = cairo_create(surface);
+    clip_context(cr);
+
+    cairo_rectangle(cr, position__.left, position__.top, position__.width(), position__.height());
+    cairo_clip(cr);
+
+    cairo_translate(cr, position__.left, position__.top);
+    cairo_scale(cr,
+        static_cast<double>(position__.width()) / source.width(),
+        static_cast<double>(position__.height()) / source.height());
+
+    cairo_set_source_surface(cr, &surface_, -source.left, -source.top);
+
+    cairo_paint(cr);
+
+    cairo_destroy(cr);
+}
+
 #endif
 
 error graphic::get_error() const
@@ -637,4 +1630,97 @@ error graphic::get_error() const
     return err;
 }
 
+std::vector<cache_stats> graphic::get_cache_stats() const
+{
+    return pc.get_stats();
+}
+
+void graphic::set_overdraw_tracking(bool yes)
+{
+    if (yes && overdraw.columns() == 0)
+    {
+        overdraw.resize(max_size.width(), max_size.height());
+    }
+    overdraw_tracking_ = yes;
+}
+
+bool graphic::overdraw_tracking() const
+{
+    return overdraw_tracking_;
+}
+
+overdraw_map &graphic::get_overdraw_map()
+{
+    return overdraw;
+}
+
+void graphic::begin_recording(display_list &list)
+{
+    list.clear();
+    recording_list = &list;
+}
+
+void graphic::end_recording()
+{
+    recording_list = nullptr;
+}
+
+bool graphic::recording() const
+{
+    return recording_list != nullptr;
+}
+
+void graphic::set_clip(const rect &area)
+{
+    clip_ = area;
+
+#ifdef _WIN32
+    if (!mem_dc)
+    {
+        return;
+    }
+
+    SelectClipRgn(mem_dc, NULL);
+    if (!clip_.is_null())
+    {
+        IntersectClipRect(mem_dc, clip_.left, clip_.top, clip_.right, clip_.bottom);
+    }
+#endif
+}
+
+rect graphic::clip() const
+{
+    return clip_;
+}
+
+#ifdef __linux__
+void graphic::clip_context(cairo_t *cr)
+{
+    if (!clip_.is_null())
+    {
+        cairo_rectangle(cr, clip_.left, clip_.top, clip_.width(), clip_.height());
+        cairo_clip(cr);
+    }
+}
+
+void graphic::clip_gc(xcb_gcontext_t gc)
+{
+    if (!clip_.is_null())
+    {
+        xcb_rectangle_t clip_rect = { static_cast<int16_t>(clip_.left), static_cast<int16_t>(clip_.top),
+            static_cast<uint16_t>(clip_.width()), static_cast<uint16_t>(clip_.height()) };
+        xcb_set_clip_rectangles(context_.connection, XCB_CLIP_ORDERING_UNSORTED, gc, 0, 0, 1, &clip_rect);
+    }
+}
+
+void graphic::unclip_gc(xcb_gcontext_t gc)
+{
+    if (!clip_.is_null())
+    {
+        uint32_t mask = XCB_NONE;
+        xcb_change_gc(context_.connection, gc, XCB_GC_CLIP_MASK, &mask);
+    }
+}
+#endif
+
 }
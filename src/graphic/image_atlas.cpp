@@ -0,0 +1,377 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/graphic/image_atlas.hpp>
+#include <wui/graphic/graphic.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef __linux__
+#include <cairo.h>
+#endif
+
+namespace wui
+{
+
+/// Border around each packed image filled by its edge pixels, so the scaled drawing samples
+/// the image's own edge instead of the neighbour or the transparent gap
+static const int32_t atlas_padding = 1;
+
+/// Minimal width of atlas, the images are placed on the shelves of this width
+static const int32_t atlas_min_width = 512;
+
+#ifdef _WIN32
+
+typedef Gdiplus::Bitmap *decoded_image;
+
+static decoded_image decode_image(const std::vector<uint8_t> &data)
+{
+    decoded_image img = nullptr;
+
+    HGLOBAL h_buffer = ::GlobalAlloc(GMEM_MOVEABLE, data.size());
+    if (h_buffer)
+    {
+        void* p_buffer = ::GlobalLock(h_buffer);
+        if (p_buffer)
+        {
+            CopyMemory(p_buffer, data.data(), data.size());
+
+            IStream* p_stream = NULL;
+            if (::CreateStreamOnHGlobal(h_buffer, FALSE, &p_stream) == S_OK)
+            {
+                img = Gdiplus::Bitmap::FromStream(p_stream);
+                p_stream->Release();
+            }
+
+            ::GlobalUnlock(p_buffer);
+        }
+        ::GlobalFree(h_buffer);
+    }
+
+    if (img && img->GetLastStatus() != Gdiplus::Ok)
+    {
+        delete img;
+        img = nullptr;
+    }
+
+    return img;
+}
+
+static int32_t image_width(decoded_image img) { return img->GetWidth(); }
+static int32_t image_height(decoded_image img) { return img->GetHeight(); }
+static void free_decoded(decoded_image img) { delete img; }
+
+#elif __linux__
+
+typedef cairo_surface_t *decoded_image;
+
+static decoded_image decode_image(const std::vector<uint8_t> &data_)
+{
+    struct png_reader_data
+    {
+        const uint8_t *data;
+        uint32_t size_left;
+    };
+
+    auto read_png_data = [](void *closure,
+        uint8_t *data,
+        uint32_t length) noexcept -> cairo_status_t
+    {
+        auto &reader_data = *reinterpret_cast<png_reader_data *>(closure);
+        if (reader_data.size_left < length)
+        {
+            return CAIRO_STATUS_READ_ERROR;
+        }
+
+        memcpy(data, reader_data.data, length);
+        reader_data.data += length;
+        reader_data.size_left -= length;
+
+        return CAIRO_STATUS_SUCCESS;
+    };
+
+    png_reader_data reader_data = { data_.data(), static_cast<uint32_t>(data_.size()) };
+    auto img = cairo_image_surface_create_from_png_stream(+read_png_data, &reader_data);
+    if (cairo_surface_status(img) != CAIRO_STATUS_SUCCESS)
+    {
+        cairo_surface_destroy(img);
+        return nullptr;
+    }
+
+    return img;
+}
+
+static int32_t image_width(decoded_image img) { return cairo_image_surface_get_width(img); }
+static int32_t image_height(decoded_image img) { return cairo_image_surface_get_height(img); }
+static void free_decoded(decoded_image img) { cairo_surface_destroy(img); }
+
+#endif
+
+/// Copy the border columns and rows of the image at place into its padding, the 32 bit pixels
+static void extrude_edges(uint8_t *data, int32_t stride, const rect &place)
+{
+    if (place.width() == 0 || place.height() == 0)
+    {
+        return;
+    }
+
+    auto pixel = [data, stride](int32_t x, int32_t y) { return reinterpret_cast<uint32_t*>(data + static_cast<ptrdiff_t>(y) * stride) + x; };
+
+    for (auto y = place.top; y != place.bottom; ++y)
+    {
+        for (int32_t k = 1; k <= atlas_padding; ++k)
+        {
+            *pixel(place.left - k, y) = *pixel(place.left, y);
+            *pixel(place.right - 1 + k, y) = *pixel(place.right - 1, y);
+        }
+    }
+
+    /// The rows are copied with the padding columns, so the corners are filled too
+    auto row_size = static_cast<size_t>(place.width() + atlas_padding * 2) * 4;
+    for (int32_t k = 1; k <= atlas_padding; ++k)
+    {
+        memcpy(pixel(place.left - atlas_padding, place.top - k), pixel(place.left - atlas_padding, place.top), row_size);
+        memcpy(pixel(place.left - atlas_padding, place.bottom - 1 + k), pixel(place.left - atlas_padding, place.bottom - 1), row_size);
+    }
+}
+
+image_atlas::image_atlas()
+    : rects(),
+    scale_(1.0),
+    surface(nullptr),
+    err{}
+{
+}
+
+image_atlas::~image_atlas()
+{
+    release();
+}
+
+void image_atlas::build(const std::map<std::string, std::vector<uint8_t>> &images, double scale__)
+{
+    release();
+    err.reset();
+
+    scale_ = scale__ > 0 ? scale__ : 1.0;
+
+    struct item
+    {
+        const std::string *name;
+        decoded_image img;
+        rect place;
+    };
+
+    std::vector<item> items;
+    items.reserve(images.size());
+
+    int32_t widest = 0;
+    for (auto &i : images)
+    {
+        if (i.second.empty())
+        {
+            continue;
+        }
+
+        auto img = decode_image(i.second);
+        if (!img)
+        {
+            err.type = error_type::invalid_value;
+            err.component = "image_atlas::build()";
+            err.message = "unable to decode image: " + i.first;
+            continue;
+        }
+
+        auto w = static_cast<int32_t>(std::ceil(image_width(img) * scale_));
+        auto h = static_cast<int32_t>(std::ceil(image_height(img) * scale_));
+
+        widest = (std::max)(widest, w);
+
+        items.push_back({ &i.first, img, rect{ 0, 0, w, h } });
+    }
+
+    if (items.empty())
+    {
+        return;
+    }
+
+    /// Shelf packing, the highest images goes first to keep the shelves dense
+    std::sort(items.begin(), items.end(), [](const item &a, const item &b) {
+        return a.place.bottom > b.place.bottom;
+    });
+
+    const int32_t atlas_width = (std::max)(atlas_min_width, widest + atlas_padding * 2);
+
+    /// Each cell is the image with its padding on all the sides
+    int32_t left = 0, top = 0, shelf_height = 0;
+    for (auto &i : items)
+    {
+        auto w = i.place.right + atlas_padding * 2, h = i.place.bottom + atlas_padding * 2;
+
+        if (left + w > atlas_width)
+        {
+            left = 0;
+            top += shelf_height;
+            shelf_height = 0;
+        }
+
+        i.place = rect{ left + atlas_padding, top + atlas_padding, left + w - atlas_padding, top + h - atlas_padding };
+
+        left += w;
+        shelf_height = (std::max)(shelf_height, h);
+    }
+
+    const int32_t atlas_height = top + shelf_height;
+
+#ifdef _WIN32
+    surface = new Gdiplus::Bitmap(atlas_width, atlas_height, PixelFormat32bppPARGB);
+
+    {
+        Gdiplus::Graphics gr(surface);
+        gr.Clear(Gdiplus::Color(0, 0, 0, 0));
+        gr.SetInterpolationMode(Gdiplus::InterpolationModeHighQualityBicubic);
+
+        for (auto &i : items)
+        {
+            gr.DrawImage(i.img,
+                Gdiplus::Rect(i.place.left, i.place.top, i.place.width(), i.place.height()),
+                0, 0, image_width(i.img), image_height(i.img),
+                Gdiplus::UnitPixel,
+                nullptr);
+        }
+    }
+
+    Gdiplus::BitmapData data;
+    Gdiplus::Rect all(0, 0, atlas_width, atlas_height);
+    if (surface->LockBits(&all, Gdiplus::ImageLockModeRead | Gdiplus::ImageLockModeWrite, PixelFormat32bppPARGB, &data) == Gdiplus::Ok)
+    {
+        for (auto &i : items)
+        {
+            extrude_edges(static_cast<uint8_t*>(data.Scan0), data.Stride, i.place);
+        }
+        surface->UnlockBits(&data);
+    }
+#elif __linux__
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, atlas_width, atlas_height);
+
+    auto cr = cairo_create(surface);
+
+    for (auto &i : items)
+    {
+        cairo_save(cr);
+
+        cairo_rectangle(cr, i.place.left, i.place.top, i.place.width(), i.place.height());
+        cairo_clip(cr);
+
+        cairo_translate(cr, i.place.left, i.place.top);
+        cairo_scale(cr,
+            static_cast<double>(i.place.width()) / image_width(i.img),
+            static_cast<double>(i.place.height()) / image_height(i.img));
+
+        cairo_set_source_surface(cr, i.img, 0, 0);
+        cairo_paint(cr);
+
+        cairo_restore(cr);
+    }
+
+    cairo_destroy(cr);
+    cairo_surface_flush(surface);
+
+    auto data = cairo_image_surface_get_data(surface);
+    if (data)
+    {
+        for (auto &i : items)
+        {
+            extrude_edges(data, cairo_image_surface_get_stride(surface), i.place);
+        }
+        cairo_surface_mark_dirty(surface);
+    }
+#endif
+
+    for (auto &i : items)
+    {
+        rects[*i.name] = i.place;
+        free_decoded(i.img);
+    }
+}
+
+void image_atlas::release()
+{
+    rects.clear();
+
+    if (surface)
+    {
+#ifdef _WIN32
+        delete surface;
+#elif __linux__
+        cairo_surface_destroy(surface);
+#endif
+        surface = nullptr;
+    }
+}
+
+rect image_atlas::find(std::string_view name) const
+{
+    auto it = rects.find(std::string(name));
+    if (it != rects.end())
+    {
+        return it->second;
+    }
+    return rect{ 0 };
+}
+
+void image_atlas::draw(graphic &gr_, const rect &source, const rect &position) const
+{
+    if (!surface || source.is_null())
+    {
+        return;
+    }
+
+    gr_.draw_surface(*surface, source, position);
+}
+
+double image_atlas::scale() const
+{
+    return scale_;
+}
+
+int32_t image_atlas::width() const
+{
+    if (surface)
+    {
+#ifdef _WIN32
+        return surface->GetWidth();
+#elif __linux__
+        return cairo_image_surface_get_width(surface);
+#endif
+    }
+    return 0;
+}
+
+int32_t image_atlas::height() const
+{
+    if (surface)
+    {
+#ifdef _WIN32
+        return surface->GetHeight();
+#elif __linux__
+        return cairo_image_surface_get_height(surface);
+#endif
+    }
+    return 0;
+}
+
+error image_atlas::get_error() const
+{
+    return err;
+}
+
+}
@@ -0,0 +1,128 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/graphic/overdraw_map.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+overdraw_map::overdraw_map()
+    : columns_(0), rows_(0),
+    writes(), depths(), repaints_()
+{
+}
+
+void overdraw_map::resize(int32_t width, int32_t height)
+{
+    columns_ = width > 0 ? (width + tile_size - 1) / tile_size : 0;
+    rows_ = height > 0 ? (height + tile_size - 1) / tile_size : 0;
+
+    reset();
+}
+
+void overdraw_map::reset()
+{
+    auto size = static_cast<size_t>(columns_) * rows_;
+
+    writes.assign(size, 0);
+    depths.assign(size, 0);
+    repaints_.assign(size, 0);
+}
+
+void overdraw_map::add_write(const rect &position)
+{
+    int32_t first_column = 0, first_row = 0, last_column = 0, last_row = 0;
+    if (!tiles(position, first_column, first_row, last_column, last_row))
+    {
+        return;
+    }
+
+    for (auto row = first_row; row <= last_row; ++row)
+    {
+        auto line = &writes[static_cast<size_t>(row) * columns_];
+        for (auto column = first_column; column <= last_column; ++column)
+        {
+            ++line[column];
+        }
+    }
+}
+
+void overdraw_map::add_flush(const rect &position)
+{
+    int32_t first_column = 0, first_row = 0, last_column = 0, last_row = 0;
+    if (!tiles(position, first_column, first_row, last_column, last_row))
+    {
+        return;
+    }
+
+    for (auto row = first_row; row <= last_row; ++row)
+    {
+        auto offset = static_cast<size_t>(row) * columns_;
+        for (auto column = first_column; column <= last_column; ++column)
+        {
+            depths[offset + column] = writes[offset + column];
+            writes[offset + column] = 0;
+            ++repaints_[offset + column];
+        }
+    }
+}
+
+int32_t overdraw_map::columns() const
+{
+    return columns_;
+}
+
+int32_t overdraw_map::rows() const
+{
+    return rows_;
+}
+
+uint32_t overdraw_map::repaints(int32_t column, int32_t row) const
+{
+    if (column < 0 || column >= columns_ || row < 0 || row >= rows_)
+    {
+        return 0;
+    }
+    return repaints_[static_cast<size_t>(row) * columns_ + column];
+}
+
+uint32_t overdraw_map::depth(int32_t column, int32_t row) const
+{
+    if (column < 0 || column >= columns_ || row < 0 || row >= rows_)
+    {
+        return 0;
+    }
+    return depths[static_cast<size_t>(row) * columns_ + column];
+}
+
+bool overdraw_map::tiles(const rect &position, int32_t &first_column, int32_t &first_row, int32_t &last_column, int32_t &last_row) const
+{
+    auto left = (std::min)(position.left, position.right), right = (std::max)(position.left, position.right);
+    auto top = (std::min)(position.top, position.bottom), bottom = (std::max)(position.top, position.bottom);
+
+    /// The lines and the pixels have zero size, they still touch the pixel at right, bottom
+    auto last_x = right > left ? right - 1 : right, last_y = bottom > top ? bottom - 1 : bottom;
+
+    if (columns_ == 0 || rows_ == 0 || last_x < 0 || last_y < 0)
+    {
+        return false;
+    }
+
+    first_column = (std::max)(left, 0) / tile_size;
+    first_row = (std::max)(top, 0) / tile_size;
+
+    last_column = (std::min)(last_x / tile_size, columns_ - 1);
+    last_row = (std::min)(last_y / tile_size, rows_ - 1);
+
+    return first_column <= last_column && first_row <= last_row;
+}
+
+}
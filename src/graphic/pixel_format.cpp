@@ -0,0 +1,347 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/graphic/pixel_format.hpp>
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define WUI_PIXEL_SIMD
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define WUI_TARGET_AVX2
+#else
+#define WUI_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#endif
+
+namespace wui
+{
+
+/// x * a / 255 with rounding, exact for all 8 bit values
+static inline uint8_t mul_div255(uint32_t x, uint32_t a)
+{
+    auto t = x * a + 128;
+    return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+}
+
+static void convert_row_scalar(const uint8_t *src, uint8_t *dst, int32_t width, pixel_format format, bool premultiply)
+{
+    for (int32_t x = 0; x != width; ++x)
+    {
+        uint8_t r = 0, g = 0, b = 0, a = 255;
+
+        switch (format)
+        {
+            case pixel_format::native:
+                b = src[0]; g = src[1]; r = src[2]; a = src[3];
+                src += 4;
+            break;
+            case pixel_format::rgba32:
+                r = src[0]; g = src[1]; b = src[2]; a = src[3];
+                src += 4;
+            break;
+            case pixel_format::rgb24:
+                r = src[0]; g = src[1]; b = src[2];
+                src += 3;
+            break;
+            case pixel_format::grey8:
+                r = g = b = src[0];
+                src += 1;
+            break;
+        }
+
+        if (premultiply && a != 255)
+        {
+            r = mul_div255(r, a);
+            g = mul_div255(g, a);
+            b = mul_div255(b, a);
+        }
+
+        dst[0] = b; dst[1] = g; dst[2] = r; dst[3] = a;
+        dst += 4;
+    }
+}
+
+#ifdef WUI_PIXEL_SIMD
+
+/// SSE2 is the baseline of x86_64, so these kernels are always available there
+
+static inline __m128i swap_rb_sse2(__m128i px)
+{
+    const __m128i ag_mask = _mm_set1_epi32(static_cast<int32_t>(0xFF00FF00));
+
+    auto rb = _mm_andnot_si128(ag_mask, px);
+    rb = _mm_or_si128(_mm_srli_epi32(rb, 16), _mm_slli_epi32(rb, 16));
+
+    return _mm_or_si128(rb, _mm_and_si128(px, ag_mask));
+}
+
+static inline __m128i premultiply_half_sse2(__m128i px16)
+{
+    /// Alpha lane is multiplied by 255 to stay unchanged
+    const __m128i alpha_lanes = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const __m128i round = _mm_set1_epi16(128);
+
+    auto a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    a = _mm_or_si128(a, alpha_lanes);
+
+    auto t = _mm_add_epi16(_mm_mullo_epi16(px16, a), round);
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+static inline __m128i premultiply_sse2(__m128i px)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    auto lo = premultiply_half_sse2(_mm_unpacklo_epi8(px, zero));
+    auto hi = premultiply_half_sse2(_mm_unpackhi_epi8(px, zero));
+
+    return _mm_packus_epi16(lo, hi);
+}
+
+static void convert_row_sse2(const uint8_t *src, uint8_t *dst, int32_t width, pixel_format format, bool premultiply)
+{
+    int32_t x = 0;
+
+    switch (format)
+    {
+        case pixel_format::native: case pixel_format::rgba32:
+            for (; x + 4 <= width; x += 4, src += 16, dst += 16)
+            {
+                auto px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                if (format == pixel_format::rgba32)
+                {
+                    px = swap_rb_sse2(px);
+                }
+                if (premultiply)
+                {
+                    px = premultiply_sse2(px);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), px);
+            }
+        break;
+        case pixel_format::grey8:
+        {
+            const __m128i ff = _mm_set1_epi8(-1);
+
+            for (; x + 16 <= width; x += 16, src += 16, dst += 64)
+            {
+                auto g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+
+                auto gg = _mm_unpacklo_epi8(g, g), ga = _mm_unpacklo_epi8(g, ff);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(gg, ga));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi16(gg, ga));
+
+                gg = _mm_unpackhi_epi8(g, g); ga = _mm_unpackhi_epi8(g, ff);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), _mm_unpacklo_epi16(gg, ga));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), _mm_unpackhi_epi16(gg, ga));
+            }
+        }
+        break;
+        case pixel_format::rgb24:
+            /// SSE2 has no byte shuffle, the 24 bit rows are converted by scalar code
+        break;
+    }
+
+    convert_row_scalar(src, dst, width - x, format, premultiply);
+}
+
+WUI_TARGET_AVX2 static inline __m256i swap_rb_avx2(__m256i px)
+{
+    const __m256i mask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+    return _mm256_shuffle_epi8(px, mask);
+}
+
+WUI_TARGET_AVX2 static inline __m256i premultiply_half_avx2(__m256i px16)
+{
+    const __m256i alpha_lanes = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0);
+    const __m256i round = _mm256_set1_epi16(128);
+
+    auto a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    a = _mm256_or_si256(a, alpha_lanes);
+
+    auto t = _mm256_add_epi16(_mm256_mullo_epi16(px16, a), round);
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+WUI_TARGET_AVX2 static inline __m256i premultiply_avx2(__m256i px)
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    /// unpack and pack work inside 128 bit lanes, so the pixel order is kept
+    auto lo = premultiply_half_avx2(_mm256_unpacklo_epi8(px, zero));
+    auto hi = premultiply_half_avx2(_mm256_unpackhi_epi8(px, zero));
+
+    return _mm256_packus_epi16(lo, hi);
+}
+
+WUI_TARGET_AVX2 static void convert_row_avx2(const uint8_t *src, uint8_t *dst, int32_t width, pixel_format format, bool premultiply)
+{
+    int32_t x = 0;
+
+    switch (format)
+    {
+        case pixel_format::native: case pixel_format::rgba32:
+            for (; x + 8 <= width; x += 8, src += 32, dst += 32)
+            {
+                auto px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+                if (format == pixel_format::rgba32)
+                {
+                    px = swap_rb_avx2(px);
+                }
+                if (premultiply)
+                {
+                    px = premultiply_avx2(px);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), px);
+            }
+        break;
+        case pixel_format::rgb24:
+        {
+            const __m256i mask = _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+                2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+            const __m256i alpha = _mm256_set1_epi32(static_cast<int32_t>(0xFF000000));
+
+            /// Every lane reads 16 bytes for 4 pixels, so the tail of 2 pixels is kept for the scalar code
+            for (; x + 10 <= width; x += 8, src += 24, dst += 32)
+            {
+                auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+
+                auto px = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+                px = _mm256_or_si256(_mm256_shuffle_epi8(px, mask), alpha);
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), px);
+            }
+        }
+        break;
+        case pixel_format::grey8:
+        {
+            const __m256i spread = _mm256_set1_epi32(0x00010101);
+            const __m256i alpha = _mm256_set1_epi32(static_cast<int32_t>(0xFF000000));
+
+            for (; x + 8 <= width; x += 8, src += 8, dst += 32)
+            {
+                auto g = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+                auto px = _mm256_or_si256(_mm256_mullo_epi32(g, spread), alpha);
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), px);
+            }
+        }
+        break;
+    }
+
+    convert_row_scalar(src, dst, width - x, format, premultiply);
+}
+
+static bool cpu_has_avx2()
+{
+#ifdef _MSC_VER
+    int info[4] = { 0 };
+
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+    {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+pixel_kernel best_pixel_kernel()
+{
+#ifdef WUI_PIXEL_SIMD
+    static const pixel_kernel best = cpu_has_avx2() ? pixel_kernel::avx2 : pixel_kernel::sse2;
+    return best;
+#else
+    return pixel_kernel::scalar;
+#endif
+}
+
+int32_t pixel_size(pixel_format format)
+{
+    switch (format)
+    {
+        case pixel_format::native: case pixel_format::rgba32: return 4;
+        case pixel_format::rgb24: return 3;
+        case pixel_format::grey8: return 1;
+    }
+    return 4;
+}
+
+void convert_pixels(const uint8_t *src, int32_t src_stride, pixel_format format,
+    uint8_t *dst, int32_t width, int32_t height,
+    bool premultiply,
+    pixel_kernel kernel)
+{
+    if (!src || !dst || width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    if (src_stride == 0)
+    {
+        src_stride = width * pixel_size(format);
+    }
+
+    /// Not supported kernel is replaced by the best available
+    auto best = best_pixel_kernel();
+    if (kernel == pixel_kernel::best || static_cast<int32_t>(kernel) > static_cast<int32_t>(best))
+    {
+        kernel = best;
+    }
+
+    if (format == pixel_format::native && !premultiply)
+    {
+        for (int32_t y = 0; y != height; ++y)
+        {
+            memcpy(dst + static_cast<size_t>(y) * width * 4, src + static_cast<size_t>(y) * src_stride, static_cast<size_t>(width) * 4);
+        }
+        return;
+    }
+
+    auto convert_row = convert_row_scalar;
+#ifdef WUI_PIXEL_SIMD
+    if (kernel == pixel_kernel::avx2)
+    {
+        convert_row = convert_row_avx2;
+    }
+    else if (kernel == pixel_kernel::sse2)
+    {
+        convert_row = convert_row_sse2;
+    }
+#endif
+
+    for (int32_t y = 0; y != height; ++y)
+    {
+        convert_row(src + static_cast<size_t>(y) * src_stride, dst + static_cast<size_t>(y) * width * 4, width, format, premultiply);
+    }
+}
+
+}
@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/graphic/primitive_batch.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+primitive_batch::primitive_batch()
+    : items(), rects(), points(), order(), sorted(true)
+{
+}
+
+void primitive_batch::clear()
+{
+    items.clear();
+    rects.clear();
+    points.clear();
+    order.clear();
+    sorted = true;
+}
+
+bool primitive_batch::empty() const
+{
+    return items.empty();
+}
+
+void primitive_batch::add(kind kind_, color color_, size_t offset)
+{
+    /// The same primitive of the same color as the previous is appended to its item
+    if (kind_ != kind::polyline && !items.empty() && items.back().kind_ == kind_ && items.back().color_ == color_)
+    {
+        ++items.back().count;
+        return;
+    }
+
+    items.push_back(item{ kind_, color_, offset, 1 });
+    sorted = false;
+}
+
+void primitive_batch::add_rect(const rect &position, color fill_color)
+{
+    add(kind::rect, fill_color, rects.size());
+    rects.emplace_back(position);
+}
+
+void primitive_batch::add_line(const rect &position, color color_)
+{
+    add(kind::line, color_, rects.size());
+    rects.emplace_back(position);
+}
+
+void primitive_batch::add_polyline(const point *points_, size_t count, color color_)
+{
+    if (count < 2)
+    {
+        return;
+    }
+
+    add(kind::polyline, color_, points.size());
+    items.back().count = count;
+
+    points.insert(points.end(), points_, points_ + count);
+}
+
+void primitive_batch::add_pixel(const point &position, color color_)
+{
+    add(kind::pixel, color_, points.size());
+    points.emplace_back(position);
+}
+
+const std::vector<size_t> &primitive_batch::sorted_items() const
+{
+    if (!sorted)
+    {
+        order.resize(items.size());
+        for (size_t i = 0; i != order.size(); ++i)
+        {
+            order[i] = i;
+        }
+
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            auto &ia = items[a], &ib = items[b];
+            return ia.kind_ != ib.kind_ ? ia.kind_ < ib.kind_ : ia.color_ < ib.color_;
+        });
+
+        sorted = true;
+    }
+
+    return order;
+}
+
+}
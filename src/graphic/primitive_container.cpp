@@ -8,6 +8,7 @@
 //
 
 #include <wui/graphic/primitive_container.hpp>
+#include <wui/graphic/font_registry.hpp>
 
 #include <wui/common/flag_helpers.hpp>
 
@@ -22,8 +23,26 @@
 namespace wui
 {
 
+#ifdef _WIN32
+static const size_t pens_capacity = 64, brushes_capacity = 256, fonts_capacity = 64, bitmaps_capacity = 8;
+#elif __linux__
+static const size_t gcs_capacity = 256, fonts_capacity = 64;
+#endif
+
 primitive_container::primitive_container(wui::system_context &context__)
-    : context_(context__)
+    : context_(context__),
+    err{},
+#ifdef _WIN32
+    pens("pens", pens_capacity, [](HPEN &pen) { DeleteObject(pen); }),
+    brushes("brushes", brushes_capacity, [](HBRUSH &brush) { DeleteObject(brush); }),
+    fonts("fonts", fonts_capacity, [](HFONT &font_) { DeleteObject(font_); }),
+    bitmaps("bitmaps", bitmaps_capacity, [](HBITMAP &bitmap) { DeleteObject(bitmap); }),
+    interned_fonts()
+#elif __linux__
+    gcs("gcs", gcs_capacity, [this](xcb_gcontext_t &gc) { if (context_.connection) xcb_free_gc(context_.connection, gc); }),
+    fonts("fonts", fonts_capacity, [](_cairo* &cr) { cairo_destroy(cr); }),
+    interned_fonts()
+#endif
 {
 }
 
@@ -40,41 +59,31 @@ void primitive_container::init()
 
 void primitive_container::release()
 {
-    for (auto &p : pens)
-    {
-        DeleteObject(p.second);
-    }
     pens.clear();
-
-    for (auto &b : brushes)
-    {
-        DeleteObject(b.second);
-    }
     brushes.clear();
-
-    for (auto &f : fonts)
-    {
-        DeleteObject(f.second);
-    }
     fonts.clear();
+    bitmaps.clear();
 
-    for (auto &b : bitmaps)
+    for (auto &f : interned_fonts)
     {
-        DeleteObject(b.second);
+        if (f)
+        {
+            DeleteObject(f);
+        }
     }
-    bitmaps.clear();
+    interned_fonts.clear();
 }
 
 HPEN primitive_container::get_pen(int32_t style, int32_t width, color color_)
 {
-    auto it = pens.find({ { style, width }, color_ });
-    if (it != pens.end())
+    auto cached = pens.find({ { style, width }, color_ });
+    if (cached)
     {
-        return it->second;
+        return *cached;
     }
     auto pen = CreatePen(style, width, color_);
 
-    pens[{ { style, width }, color_ }] = pen;
+    pens.insert({ { style, width }, color_ }, pen);
 
     return pen;
 }
@@ -85,27 +94,21 @@ HBRUSH primitive_container::get_brush(color color_)
     {
         return (HBRUSH)GetStockObject(NULL_BRUSH);
     }
-    auto it = brushes.find(color_);
-    if (it != brushes.end())
+    auto cached = brushes.find(color_);
+    if (cached)
     {
-        return it->second;
+        return *cached;
     }
 
     auto brush = CreateSolidBrush(color_);
 
-    brushes[color_] = brush;
+    brushes.insert(color_, brush);
 
     return brush;
 }
 
-HFONT primitive_container::get_font(font font_)
+static HFONT create_font(const font &font_)
 {
-    auto it = fonts.find({ {font_.name, font_.size }, font_.decorations_ });
-    if (it != fonts.end())
-    {
-        return it->second;
-    }
-
     LOGFONTW log_font = { font_.size,
         0,
         0,
@@ -123,19 +126,47 @@ HFONT primitive_container::get_font(font font_)
     };
     auto font_name = boost::nowide::widen(font_.name);
     memcpy(log_font.lfFaceName, font_name.c_str(), font_name.size() * 2);
-    HFONT font__ = CreateFontIndirectW(&log_font);
 
-    fonts[{ {font_.name, font_.size }, font_.decorations_ }] = font__;
+    return CreateFontIndirectW(&log_font);
+}
+
+HFONT primitive_container::get_font(const font &font_)
+{
+    auto cached = fonts.find({ {font_.name, font_.size }, font_.decorations_ });
+    if (cached)
+    {
+        return *cached;
+    }
+
+    HFONT font__ = create_font(font_);
+
+    fonts.insert({ {font_.name, font_.size }, font_.decorations_ }, font__);
+
+    return font__;
+}
+
+HFONT primitive_container::get_font(font_handle font_)
+{
+    if (static_cast<size_t>(font_.id) >= interned_fonts.size())
+    {
+        interned_fonts.resize(font_.id + 1, nullptr);
+    }
+
+    auto &font__ = interned_fonts[font_.id];
+    if (!font__)
+    {
+        font__ = create_font(get_interned_font(font_));
+    }
 
     return font__;
 }
 
 HBITMAP primitive_container::get_bitmap(int32_t width, int32_t height, uint8_t *buffer, HDC hdc)
 {
-    auto it = bitmaps.find({ width, height });
-    if (it != bitmaps.end())
+    auto cached = bitmaps.find({ width, height });
+    if (cached)
     {
-        auto bitmap = it->second;
+        auto bitmap = *cached;
 
         BITMAPINFO bmpInfo;
 
@@ -158,7 +189,7 @@ HBITMAP primitive_container::get_bitmap(int32_t width, int32_t height, uint8_t *
 
     auto bitmap = CreateBitmap(width, height, 1, 32, buffer);
 
-    bitmaps[{ width, height }] = bitmap;
+    bitmaps.insert({ width, height }, bitmap);
 
     return bitmap;
 }
@@ -172,20 +203,17 @@ void primitive_container::init()
 
 void primitive_container::release()
 {
-    if (context_.connection)
+    gcs.clear();
+    fonts.clear();
+
+    for (auto &f : interned_fonts)
     {
-        for (auto &g : gcs)
+        if (f.cr)
         {
-            xcb_free_gc(context_.connection, g.second);
+            cairo_destroy(f.cr);
         }
-        gcs.clear();
     }
-
-    for (auto &f : fonts)
-    {
-    	cairo_destroy(f.second);
-    }
-    fonts.clear();
+    interned_fonts.clear();
 }
 
 xcb_gcontext_t primitive_container::get_gc(color color_)
@@ -198,10 +226,10 @@ xcb_gcontext_t primitive_container::get_gc(color color_)
         return -1;
     }
 
-    auto it = gcs.find(color_);
-    if (it != gcs.end())
+    auto cached = gcs.find(color_);
+    if (cached)
     {
-        return it->second;
+        return *cached;
     }
 
     auto gc = xcb_generate_id(context_.connection);
@@ -210,19 +238,13 @@ xcb_gcontext_t primitive_container::get_gc(color color_)
     uint32_t value[] = { static_cast<uint32_t>(color_) };
     auto gc_create_cookie = xcb_create_gc(context_.connection, gc, context_.wnd, mask, value);
 
-    gcs[color_] = gc;
+    gcs.insert(color_, gc);
 
     return gc;
 }
 
-_cairo *primitive_container::get_font(font font_, _cairo_surface *surface)
+static _cairo *create_font(const font &font_, _cairo_surface *surface)
 {
-    auto it = fonts.find({ {font_.name, font_.size }, font_.decorations_ });
-    if (it != fonts.end())
-    {
-        return it->second;
-    }
-
     auto cr = cairo_create(surface);
     if (!cr)
     {
@@ -233,11 +255,56 @@ _cairo *primitive_container::get_font(font font_, _cairo_surface *surface)
         !flag_is_set(font_.decorations_, decorations::bold) ? CAIRO_FONT_WEIGHT_NORMAL : CAIRO_FONT_WEIGHT_BOLD);
     cairo_set_font_size(cr, font_.size);
 
-    fonts[{ {font_.name, font_.size }, font_.decorations_ }] = cr;
+    return cr;
+}
+
+_cairo *primitive_container::get_font(const font &font_, _cairo_surface *surface)
+{
+    auto cached = fonts.find({ {font_.name, font_.size }, font_.decorations_ });
+    if (cached)
+    {
+        return *cached;
+    }
+
+    auto cr = create_font(font_, surface);
+    if (!cr)
+    {
+        return nullptr;
+    }
+
+    fonts.insert({ {font_.name, font_.size }, font_.decorations_ }, cr);
 
     return cr;
 }
 
+_cairo *primitive_container::get_font(font_handle font_, _cairo_surface *surface)
+{
+    if (static_cast<size_t>(font_.id) >= interned_fonts.size())
+    {
+        interned_fonts.resize(font_.id + 1, interned_font{ nullptr, 0 });
+    }
+
+    auto &font__ = interned_fonts[font_.id];
+    if (!font__.cr)
+    {
+        auto f = get_interned_font(font_);
+
+        font__.cr = create_font(f, surface);
+        font__.size = f.size;
+    }
+
+    return font__.cr;
+}
+
+int32_t primitive_container::get_font_size(font_handle font_) const
+{
+    if (static_cast<size_t>(font_.id) < interned_fonts.size())
+    {
+        return interned_fonts[font_.id].size;
+    }
+    return 0;
+}
+
 #endif
 
 wui::error primitive_container::get_error() const
@@ -245,4 +312,13 @@ wui::error primitive_container::get_error() const
     return err;
 }
 
+std::vector<cache_stats> primitive_container::get_stats() const
+{
+#ifdef _WIN32
+    return { pens.stats(), brushes.stats(), fonts.stats(), bitmaps.stats() };
+#elif __linux__
+    return { gcs.stats(), fonts.stats() };
+#endif
+}
+
 }
@@ -9,6 +9,7 @@
 
 #include <wui/locale/locale_impl.hpp>
 #include <wui/system/tools.hpp>
+#include <wui/system/tracer.hpp>
 #include <wui/system/path_tools.hpp>
 
 #include <nlohmann/json.hpp>
@@ -82,6 +83,8 @@ void locale_impl::load_resource(int32_t resource_index, std::string_view resourc
 
 void locale_impl::load_json(std::string_view json_)
 {
+    tracer::span span_("locale_impl::load_json", "locale");
+
     err.reset();
 
     try
@@ -128,6 +131,8 @@ void locale_impl::load_json(std::string_view json_)
 
 void locale_impl::load_file(std::string_view file_name)
 {
+    tracer::span span_("locale_impl::load_file", "locale");
+
     err.reset();
 
     std::ifstream f(wui::real_path(file_name));
@@ -0,0 +1,356 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/system/alloc_counter.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+namespace wui
+{
+
+namespace alloc_counter
+{
+
+/// Count of different control names, the rest goes to the last slot
+static constexpr int32_t max_slots = 64;
+static constexpr size_t name_size = 48;
+
+/// Counters of one control name. The name is written once before the slot is published
+/// by slots_used, so the allocating threads never see it changing
+struct slot
+{
+    char name[name_size];
+    std::atomic<uint64_t> count, bytes;
+};
+
+static constexpr int32_t phases_count = static_cast<int32_t>(phase::paint) + 1;
+
+static std::atomic<bool> enabled_(false);
+
+static std::array<std::atomic<uint64_t>, phases_count> phase_counts, phase_bytes;
+
+static std::array<slot, max_slots> slots;
+static std::atomic<int32_t> slots_used(0);
+static std::mutex slots_mutex;
+
+/// The plain thread locals, so reading them from operator new does not allocate
+static thread_local phase current_phase = phase::none;
+static thread_local int32_t current_slot = -1;
+
+static std::mutex frames_mutex;
+static frame_stats last_frame_{};
+static uint64_t frames_ended = 0;
+static int32_t budget_warmup = -1;
+static std::function<void(const frame_stats&)> budget_callback;
+
+#ifdef WUI_ALLOC_COUNTER
+static void count_allocation(size_t size)
+{
+    auto p = current_phase;
+    if (p == phase::none || !enabled_.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    phase_counts[static_cast<int32_t>(p)].fetch_add(1, std::memory_order_relaxed);
+    phase_bytes[static_cast<int32_t>(p)].fetch_add(size, std::memory_order_relaxed);
+
+    if (p == phase::paint && current_slot >= 0)
+    {
+        slots[current_slot].count.fetch_add(1, std::memory_order_relaxed);
+        slots[current_slot].bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+#endif
+
+static int32_t find_slot(std::string_view control_name)
+{
+    if (control_name.empty())
+    {
+        control_name = "window";
+    }
+    control_name = control_name.substr(0, name_size - 1);
+
+    auto used = slots_used.load(std::memory_order_acquire);
+    for (int32_t i = 0; i != used; ++i)
+    {
+        if (control_name == slots[i].name)
+        {
+            return i;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(slots_mutex);
+
+    used = slots_used.load(std::memory_order_relaxed);
+    for (int32_t i = 0; i != used; ++i)
+    {
+        if (control_name == slots[i].name)
+        {
+            return i;
+        }
+    }
+
+    if (used == max_slots)
+    {
+        return max_slots - 1;
+    }
+
+    memcpy(slots[used].name, control_name.data(), control_name.size());
+    slots[used].name[control_name.size()] = '\0';
+    slots_used.store(used + 1, std::memory_order_release);
+
+    return used;
+}
+
+bool available()
+{
+#ifdef WUI_ALLOC_COUNTER
+    return true;
+#else
+    return false;
+#endif
+}
+
+void enable()
+{
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void disable()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+bool enabled()
+{
+    return enabled_.load(std::memory_order_relaxed);
+}
+
+scope::scope(phase phase_, std::string_view control_name)
+    : active(enabled()), prev_phase(phase::none), prev_slot(-1)
+{
+    if (!active)
+    {
+        return;
+    }
+
+    prev_phase = current_phase;
+    prev_slot = current_slot;
+
+    /// Finding the slot must not be counted, the first use of the name may lock the mutex
+    current_phase = phase::none;
+    auto slot_ = phase_ == phase::paint ? find_slot(control_name) : prev_slot;
+
+    current_phase = phase_;
+    current_slot = slot_;
+}
+
+scope::~scope()
+{
+    if (active)
+    {
+        current_phase = prev_phase;
+        current_slot = prev_slot;
+    }
+}
+
+void end_frame()
+{
+    if (!enabled())
+    {
+        return;
+    }
+
+    /// The statistics building allocates, it is not the part of any phase
+    auto saved_phase = current_phase;
+    current_phase = phase::none;
+
+    frame_stats stats{};
+
+    stats.dispatch_count = phase_counts[static_cast<int32_t>(phase::dispatch)].exchange(0, std::memory_order_relaxed);
+    stats.dispatch_bytes = phase_bytes[static_cast<int32_t>(phase::dispatch)].exchange(0, std::memory_order_relaxed);
+    stats.layout_count = phase_counts[static_cast<int32_t>(phase::layout)].exchange(0, std::memory_order_relaxed);
+    stats.layout_bytes = phase_bytes[static_cast<int32_t>(phase::layout)].exchange(0, std::memory_order_relaxed);
+    stats.paint_count = phase_counts[static_cast<int32_t>(phase::paint)].exchange(0, std::memory_order_relaxed);
+    stats.paint_bytes = phase_bytes[static_cast<int32_t>(phase::paint)].exchange(0, std::memory_order_relaxed);
+
+    auto used = slots_used.load(std::memory_order_acquire);
+    for (int32_t i = 0; i != used; ++i)
+    {
+        auto count = slots[i].count.exchange(0, std::memory_order_relaxed);
+        auto bytes = slots[i].bytes.exchange(0, std::memory_order_relaxed);
+        if (count != 0)
+        {
+            stats.controls.push_back({ slots[i].name, count, bytes });
+        }
+    }
+
+    std::sort(stats.controls.begin(), stats.controls.end(), [](const control_allocs &a, const control_allocs &b) {
+        return a.count > b.count;
+    });
+
+    std::function<void(const frame_stats&)> callback;
+    {
+        std::lock_guard<std::mutex> lock(frames_mutex);
+
+        stats.frame = ++frames_ended;
+        last_frame_ = stats;
+
+        if (budget_warmup >= 0 && stats.frame > static_cast<uint64_t>(budget_warmup) && stats.paint_count != 0)
+        {
+            callback = budget_callback;
+        }
+    }
+
+    if (callback)
+    {
+        callback(stats);
+    }
+
+    current_phase = saved_phase;
+}
+
+frame_stats last_frame()
+{
+    std::lock_guard<std::mutex> lock(frames_mutex);
+
+    return last_frame_;
+}
+
+void set_paint_budget(int32_t warmup_frames, std::function<void(const frame_stats&)> violation_callback)
+{
+    if (!violation_callback)
+    {
+        violation_callback = [](const frame_stats &stats) {
+            std::cerr << "wui::alloc_counter: the repaint allocates, frame: " << dump_json(stats) << std::endl;
+            std::abort();
+        };
+    }
+
+    std::lock_guard<std::mutex> lock(frames_mutex);
+
+    budget_warmup = warmup_frames;
+    budget_callback = violation_callback;
+
+    /// The warmup counts from now
+    frames_ended = 0;
+}
+
+std::string dump_json(const frame_stats &stats)
+{
+    auto j = nlohmann::json::object();
+
+    j["frame"] = stats.frame;
+    j["dispatch"] = { { "count", stats.dispatch_count }, { "bytes", stats.dispatch_bytes } };
+    j["layout"] = { { "count", stats.layout_count }, { "bytes", stats.layout_bytes } };
+    j["paint"] = { { "count", stats.paint_count }, { "bytes", stats.paint_bytes } };
+
+    j["controls"] = nlohmann::json::array();
+    for (auto &c : stats.controls)
+    {
+        j["controls"].push_back({ { "control", c.control }, { "count", c.count }, { "bytes", c.bytes } });
+    }
+
+    return j.dump();
+}
+
+}
+
+}
+
+#ifdef WUI_ALLOC_COUNTER
+
+/// The replacement of the global allocation functions, the aligned ones are not counted
+
+void *operator new(std::size_t size)
+{
+    wui::alloc_counter::count_allocation(size);
+
+    if (size == 0)
+    {
+        size = 1;
+    }
+
+    void *p = nullptr;
+    while ((p = std::malloc(size)) == nullptr)
+    {
+        auto handler = std::get_new_handler();
+        if (!handler)
+        {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+
+    return p;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return operator new(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
+
+#endif
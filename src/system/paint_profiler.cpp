@@ -0,0 +1,272 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/system/paint_profiler.hpp>
+
+#include <wui/control/i_control.hpp>
+#include <wui/system/tracer.hpp>
+#include <wui/system/alloc_counter.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <map>
+#include <algorithm>
+
+namespace wui
+{
+
+namespace paint_profiler
+{
+
+/// Count of different control names tracked by one thread, the rest goes to the last slot
+static constexpr int32_t thread_slots = 128;
+
+/// Counters of one control name. The name is written once before the slot is published
+/// by thread_data::used, so the readers never see it changing
+struct slot
+{
+    std::string name;
+
+    std::atomic<uint64_t> count, total_ns, max_ns, total_area, max_area;
+    std::array<std::atomic<uint64_t>, histogram_size> histogram;
+};
+
+/// Histograms of one painting thread, only the owner thread writes here
+struct thread_data
+{
+    std::array<slot, thread_slots> slots;
+    std::atomic<int32_t> used;
+};
+
+static std::atomic<bool> enabled_(false);
+
+static std::mutex threads_mutex;
+static std::vector<std::shared_ptr<thread_data>> threads;
+
+static thread_data &local_data()
+{
+    /// The data is owned by the registry too, so the statistics survive the thread exit
+    thread_local std::shared_ptr<thread_data> data = []()
+    {
+        auto data_ = std::make_shared<thread_data>();
+
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        threads.emplace_back(data_);
+
+        return data_;
+    }();
+
+    return *data;
+}
+
+static slot &find_slot(thread_data &data, std::string_view control_name)
+{
+    auto used = data.used.load(std::memory_order_relaxed);
+    for (int32_t i = 0; i != used; ++i)
+    {
+        if (data.slots[i].name == control_name)
+        {
+            return data.slots[i];
+        }
+    }
+
+    if (used < thread_slots - 1)
+    {
+        data.slots[used].name = control_name;
+        data.used.store(used + 1, std::memory_order_release);
+        return data.slots[used];
+    }
+
+    auto &other = data.slots[thread_slots - 1];
+    if (used == thread_slots - 1)
+    {
+        other.name = "other";
+        data.used.store(thread_slots, std::memory_order_release);
+    }
+    return other;
+}
+
+static int32_t histogram_bucket(uint64_t duration_ns)
+{
+    int32_t bucket = 0;
+    while (duration_ns >>= 1)
+    {
+        ++bucket;
+    }
+    return (std::min)(bucket, histogram_size - 1);
+}
+
+static void update_max(std::atomic<uint64_t> &max_value, uint64_t value)
+{
+    if (value > max_value.load(std::memory_order_relaxed))
+    {
+        max_value.store(value, std::memory_order_relaxed);
+    }
+}
+
+void enable()
+{
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void disable()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+bool enabled()
+{
+    return enabled_.load(std::memory_order_relaxed);
+}
+
+void draw_control(i_control &control, graphic &gr, const rect &paint_rect)
+{
+    tracer::span span_("draw", "paint");
+
+    if (!enabled_.load(std::memory_order_relaxed))
+    {
+        alloc_counter::scope alloc_scope_(alloc_counter::phase::paint, control.theme_control_name());
+        control.draw(gr, paint_rect);
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    {
+        alloc_counter::scope alloc_scope_(alloc_counter::phase::paint, control.theme_control_name());
+        control.draw(gr, paint_rect);
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    auto position = control.position();
+    int64_t width = (std::min)(position.right, paint_rect.right) - (std::max)(position.left, paint_rect.left);
+    int64_t height = (std::min)(position.bottom, paint_rect.bottom) - (std::max)(position.top, paint_rect.top);
+
+    record(control.theme_control_name(),
+        static_cast<uint64_t>(duration),
+        width > 0 && height > 0 ? static_cast<uint64_t>(width * height) : 0);
+}
+
+void record(std::string_view control_name, uint64_t duration_ns, uint64_t area)
+{
+    auto &s = find_slot(local_data(), control_name);
+
+    s.count.fetch_add(1, std::memory_order_relaxed);
+    s.total_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+    s.total_area.fetch_add(area, std::memory_order_relaxed);
+    s.histogram[histogram_bucket(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+
+    update_max(s.max_ns, duration_ns);
+    update_max(s.max_area, area);
+}
+
+std::vector<paint_stats> get_stats()
+{
+    std::map<std::string, paint_stats> merged;
+
+    {
+        std::lock_guard<std::mutex> lock(threads_mutex);
+
+        for (auto &data : threads)
+        {
+            auto used = data->used.load(std::memory_order_acquire);
+            for (int32_t i = 0; i != used; ++i)
+            {
+                auto &s = data->slots[i];
+
+                auto it = merged.find(s.name);
+                if (it == merged.end())
+                {
+                    it = merged.emplace(s.name, paint_stats{ s.name, 0, 0, 0, 0, 0, {} }).first;
+                }
+
+                auto &out = it->second;
+                out.count += s.count.load(std::memory_order_relaxed);
+                out.total_ns += s.total_ns.load(std::memory_order_relaxed);
+                out.max_ns = (std::max)(out.max_ns, s.max_ns.load(std::memory_order_relaxed));
+                out.total_area += s.total_area.load(std::memory_order_relaxed);
+                out.max_area = (std::max)(out.max_area, s.max_area.load(std::memory_order_relaxed));
+
+                for (int32_t b = 0; b != histogram_size; ++b)
+                {
+                    out.histogram[b] += s.histogram[b].load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    std::vector<paint_stats> out;
+    out.reserve(merged.size());
+    for (auto &m : merged)
+    {
+        out.emplace_back(m.second);
+    }
+
+    std::sort(out.begin(), out.end(), [](const paint_stats &a, const paint_stats &b) {
+        return a.total_ns > b.total_ns;
+    });
+
+    return out;
+}
+
+std::string dump_json()
+{
+    auto j = nlohmann::json::object();
+    j["controls"] = nlohmann::json::array();
+
+    for (auto &s : get_stats())
+    {
+        j["controls"].push_back({
+            { "control", s.control },
+            { "count", s.count },
+            { "total_ns", s.total_ns },
+            { "mean_ns", s.count != 0 ? s.total_ns / s.count : 0 },
+            { "max_ns", s.max_ns },
+            { "total_area", s.total_area },
+            { "max_area", s.max_area },
+            { "histogram", s.histogram }
+        });
+    }
+
+    return j.dump(4);
+}
+
+void reset()
+{
+    std::lock_guard<std::mutex> lock(threads_mutex);
+
+    for (auto &data : threads)
+    {
+        auto used = data->used.load(std::memory_order_acquire);
+        for (int32_t i = 0; i != used; ++i)
+        {
+            auto &s = data->slots[i];
+
+            s.count.store(0, std::memory_order_relaxed);
+            s.total_ns.store(0, std::memory_order_relaxed);
+            s.max_ns.store(0, std::memory_order_relaxed);
+            s.total_area.store(0, std::memory_order_relaxed);
+            s.max_area.store(0, std::memory_order_relaxed);
+
+            for (auto &h : s.histogram)
+            {
+                h.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+}
+
+}
@@ -69,6 +69,11 @@ void set_cursor(system_context &, cursor cursor_)
 
 void set_cursor(system_context &context, cursor cursor_)
 {
+    if (!context.connection)
+    {
+        return;
+    }
+
     std::string cursor_id;
 
     switch (cursor_)
@@ -280,7 +285,8 @@ rect get_popup_position(std::weak_ptr<window> parent, const rect &base_position,
     return out_pos;
 }
 
-void truncate_line(std::string &line, graphic &gr, const font &font_, int32_t width, int32_t truncating_count)
+template <typename font_t>
+static void truncate_line_impl(std::string &line, graphic &gr, const font_t &font_, int32_t width, int32_t truncating_count)
 {
     bool line_truncated = false;
     auto text_size = gr.measure_text(line, font_);
@@ -302,4 +308,14 @@ void truncate_line(std::string &line, graphic &gr, const font &font_, int32_t wi
     }
 }
 
+void truncate_line(std::string &line, graphic &gr, const font &font_, int32_t width, int32_t truncating_count)
+{
+    truncate_line_impl(line, gr, font_, width, truncating_count);
+}
+
+void truncate_line(std::string &line, graphic &gr, font_handle font_, int32_t width, int32_t truncating_count)
+{
+    truncate_line_impl(line, gr, font_, width, truncating_count);
+}
+
 }
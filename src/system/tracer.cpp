@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/system/tracer.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+namespace wui
+{
+
+namespace tracer
+{
+
+struct trace_event
+{
+    const char *name, *category;
+    uint64_t start_ns, duration_ns;
+    int64_t arg;
+    uint32_t thread_id;
+};
+
+std::atomic<bool> enabled_(false);
+
+static std::mutex events_mutex;
+static std::vector<trace_event> events;
+static uint64_t events_written = 0;
+
+static std::atomic<uint32_t> threads_count(0);
+
+static uint32_t thread_id()
+{
+    thread_local uint32_t id = ++threads_count;
+    return id;
+}
+
+void enable(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(events_mutex);
+
+    if (events.size() != capacity)
+    {
+        events.assign(capacity != 0 ? capacity : 1, trace_event{});
+        events_written = 0;
+    }
+
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void disable()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+uint64_t now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void add(const char *name, const char *category, uint64_t start_ns, uint64_t duration_ns, int64_t arg)
+{
+    auto id = thread_id();
+
+    std::lock_guard<std::mutex> lock(events_mutex);
+
+    if (events.empty())
+    {
+        return;
+    }
+
+    events[events_written % events.size()] = trace_event{ name, category, start_ns, duration_ns, arg, id };
+    ++events_written;
+}
+
+std::string dump_chrome_json()
+{
+    std::vector<trace_event> out;
+
+    {
+        std::lock_guard<std::mutex> lock(events_mutex);
+
+        auto count = static_cast<size_t>((std::min)(events_written, static_cast<uint64_t>(events.size())));
+        auto first = events_written - count;
+
+        out.reserve(count);
+        for (auto i = first; i != events_written; ++i)
+        {
+            out.emplace_back(events[i % events.size()]);
+        }
+    }
+
+    /// Nested spans are finished before the outer ones, the viewers want them ordered by start
+    std::stable_sort(out.begin(), out.end(), [](const trace_event &a, const trace_event &b) {
+        return a.start_ns < b.start_ns;
+    });
+
+    auto base = !out.empty() ? out.front().start_ns : 0;
+
+    auto j = nlohmann::json::object();
+    j["displayTimeUnit"] = "ns";
+    j["traceEvents"] = nlohmann::json::array();
+
+    for (auto &e : out)
+    {
+        nlohmann::json ev = {
+            { "name", e.name },
+            { "cat", e.category },
+            { "ph", "X" },
+            { "ts", static_cast<double>(e.start_ns - base) / 1000.0 },
+            { "dur", static_cast<double>(e.duration_ns) / 1000.0 },
+            { "pid", 1 },
+            { "tid", e.thread_id }
+        };
+
+        if (e.arg != no_arg)
+        {
+            ev["args"] = { { "value", e.arg } };
+        }
+
+        j["traceEvents"].push_back(ev);
+    }
+
+    return j.dump();
+}
+
+bool save(std::string_view file_name)
+{
+    std::ofstream f(std::filesystem::u8path(file_name), std::ios::out | std::ios::trunc);
+    if (!f)
+    {
+        return false;
+    }
+
+    f << dump_chrome_json();
+
+    return static_cast<bool>(f);
+}
+
+void clear()
+{
+    std::lock_guard<std::mutex> lock(events_mutex);
+
+    events_written = 0;
+}
+
+}
+
+}
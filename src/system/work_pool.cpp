@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/system/work_pool.hpp>
+
+namespace wui
+{
+
+work_pool::work_pool(int32_t threads_count)
+    : queues(),
+    threads(),
+    state_mutex(),
+    wake(), done(),
+    generation(0),
+    stopping(false),
+    task_(nullptr),
+    remaining(0)
+{
+    if (threads_count <= 0)
+    {
+        threads_count = static_cast<int32_t>(std::thread::hardware_concurrency());
+    }
+    if (threads_count <= 0)
+    {
+        threads_count = 1;
+    }
+
+    for (int32_t i = 0; i != threads_count; ++i)
+    {
+        queues.emplace_back(new queue());
+    }
+
+    for (int32_t i = 1; i != threads_count; ++i)
+    {
+        threads.emplace_back(&work_pool::work, this, i);
+    }
+}
+
+work_pool::~work_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+}
+
+int32_t work_pool::threads_count() const
+{
+    return static_cast<int32_t>(queues.size());
+}
+
+void work_pool::run(size_t tasks_count, const std::function<void(size_t task, int32_t thread)> &task)
+{
+    if (tasks_count == 0)
+    {
+        return;
+    }
+
+    task_ = &task;
+    remaining.store(tasks_count, std::memory_order_relaxed);
+
+    /// The neighbouring tasks go to the different threads, the tiles of one row have the similar cost
+    for (size_t i = 0; i != queues.size(); ++i)
+    {
+        std::lock_guard<std::mutex> lock(queues[i]->mutex);
+        for (auto t = i; t < tasks_count; t += queues.size())
+        {
+            queues[i]->tasks.push_back(t);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        ++generation;
+    }
+    wake.notify_all();
+
+    execute(0);
+
+    std::unique_lock<std::mutex> lock(state_mutex);
+    done.wait(lock, [this]() { return remaining.load(std::memory_order_acquire) == 0; });
+
+    task_ = nullptr;
+}
+
+void work_pool::work(int32_t index)
+{
+    uint64_t seen = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            wake.wait(lock, [this, &seen]() { return stopping || generation != seen; });
+
+            if (stopping)
+            {
+                return;
+            }
+            seen = generation;
+        }
+
+        execute(index);
+    }
+}
+
+void work_pool::execute(int32_t index)
+{
+    size_t t = 0;
+    while (pop(index, t) || steal(index, t))
+    {
+        /// The batch is not finished while the taken task is not executed, so task_ is valid here
+        (*task_)(t, index);
+
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            done.notify_all();
+        }
+    }
+}
+
+bool work_pool::pop(int32_t index, size_t &task)
+{
+    auto &q = *queues[index];
+
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty())
+    {
+        return false;
+    }
+
+    task = q.tasks.back();
+    q.tasks.pop_back();
+
+    return true;
+}
+
+bool work_pool::steal(int32_t index, size_t &task)
+{
+    auto count = static_cast<int32_t>(queues.size());
+    for (int32_t i = 1; i != count; ++i)
+    {
+        auto &q = *queues[(index + i) % count];
+
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty())
+        {
+            task = q.tasks.front();
+            q.tasks.pop_front();
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}
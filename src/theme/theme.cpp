@@ -147,6 +147,19 @@ font theme_font(std::string_view control, std::string_view value, std::shared_pt
     return font();
 }
 
+font_handle theme_font_handle(std::string_view control, std::string_view value, std::shared_ptr<i_theme> theme_)
+{
+    if (theme_)
+    {
+        return theme_->get_font_handle(control, value);
+    }
+    else if (instance)
+    {
+        return instance->get_font_handle(control, value);
+    }
+    return font_handle{ 0 };
+}
+
 const std::vector<uint8_t> &theme_image(std::string_view name, std::shared_ptr<i_theme> theme_)
 {
     if (theme_)
@@ -161,4 +174,18 @@ const std::vector<uint8_t> &theme_image(std::string_view name, std::shared_ptr<i
     return dummy_image;
 }
 
+std::shared_ptr<image_atlas> theme_image_atlas(double scale, std::shared_ptr<i_theme> theme_)
+{
+    if (theme_)
+    {
+        return theme_->get_image_atlas(scale);
+    }
+    else if (instance)
+    {
+        return instance->get_image_atlas(scale);
+    }
+
+    return nullptr;
+}
+
 }
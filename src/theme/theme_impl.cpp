@@ -8,7 +8,10 @@
 //
 
 #include <wui/theme/theme_impl.hpp>
+#include <wui/graphic/image_atlas.hpp>
+#include <wui/graphic/font_registry.hpp>
 #include <wui/system/tools.hpp>
+#include <wui/system/tracer.hpp>
 #include <wui/system/path_tools.hpp>
 
 #include <nlohmann/json.hpp>
@@ -16,6 +19,7 @@
 
 #include <sstream>
 #include <fstream>
+#include <cmath>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -25,7 +29,7 @@ namespace wui
 {
 
 theme_impl::theme_impl(std::string_view name_)
-    : name(name_), ints(), strings(), fonts(), imgs(), dummy_string(), dummy_image(), err{}
+    : name(name_), ints(), strings(), fonts(), font_handles(), imgs(), atlases(), atlases_mutex(), dummy_string(), dummy_image(), err{}
 {
 }
 
@@ -41,7 +45,7 @@ void theme_impl::set_color(std::string_view control, std::string_view value, col
 
 color theme_impl::get_color(std::string_view control, std::string_view value) const
 {
-    auto it = ints.find({ control.data(), value.data() });
+    auto it = ints.find(std::make_pair(control, value));
     if (it != ints.end())
     {
         return static_cast<color>(it->second);
@@ -56,7 +60,7 @@ void theme_impl::set_dimension(std::string_view control, std::string_view value,
 
 int32_t theme_impl::get_dimension(std::string_view control, std::string_view value) const
 {
-    auto it = ints.find({ control.data(), value.data() });
+    auto it = ints.find(std::make_pair(control, value));
     if (it != ints.end())
     {
         return it->second;
@@ -71,7 +75,7 @@ void theme_impl::set_string(std::string_view control, std::string_view value, st
 
 const std::string &theme_impl::get_string(std::string_view control, std::string_view value) const
 {
-    auto it = strings.find({ control.data(), value.data() });
+    auto it = strings.find(std::make_pair(control, value));
     if (it != strings.end())
     {
         return it->second;
@@ -82,11 +86,12 @@ const std::string &theme_impl::get_string(std::string_view control, std::string_
 void theme_impl::set_font(std::string_view control, std::string_view value, const font &font_)
 {
     fonts[{ control.data(), value.data() }] = font_;
+    font_handles[{ control.data(), value.data() }] = intern_font(font_);
 }
 
 font theme_impl::get_font(std::string_view control, std::string_view value) const
 {
-    auto it = fonts.find({ control.data(), value.data() });
+    auto it = fonts.find(std::make_pair(control, value));
     if (it != fonts.end())
     {
         return it->second;
@@ -94,9 +99,22 @@ font theme_impl::get_font(std::string_view control, std::string_view value) cons
     return font();
 }
 
+font_handle theme_impl::get_font_handle(std::string_view control, std::string_view value) const
+{
+    auto it = font_handles.find(std::make_pair(control, value));
+    if (it != font_handles.end())
+    {
+        return it->second;
+    }
+    return font_handle{ 0 };
+}
+
 void theme_impl::set_image(std::string_view name_, const std::vector<uint8_t> &data)
 {
     imgs[name_.data()] = data;
+
+    std::lock_guard<std::mutex> lock(atlases_mutex);
+    atlases.clear();
 }
 
 const std::vector<uint8_t> &theme_impl::get_image(std::string_view name_)
@@ -109,6 +127,26 @@ const std::vector<uint8_t> &theme_impl::get_image(std::string_view name_)
     return dummy_image;
 }
 
+std::shared_ptr<image_atlas> theme_impl::get_image_atlas(double scale)
+{
+    auto scale_percent = static_cast<int32_t>(std::lround(scale * 100));
+    if (scale_percent <= 0)
+    {
+        scale_percent = 100;
+    }
+
+    std::lock_guard<std::mutex> lock(atlases_mutex);
+
+    auto &atlas = atlases[scale_percent];
+    if (!atlas)
+    {
+        atlas = std::make_shared<image_atlas>();
+        atlas->build(imgs, scale_percent / 100.0);
+    }
+
+    return atlas;
+}
+
 #ifdef _WIN32
 void theme_impl::load_resource(int32_t resource_index, std::string_view resource_section)
 {
@@ -137,6 +175,8 @@ void theme_impl::load_resource(int32_t resource_index, std::string_view resource
 
 void theme_impl::load_json(std::string_view json_)
 {
+    tracer::span span_("theme_impl::load_json", "theme");
+
     err.reset();
 
     try
@@ -226,7 +266,7 @@ void theme_impl::load_json(std::string_view json_)
                         size = size_it->second.get<std::int32_t>();
                     }
 
-                    fonts[{ control, kvp.first }] = font{ font_name, size, static_cast<decorations>(decorations_) };
+                    set_font(control, kvp.first, font{ font_name, size, static_cast<decorations>(decorations_) });
                 }
             }
         }
@@ -278,6 +318,9 @@ void theme_impl::load_json(std::string_view json_)
             }
             set_image(image_name, image_data);
         }
+
+        /// The icons of base scale are packed on load, so the theme switching not decodes them again
+        get_image_atlas(1.0);
     }
     catch (nlohmann::detail::exception &e)
     {
@@ -289,6 +332,8 @@ void theme_impl::load_json(std::string_view json_)
 
 void theme_impl::load_file(std::string_view file_name)
 {
+    tracer::span span_("theme_impl::load_file", "theme");
+
     err.reset();
 
     std::ifstream f(wui::real_path(file_name));
@@ -313,6 +358,7 @@ void theme_impl::load_theme(const i_theme &theme_)
     ints = static_cast<const theme_impl*>(&theme_)->ints;
     strings = static_cast<const theme_impl*>(&theme_)->strings;
     fonts = static_cast<const theme_impl*>(&theme_)->fonts;
+    font_handles = static_cast<const theme_impl*>(&theme_)->font_handles;
 }
 
 error theme_impl::get_error() const
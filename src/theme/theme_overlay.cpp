@@ -0,0 +1,225 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/theme/theme_overlay.hpp>
+#include <wui/theme/theme.hpp>
+#include <wui/graphic/font_registry.hpp>
+
+namespace wui
+{
+
+template <typename E>
+static auto find_entry(E &entries, std::string_view control, std::string_view value) -> decltype(&entries[0])
+{
+    for (auto &e : entries)
+    {
+        if (e.value == value && e.control == control)
+        {
+            return &e;
+        }
+    }
+    return nullptr;
+}
+
+template <typename E, typename T>
+static void set_entry(E &entries, std::string_view control, std::string_view value, const T &data)
+{
+    auto e = find_entry(entries, control, value);
+    if (e)
+    {
+        e->data = data;
+    }
+    else
+    {
+        entries.push_back({ std::string(control), std::string(value), data });
+    }
+}
+
+theme_overlay::theme_overlay(std::shared_ptr<i_theme> parent, std::string_view name_)
+    : name(name_), parent_(parent), ints(), strings(), fonts(), imgs(), dummy_string(), dummy_image(), err{}
+{
+}
+
+void theme_overlay::set_parent(std::shared_ptr<i_theme> parent)
+{
+    parent_ = parent;
+}
+
+std::shared_ptr<i_theme> theme_overlay::parent() const
+{
+    return parent_;
+}
+
+void theme_overlay::clear()
+{
+    ints.clear();
+    strings.clear();
+    fonts.clear();
+    imgs.clear();
+}
+
+i_theme *theme_overlay::source() const
+{
+    if (parent_)
+    {
+        return parent_.get();
+    }
+    return get_default_theme().get();
+}
+
+std::string theme_overlay::get_name() const
+{
+    if (!name.empty())
+    {
+        return name;
+    }
+
+    auto s = source();
+    return s ? s->get_name() : std::string();
+}
+
+void theme_overlay::set_color(std::string_view control, std::string_view value, color color_)
+{
+    set_entry(ints, control, value, static_cast<int32_t>(color_));
+}
+
+color theme_overlay::get_color(std::string_view control, std::string_view value) const
+{
+    auto e = find_entry(ints, control, value);
+    if (e)
+    {
+        return static_cast<color>(e->data);
+    }
+
+    auto s = source();
+    return s ? s->get_color(control, value) : 0;
+}
+
+void theme_overlay::set_dimension(std::string_view control, std::string_view value, int32_t dimension)
+{
+    set_entry(ints, control, value, dimension);
+}
+
+int32_t theme_overlay::get_dimension(std::string_view control, std::string_view value) const
+{
+    auto e = find_entry(ints, control, value);
+    if (e)
+    {
+        return e->data;
+    }
+
+    auto s = source();
+    return s ? s->get_dimension(control, value) : 0;
+}
+
+void theme_overlay::set_string(std::string_view control, std::string_view value, std::string_view str)
+{
+    set_entry(strings, control, value, std::string(str));
+}
+
+const std::string &theme_overlay::get_string(std::string_view control, std::string_view value) const
+{
+    auto e = find_entry(strings, control, value);
+    if (e)
+    {
+        return e->data;
+    }
+
+    auto s = source();
+    return s ? s->get_string(control, value) : dummy_string;
+}
+
+void theme_overlay::set_font(std::string_view control, std::string_view value, const font &font_)
+{
+    set_entry(fonts, control, value, font_data{ font_, intern_font(font_) });
+}
+
+font theme_overlay::get_font(std::string_view control, std::string_view value) const
+{
+    auto e = find_entry(fonts, control, value);
+    if (e)
+    {
+        return e->data.font_;
+    }
+
+    auto s = source();
+    return s ? s->get_font(control, value) : font();
+}
+
+font_handle theme_overlay::get_font_handle(std::string_view control, std::string_view value) const
+{
+    auto e = find_entry(fonts, control, value);
+    if (e)
+    {
+        return e->data.handle;
+    }
+
+    auto s = source();
+    return s ? s->get_font_handle(control, value) : font_handle{ 0 };
+}
+
+void theme_overlay::set_image(std::string_view name_, const std::vector<uint8_t> &data)
+{
+    set_entry(imgs, "", name_, data);
+}
+
+const std::vector<uint8_t> &theme_overlay::get_image(std::string_view name_)
+{
+    auto e = find_entry(imgs, "", name_);
+    if (e)
+    {
+        return e->data;
+    }
+
+    auto s = source();
+    return s ? s->get_image(name_) : dummy_image;
+}
+
+std::shared_ptr<image_atlas> theme_overlay::get_image_atlas(double scale)
+{
+    auto s = source();
+    return s ? s->get_image_atlas(scale) : nullptr;
+}
+
+#ifdef _WIN32
+void theme_overlay::load_resource(int32_t, std::string_view)
+{
+    err.type = error_type::invalid_value;
+    err.component = "theme_overlay::load_resource()";
+    err.message = "the overlay theme is not loaded, set the values or the parent";
+}
+#endif
+
+void theme_overlay::load_json(std::string_view)
+{
+    err.type = error_type::invalid_value;
+    err.component = "theme_overlay::load_json()";
+    err.message = "the overlay theme is not loaded, set the values or the parent";
+}
+
+void theme_overlay::load_file(std::string_view)
+{
+    err.type = error_type::invalid_value;
+    err.component = "theme_overlay::load_file()";
+    err.message = "the overlay theme is not loaded, set the values or the parent";
+}
+
+void theme_overlay::load_theme(const i_theme &)
+{
+    err.type = error_type::invalid_value;
+    err.component = "theme_overlay::load_theme()";
+    err.message = "the overlay theme does not copy the values, set the parent";
+}
+
+error theme_overlay::get_error() const
+{
+    return err;
+}
+
+}
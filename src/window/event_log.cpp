@@ -0,0 +1,398 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/window/event_log.hpp>
+#include <wui/window/window.hpp>
+
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+
+namespace wui
+{
+
+static const uint8_t log_magic[] = { 'W', 'U', 'I', 'E' };
+static constexpr uint8_t log_version = 1;
+
+/// The key codes are platform specific, so the log is played only on the platform it was recorded
+#ifdef _WIN32
+static constexpr uint8_t log_platform = 0;
+#elif __linux__
+static constexpr uint8_t log_platform = 1;
+#endif
+
+static constexpr size_t header_size = sizeof(log_magic) + 2;
+
+static uint64_t now_us()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static void put_varint(std::vector<uint8_t> &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static void put_signed(std::vector<uint8_t> &out, int32_t value)
+{
+    put_varint(out, (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+}
+
+static bool get_varint(const std::vector<uint8_t> &in, size_t &pos, uint64_t &value)
+{
+    value = 0;
+    for (int32_t shift = 0; shift < 64 && pos < in.size(); shift += 7)
+    {
+        auto b = in[pos++];
+        value |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool get_signed(const std::vector<uint8_t> &in, size_t &pos, int32_t &value)
+{
+    uint64_t v = 0;
+    if (!get_varint(in, pos, v))
+    {
+        return false;
+    }
+    auto u = static_cast<uint32_t>(v);
+    value = static_cast<int32_t>((u >> 1) ^ (~(u & 1) + 1));
+    return true;
+}
+
+static bool get_byte(const std::vector<uint8_t> &in, size_t &pos, uint8_t &value)
+{
+    if (pos >= in.size())
+    {
+        return false;
+    }
+    value = in[pos++];
+    return true;
+}
+
+/// Record types in the log
+enum class record_type : uint8_t
+{
+    mouse,
+    keyboard,
+    internal,
+    system
+};
+
+event_recorder::event_recorder()
+    : data_mutex(),
+    data_(),
+    count_(0),
+    recording_(false),
+    prev_time(0),
+    prev_x(0), prev_y(0)
+{
+}
+
+void event_recorder::start()
+{
+    std::lock_guard<std::mutex> lock(data_mutex);
+
+    recording_ = true;
+    prev_time = now_us();
+}
+
+void event_recorder::stop()
+{
+    std::lock_guard<std::mutex> lock(data_mutex);
+
+    recording_ = false;
+}
+
+bool event_recorder::recording() const
+{
+    std::lock_guard<std::mutex> lock(data_mutex);
+
+    return recording_;
+}
+
+void event_recorder::record(const event &ev)
+{
+    std::lock_guard<std::mutex> lock(data_mutex);
+
+    if (!recording_ ||
+        (ev.type != event_type::mouse && ev.type != event_type::keyboard && ev.type != event_type::internal && ev.type != event_type::system))
+    {
+        return;
+    }
+
+    auto now = now_us();
+    put_varint(data_, now - prev_time);
+    prev_time = now;
+
+    switch (ev.type)
+    {
+        case event_type::mouse:
+            data_.push_back(static_cast<uint8_t>(record_type::mouse));
+            data_.push_back(static_cast<uint8_t>(ev.mouse_event_.type));
+            put_signed(data_, ev.mouse_event_.x - prev_x);
+            put_signed(data_, ev.mouse_event_.y - prev_y);
+            put_signed(data_, ev.mouse_event_.wheel_delta);
+
+            prev_x = ev.mouse_event_.x;
+            prev_y = ev.mouse_event_.y;
+        break;
+        case event_type::keyboard:
+        {
+            data_.push_back(static_cast<uint8_t>(record_type::keyboard));
+            data_.push_back(static_cast<uint8_t>(ev.keyboard_event_.type));
+            data_.push_back(ev.keyboard_event_.modifier);
+
+            /// The down and up events have the key code in key[0] and zero key_size
+            auto key_size = (std::min)(ev.keyboard_event_.key_size, static_cast<uint8_t>(sizeof(ev.keyboard_event_.key)));
+            data_.push_back(key_size);
+            data_.insert(data_.end(), ev.keyboard_event_.key, ev.keyboard_event_.key + (key_size != 0 ? key_size : 1));
+        }
+        break;
+        case event_type::internal:
+            data_.push_back(static_cast<uint8_t>(record_type::internal));
+            data_.push_back(static_cast<uint8_t>(ev.internal_event_.type));
+            put_signed(data_, ev.internal_event_.x);
+            put_signed(data_, ev.internal_event_.y);
+        break;
+        case event_type::system:
+            data_.push_back(static_cast<uint8_t>(record_type::system));
+            data_.push_back(static_cast<uint8_t>(ev.system_event_.type));
+            put_signed(data_, ev.system_event_.x);
+            put_signed(data_, ev.system_event_.y);
+        break;
+        default: break;
+    }
+
+    ++count_;
+}
+
+size_t event_recorder::count() const
+{
+    std::lock_guard<std::mutex> lock(data_mutex);
+
+    return count_;
+}
+
+std::vector<uint8_t> event_recorder::data() const
+{
+    std::vector<uint8_t> out(std::begin(log_magic), std::end(log_magic));
+    out.push_back(log_version);
+    out.push_back(log_platform);
+
+    std::lock_guard<std::mutex> lock(data_mutex);
+
+    out.insert(out.end(), data_.begin(), data_.end());
+
+    return out;
+}
+
+bool event_recorder::save(std::string_view file_name) const
+{
+    std::ofstream f(std::filesystem::u8path(file_name), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!f)
+    {
+        return false;
+    }
+
+    auto out = data();
+    f.write(reinterpret_cast<const char*>(out.data()), out.size());
+
+    return static_cast<bool>(f);
+}
+
+void event_recorder::clear()
+{
+    std::lock_guard<std::mutex> lock(data_mutex);
+
+    data_.clear();
+    count_ = 0;
+    prev_time = now_us();
+    prev_x = 0;
+    prev_y = 0;
+}
+
+event_player::event_player()
+    : events(),
+    err{}
+{
+}
+
+bool event_player::load(std::string_view file_name)
+{
+    err.reset();
+
+    std::ifstream f(std::filesystem::u8path(file_name), std::ios::in | std::ios::binary);
+    if (!f)
+    {
+        err.type = error_type::file_not_found;
+        err.component = "event_player::load()";
+        err.message = "unable to open file: " + std::string(file_name);
+
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    return load(data);
+}
+
+bool event_player::load(const std::vector<uint8_t> &data)
+{
+    err.reset();
+    events.clear();
+
+    auto invalid = [this](std::string_view message) {
+        err.type = error_type::invalid_value;
+        err.component = "event_player::load()";
+        err.message = std::string(message);
+
+        events.clear();
+        return false;
+    };
+
+    if (data.size() < header_size || memcmp(data.data(), log_magic, sizeof(log_magic)) != 0)
+    {
+        return invalid("the data is not the wui event log");
+    }
+    if (data[sizeof(log_magic)] != log_version)
+    {
+        return invalid("unsupported event log version");
+    }
+    if (data[sizeof(log_magic) + 1] != log_platform)
+    {
+        return invalid("the event log is recorded on the other platform");
+    }
+
+    size_t pos = header_size;
+    uint64_t time = 0;
+    int32_t x = 0, y = 0;
+
+    while (pos < data.size())
+    {
+        uint64_t delta = 0;
+        uint8_t type = 0, subtype = 0;
+        if (!get_varint(data, pos, delta) || !get_byte(data, pos, type) || !get_byte(data, pos, subtype))
+        {
+            return invalid("truncated record at " + std::to_string(pos));
+        }
+
+        time += delta;
+
+        recorded_event re{ time };
+        bool ok = true;
+
+        switch (static_cast<record_type>(type))
+        {
+            case record_type::mouse:
+            {
+                int32_t dx = 0, dy = 0, wheel_delta = 0;
+                ok = get_signed(data, pos, dx) && get_signed(data, pos, dy) && get_signed(data, pos, wheel_delta);
+                x += dx;
+                y += dy;
+
+                re.ev.type = event_type::mouse;
+                re.ev.mouse_event_ = mouse_event{ static_cast<mouse_event_type>(subtype), x, y, wheel_delta };
+            }
+            break;
+            case record_type::keyboard:
+            {
+                uint8_t modifier = 0, key_size = 0;
+                ok = get_byte(data, pos, modifier) && get_byte(data, pos, key_size);
+
+                size_t stored = key_size != 0 ? key_size : 1;
+                ok = ok && key_size <= sizeof(re.ev.keyboard_event_.key) && pos + stored <= data.size();
+
+                re.ev.type = event_type::keyboard;
+                re.ev.keyboard_event_ = keyboard_event{ static_cast<keyboard_event_type>(subtype), modifier, 0 };
+                if (ok)
+                {
+                    memcpy(re.ev.keyboard_event_.key, data.data() + pos, stored);
+                    re.ev.keyboard_event_.key_size = key_size;
+                    pos += stored;
+                }
+            }
+            break;
+            case record_type::internal:
+            {
+                int32_t ix = 0, iy = 0;
+                ok = get_signed(data, pos, ix) && get_signed(data, pos, iy);
+
+                re.ev.type = event_type::internal;
+                re.ev.internal_event_ = internal_event{ static_cast<internal_event_type>(subtype), ix, iy };
+            }
+            break;
+            case record_type::system:
+            {
+                int32_t sx = 0, sy = 0;
+                ok = get_signed(data, pos, sx) && get_signed(data, pos, sy);
+
+                re.ev.type = event_type::system;
+                re.ev.system_event_ = system_event{ static_cast<system_event_type>(subtype), sx, sy };
+            }
+            break;
+            default:
+                ok = false;
+            break;
+        }
+
+        if (!ok)
+        {
+            return invalid("invalid record at " + std::to_string(pos));
+        }
+
+        events.emplace_back(re);
+    }
+
+    return true;
+}
+
+size_t event_player::count() const
+{
+    return events.size();
+}
+
+uint64_t event_player::play(window &window_, double speed)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (auto &re : events)
+    {
+        if (speed > 0.0)
+        {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(static_cast<int64_t>(re.time_us / speed)));
+        }
+
+        window_.dispatch_event(re.ev);
+        window_.paint_damaged();
+    }
+
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+error event_player::get_error() const
+{
+    return err;
+}
+
+}
@@ -0,0 +1,415 @@
+//
+// Copyright (c) 2023 Anton Golovkov (udattsk at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/ud84/wui
+//
+
+#include <wui/window/perf_overlay.hpp>
+
+#include <wui/graphic/font_registry.hpp>
+#include <wui/system/wm_tools.hpp>
+#include <wui/common/color.hpp>
+
+#include <chrono>
+#include <algorithm>
+
+namespace wui
+{
+
+/// Size of the buffer keeping the pixels under the panel, the panel is clipped by it
+static constexpr int32_t max_width = 512, max_height = 512;
+
+static constexpr int32_t indent = 8, padding = 6;
+
+/// How often the counters are recalculated and the panel is refreshed in idle
+static constexpr uint32_t refresh_interval_ms = 500;
+
+/// Heatmap colors from cold to hot
+static const color heat_colors[] = {
+    make_color(0, 96, 255),
+    make_color(0, 200, 80),
+    make_color(240, 220, 0),
+    make_color(255, 128, 0),
+    make_color(255, 0, 0)
+};
+static constexpr int32_t heat_levels = sizeof(heat_colors) / sizeof(heat_colors[0]);
+
+static uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static std::string to_fixed(double value, int32_t digits)
+{
+    int64_t scale = 1;
+    for (int32_t i = 0; i != digits; ++i)
+    {
+        scale *= 10;
+    }
+
+    auto scaled = static_cast<int64_t>(value * scale + 0.5);
+    if (digits == 0)
+    {
+        return std::to_string(scaled);
+    }
+
+    auto fraction = std::to_string(scaled % scale);
+    return std::to_string(scaled / scale) + "." + std::string(digits - fraction.size(), '0') + fraction;
+}
+
+perf_overlay::perf_overlay(system_context &context, std::function<void(void)> refresh_callback)
+    : context_(context),
+    refresh_timer(refresh_callback),
+    showed_(false),
+    heatmap_(overdraw_heatmap::none),
+    heatmap_changed(false),
+    backup(context), heatmap_backup(context),
+    backup_inited(false), heatmap_backup_inited(false),
+#ifdef _WIN32
+    font_(intern_font(font{ "Consolas", 14, decorations::normal })),
+#elif __linux__
+    font_(intern_font(font{ "Monospace", 12, decorations::normal })),
+#endif
+    position_{ 0 }, flushed_position{ 0 },
+    paint_start(0), paint_ns(0), interval_start(0), frames(0),
+    fps(0.0), dirty_percent(0.0),
+    queue_depth(0),
+    prev_caches(),
+    cache_lines()
+{
+}
+
+perf_overlay::~perf_overlay()
+{
+    refresh_timer.stop();
+}
+
+void perf_overlay::show()
+{
+    if (showed_)
+    {
+        return;
+    }
+
+    interval_start = 0;
+    frames = 0;
+    fps = 0.0;
+    prev_caches.clear();
+    cache_lines.clear();
+
+    showed_ = true;
+
+    refresh_timer.start(refresh_interval_ms);
+}
+
+void perf_overlay::hide()
+{
+    if (!showed_)
+    {
+        return;
+    }
+
+    showed_ = false;
+
+    refresh_timer.stop();
+    position_ = { 0 };
+}
+
+bool perf_overlay::showed() const
+{
+    return showed_;
+}
+
+void perf_overlay::set_heatmap(overdraw_heatmap heatmap)
+{
+    if (heatmap_.exchange(heatmap) != heatmap)
+    {
+        heatmap_changed = true;
+    }
+}
+
+overdraw_heatmap perf_overlay::heatmap() const
+{
+    return heatmap_;
+}
+
+void perf_overlay::begin_paint()
+{
+    paint_start = now_ns();
+}
+
+void perf_overlay::flush(graphic &gr, const rect &paint_rect, const rect &window_size)
+{
+    auto now = now_ns();
+
+    if (!paint_rect.is_null())
+    {
+        paint_ns = paint_start != 0 ? now - paint_start : 0;
+        ++frames;
+
+        auto window_area = static_cast<int64_t>(window_size.width()) * window_size.height();
+        auto width = (std::min)(paint_rect.right, window_size.right) - (std::max)(paint_rect.left, window_size.left);
+        auto height = (std::min)(paint_rect.bottom, window_size.bottom) - (std::max)(paint_rect.top, window_size.top);
+
+        dirty_percent = window_area > 0 && width > 0 && height > 0 ?
+            static_cast<double>(static_cast<int64_t>(width) * height) * 100.0 / window_area : 0.0;
+    }
+
+    auto heatmap = heatmap_.load();
+    auto heatmap_full = heatmap_changed.exchange(false);
+
+    if (heatmap == overdraw_heatmap::none && !heatmap_full && !showed_ && flushed_position.is_null())
+    {
+        if (!paint_rect.is_null())
+        {
+            gr.flush(paint_rect);
+        }
+        return;
+    }
+
+    /// The overlay's own drawing is not counted
+    gr.set_overdraw_tracking(false);
+
+    if (heatmap != overdraw_heatmap::none && heatmap_full)
+    {
+        gr.get_overdraw_map().reset();
+    }
+    if (heatmap != overdraw_heatmap::none && !paint_rect.is_null())
+    {
+        gr.get_overdraw_map().add_flush(paint_rect);
+    }
+
+    rect heatmap_area = { 0 };
+    if (heatmap != overdraw_heatmap::none)
+    {
+        auto area = heatmap_full ? window_size : paint_rect;
+        if (!area.is_null() && draw_heatmap(gr, area))
+        {
+            heatmap_area = area;
+        }
+    }
+
+    bool panel = false;
+    if (showed_)
+    {
+        update_interval(gr, now);
+
+        if (!backup_inited)
+        {
+            backup_inited = backup.init({ 0, 0, max_width, max_height }, make_color(0, 0, 0));
+        }
+
+        if (backup_inited)
+        {
+            draw(gr, window_size);
+            panel = true;
+        }
+    }
+
+    if (!paint_rect.is_null())
+    {
+        gr.flush(paint_rect);
+    }
+    if (!heatmap_area.is_null() && !(heatmap_area == paint_rect))
+    {
+        gr.flush(heatmap_area);
+    }
+    if (heatmap == overdraw_heatmap::none && heatmap_full)
+    {
+        /// The buffer holds the clean content, so flushing it erases the heatmap from the screen
+        gr.flush(window_size);
+    }
+
+    if (panel)
+    {
+        gr.flush(position_);
+        gr.draw_graphic({ position_.left, position_.top, position_.width(), position_.height() }, backup, 0, 0);
+
+        flushed_position = position_;
+    }
+    else if (!flushed_position.is_null())
+    {
+        gr.flush(flushed_position); /// erases the hidden panel
+        flushed_position = { 0 };
+    }
+
+    if (!heatmap_area.is_null())
+    {
+        gr.draw_graphic({ heatmap_area.left, heatmap_area.top, heatmap_area.width(), heatmap_area.height() }, heatmap_backup, 0, 0);
+    }
+
+    gr.set_overdraw_tracking(heatmap != overdraw_heatmap::none);
+}
+
+void perf_overlay::set_queue_depth(int32_t depth)
+{
+    queue_depth.store(depth, std::memory_order_relaxed);
+}
+
+void perf_overlay::release()
+{
+    hide();
+
+    backup.release();
+    backup_inited = false;
+
+    heatmap_backup.release();
+    heatmap_backup_inited = false;
+
+    flushed_position = { 0 };
+}
+
+void perf_overlay::update_interval(graphic &gr, uint64_t now)
+{
+    if (interval_start == 0)
+    {
+        interval_start = now;
+        prev_caches = gr.get_cache_stats();
+        return;
+    }
+
+    auto elapsed = now - interval_start;
+    if (elapsed < refresh_interval_ms * 1000000ULL)
+    {
+        return;
+    }
+
+    fps = static_cast<double>(frames) * 1e9 / elapsed;
+    frames = 0;
+    interval_start = now;
+
+    /// The hit rates are calculated on the last interval only, so the startup misses do not hide the current state
+    auto caches = gr.get_cache_stats();
+
+    cache_lines.clear();
+    for (size_t i = 0; i != caches.size(); ++i)
+    {
+        auto hits = caches[i].hits, misses = caches[i].misses;
+        if (i < prev_caches.size())
+        {
+            hits -= prev_caches[i].hits;
+            misses -= prev_caches[i].misses;
+        }
+
+        cache_lines.emplace_back(std::string(caches[i].name) + " " +
+            (hits + misses != 0 ? to_fixed(static_cast<double>(hits) * 100.0 / (hits + misses), 1) + " %" : std::string("-")));
+    }
+
+    prev_caches = caches;
+}
+
+void perf_overlay::draw(graphic &gr, const rect &window_size)
+{
+    std::vector<std::string> lines = {
+        "fps " + to_fixed(fps, 1),
+        "paint " + to_fixed(static_cast<double>(paint_ns) / 1e6, 2) + " ms",
+        "dirty " + to_fixed(dirty_percent, 1) + " %",
+        "queue " + std::to_string(queue_depth.load(std::memory_order_relaxed))
+    };
+    lines.insert(lines.end(), cache_lines.begin(), cache_lines.end());
+
+    int32_t width = 0, line_height = 0;
+    for (auto &line : lines)
+    {
+        auto size = gr.measure_text(line, font_);
+        width = (std::max)(width, size.width());
+        line_height = (std::max)(line_height, size.height());
+    }
+
+    /// The panel only grows while showed so it does not jump when the numbers change
+    width = (std::min)((std::max)(width + padding * 2, position_.width()), max_width);
+    auto height = (std::min)(static_cast<int32_t>(lines.size()) * line_height + padding * 2, max_height);
+
+    rect position{ window_size.left + indent,
+        window_size.bottom - indent - height,
+        window_size.left + indent + width,
+        window_size.bottom - indent };
+
+    if (!flushed_position.is_null() && !(flushed_position == position))
+    {
+        gr.flush(flushed_position);
+    }
+    position_ = position;
+
+    backup.draw_graphic({ 0, 0, width, height }, gr, position_.left, position_.top);
+
+    gr.draw_rect(position_, make_color(96, 96, 96), make_color(24, 24, 24), 1, 0);
+
+    auto top = position_.top + padding;
+    for (auto &line : lines)
+    {
+        if (top + line_height > position_.bottom)
+        {
+            break;
+        }
+
+        gr.draw_text({ position_.left + padding, top, 0, 0 }, line, make_color(128, 240, 128), font_);
+        top += line_height;
+    }
+}
+
+bool perf_overlay::draw_heatmap(graphic &gr, const rect &area)
+{
+    if (!heatmap_backup_inited)
+    {
+        heatmap_backup_inited = heatmap_backup.init(get_screen_size(context_), make_color(0, 0, 0));
+        if (!heatmap_backup_inited)
+        {
+            return false;
+        }
+    }
+
+    auto &map = gr.get_overdraw_map();
+    auto heatmap = heatmap_.load();
+
+    heatmap_backup.draw_graphic({ 0, 0, area.width(), area.height() }, gr, area.left, area.top);
+
+    const int32_t tile = overdraw_map::tile_size, marker = tile / 2;
+
+    auto first_column = (std::max)(area.left, 0) / tile, first_row = (std::max)(area.top, 0) / tile;
+    auto last_column = (std::min)((area.right - 1) / tile, map.columns() - 1), last_row = (std::min)((area.bottom - 1) / tile, map.rows() - 1);
+
+    for (auto row = first_row; row <= last_row; ++row)
+    {
+        for (auto column = first_column; column <= last_column; ++column)
+        {
+            auto value = heatmap == overdraw_heatmap::repaints ? map.repaints(column, row) : map.depth(column, row);
+            if (value == 0)
+            {
+                continue;
+            }
+
+            /// The repaints go by the powers of two, the overdraw depth is linear: 1 write is cold, 5 and more are hot
+            int32_t level = 0;
+            if (heatmap == overdraw_heatmap::repaints)
+            {
+                while (value >>= 1)
+                {
+                    ++level;
+                }
+            }
+            else
+            {
+                level = static_cast<int32_t>(value) - 1;
+            }
+
+            /// The marker is clipped by the area, pixels outside of it would not be restored
+            rect marker_rect{ (std::max)(column * tile + marker / 2, area.left),
+                (std::max)(row * tile + marker / 2, area.top),
+                (std::min)(column * tile + marker / 2 + marker, area.right),
+                (std::min)(row * tile + marker / 2 + marker, area.bottom) };
+
+            if (marker_rect.width() > 0 && marker_rect.height() > 0)
+            {
+                gr.draw_rect(marker_rect, heat_colors[(std::min)(level, heat_levels - 1)]);
+            }
+        }
+    }
+
+    return true;
+}
+
+}
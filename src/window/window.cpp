@@ -20,6 +20,9 @@
 
 #include <wui/system/tools.hpp>
 #include <wui/system/wm_tools.hpp>
+#include <wui/system/paint_profiler.hpp>
+#include <wui/system/tracer.hpp>
+#include <wui/system/alloc_counter.hpp>
 
 #include <boost/nowide/convert.hpp>
 
@@ -126,9 +129,36 @@ wui::rect get_window_size(wui::system_context &context)
 namespace wui
 {
 
+/// The message posted by perf overlay's timer to refresh the panel on the painting thread
+#ifdef _WIN32
+static constexpr UINT perf_overlay_refresh_msg = WM_USER + 1;
+#elif __linux__
+static constexpr uint32_t perf_overlay_refresh_msg = 1; /// atoms below 69 are predefined, so it never equals wm_delete_msg
+#endif
+
+/// Counts the nesting of the dispatching, only the outer events are recorded
+class dispatch_scope
+{
+public:
+    explicit dispatch_scope(int32_t &depth_)
+        : depth(depth_)
+    {
+        ++depth;
+    }
+
+    ~dispatch_scope()
+    {
+        --depth;
+    }
+
+private:
+    int32_t &depth;
+};
+
 window::window(std::string_view theme_control_name, std::shared_ptr<i_theme> theme_)
     : context_{ 0 },
     graphic_(context_),
+    perf_overlay_(context_, std::bind(&window::request_perf_overlay_refresh, this)),
     controls(),
     active_control(),
     caption(),
@@ -138,7 +168,14 @@ window::window(std::string_view theme_control_name, std::shared_ptr<i_theme> the
     window_state_(window_state::normal), prev_window_state_(window_state_),
     tcn(theme_control_name),
     theme_(theme_),
+    caption_font(theme_font_handle(tcn, tv_caption_font, theme_)),
     showed_(true), enabled_(true), skip_draw_(false),
+    damage_mutex(), damage{ 0 }, damage_clear(false),
+    retained_(false), retained_controls(), window_list(), next_window_list(),
+    retained_dirty(), retained_dirty_taken(), retained_damage(), retained_size{ 0 }, retained_generation(0),
+    layered(false), base_layer(context_), composite_damage(),
+    raster_threads_(1), raster_pool(), raster_graphics(), raster_tiles(), raster_window_tiles(), raster_unsafe(), raster_mutex(), raster_background(0),
+    event_recorder_(), dispatch_depth(0),
     focused_index(0),
     parent_(),
     my_control_sid(), my_plain_sid(),
@@ -163,7 +200,8 @@ window::window(std::string_view theme_control_name, std::shared_ptr<i_theme> the
     prev_button_click(0),
     runned(false),
     thread(),
-    key_modifier(0)
+    key_modifier(0),
+    pending_events()
 #endif
 {
 	switch_lang_button->disable_focusing();
@@ -263,10 +301,39 @@ void window::redraw(const rect &redraw_position, bool clear)
     }
     
     auto parent__ = parent_.lock();
+    if (!parent__ && retained_)
+    {
+        std::lock_guard<std::mutex> lock(damage_mutex);
+
+        /// The window not painted for a long time gets the one dirty area
+        if (retained_dirty.size() == 256)
+        {
+            retained_dirty.assign(1, { 0, 0, position_.width(), position_.height() });
+        }
+        retained_dirty.emplace_back(redraw_position);
+    }
+
     if (parent__)
     {
         parent__->redraw(redraw_position, clear);
     }
+    else if (flag_is_set(window_style_, window_style::headless))
+    {
+        std::lock_guard<std::mutex> lock(damage_mutex);
+
+        if (damage.is_null())
+        {
+            damage = redraw_position;
+        }
+        else
+        {
+            damage = { (std::min)(damage.left, redraw_position.left),
+                (std::min)(damage.top, redraw_position.top),
+                (std::max)(damage.right, redraw_position.right),
+                (std::max)(damage.bottom, redraw_position.bottom) };
+        }
+        damage_clear = damage_clear || clear;
+    }
     else
     {
 #ifdef _WIN32
@@ -365,29 +432,24 @@ void window::draw(graphic &gr, const rect &paint_rect)
         gr.draw_text({ window_pos.left + 10, window_pos.top + 10, 0, 0 },
             caption,
             theme_color(tcn, tv_text, theme_),
-            theme_font(tcn, tv_caption_font, theme_));
+            caption_font);
     }
 
-    std::vector<std::shared_ptr<i_control>> topmost_controls;
-    
+    /// The topmost controls are drawn by the second pass, as in paint()
     for (auto &control : controls)
     {
-        if (control->position().in(paint_rect))
+        if (!control->topmost() && control->position().in(paint_rect))
         {
-            if (!control->topmost())
-            {
-                control->draw(gr, paint_rect);
-            }
-            else
-            {
-                topmost_controls.emplace_back(control);
-            }
+            paint_profiler::draw_control(*control, gr, paint_rect);
         }
     }
 
-    for (auto &control : topmost_controls)
+    for (auto &control : controls)
     {
-        control->draw(gr, paint_rect);
+        if (control->topmost() && control->position().in(paint_rect))
+        {
+            paint_profiler::draw_control(*control, gr, paint_rect);
+        }
     }
 
     if (flag_is_set(window_style_, window_style::border_left) &&
@@ -673,6 +735,11 @@ void window::update_theme_control_name(std::string_view theme_control_name)
     update_theme(theme_);
 }
 
+std::string_view window::theme_control_name() const
+{
+    return tcn;
+}
+
 void window::update_theme(std::shared_ptr<i_theme> theme__)
 {
     if (theme_ && !theme__)
@@ -681,9 +748,12 @@ void window::update_theme(std::shared_ptr<i_theme> theme__)
     }
     theme_ = theme__;
 
+    caption_font = theme_font_handle(tcn, tv_caption_font, theme_);
+
     if (context_.valid() && !parent_.lock())
     {
         graphic_.set_background_color(theme_color(tcn, tv_background, theme_));
+        base_layer.set_background_color(theme_color(tcn, tv_background, theme_));
 
 #ifdef _WIN32
 
@@ -921,7 +991,7 @@ void window::expand()
         change_style(net_wm_state, 1, net_wm_state_fullscreen);
     }
 #endif
-    expand_button->set_image(theme_image(ti_normal, theme_));
+    expand_button->set_theme_image(ti_normal, theme_);
 }
 
 void window::normal()
@@ -973,7 +1043,7 @@ void window::normal()
         set_position(normal_position, false);
     }
 
-    expand_button->set_image(theme_image(ti_expand, theme_));
+    expand_button->set_theme_image(ti_expand, theme_);
 
     update_buttons();
 
@@ -1101,6 +1171,139 @@ bool window::draw_enabled() const
     return !skip_draw_;
 }
 
+void window::show_perf_overlay()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        return parent__->show_perf_overlay();
+    }
+
+    perf_overlay_.show();
+    request_perf_overlay_refresh();
+}
+
+void window::hide_perf_overlay()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        return parent__->hide_perf_overlay();
+    }
+
+    perf_overlay_.hide();
+    request_perf_overlay_refresh(); /// erases the panel from the screen
+}
+
+bool window::perf_overlay_showed() const
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        return parent__->perf_overlay_showed();
+    }
+
+    return perf_overlay_.showed();
+}
+
+void window::show_overdraw_heatmap(overdraw_heatmap heatmap)
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        return parent__->show_overdraw_heatmap(heatmap);
+    }
+
+    perf_overlay_.set_heatmap(heatmap);
+    request_perf_overlay_refresh();
+}
+
+void window::set_retained_mode(bool yes)
+{
+    if (retained_ == yes)
+    {
+        return;
+    }
+
+    retained_ = yes;
+
+    retained_controls.clear();
+    window_list.clear();
+    retained_size = { 0 };
+
+    layered = false;
+    base_layer.release();
+
+    redraw({ 0, 0, position_.width(), position_.height() });
+}
+
+bool window::retained_mode() const
+{
+    return retained_;
+}
+
+void window::set_raster_threads(int32_t count)
+{
+    if (count <= 0)
+    {
+        count = static_cast<int32_t>(std::thread::hardware_concurrency());
+    }
+    if (count <= 0)
+    {
+        count = 1;
+    }
+
+    if (raster_threads_ == count)
+    {
+        return;
+    }
+
+    raster_threads_ = count;
+
+    raster_graphics.clear();
+    raster_pool.reset(count > 1 ? new work_pool(count) : nullptr);
+}
+
+int32_t window::raster_threads() const
+{
+    return raster_threads_;
+}
+
+overdraw_heatmap window::overdraw_heatmap_mode() const
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        return parent__->overdraw_heatmap_mode();
+    }
+
+    return perf_overlay_.heatmap();
+}
+
+void window::request_perf_overlay_refresh()
+{
+#ifdef _WIN32
+    if (context_.hwnd)
+    {
+        PostMessage(context_.hwnd, perf_overlay_refresh_msg, 0, 0);
+    }
+#elif __linux__
+    if (context_.connection)
+    {
+        xcb_client_message_event_t event = { 0 };
+
+        event.window = context_.wnd;
+        event.response_type = XCB_CLIENT_MESSAGE;
+        event.type = XCB_ATOM_WM_COMMAND;
+        event.format = 32;
+        event.data.data32[0] = perf_overlay_refresh_msg;
+
+        xcb_send_event(context_.connection, false, context_.wnd, XCB_EVENT_MASK_NO_EVENT, (const char*)&event);
+        xcb_flush(context_.connection);
+    }
+#endif
+}
+
 void window::emit_event(int32_t x, int32_t y)
 {
     auto parent__ = parent_.lock();
@@ -1168,6 +1371,12 @@ void window::send_event_to_plains(const event &ev)
 
 void window::send_mouse_event(const mouse_event &ev)
 {
+    tracer::span span_("send_mouse_event", "event", static_cast<int64_t>(ev.type));
+
+    record_event({ event_type::mouse, ev });
+    dispatch_scope scope_(dispatch_depth);
+    alloc_counter::scope alloc_scope_(alloc_counter::phase::dispatch);
+
     if (!enabled_ && !docked_control)
     {
         return;
@@ -1264,6 +1473,15 @@ bool window::check_control_here(int32_t x, int32_t y)
 
 void window::change_focus()
 {
+    if (event_recorder_)
+    {
+        event ev;
+        ev.type = event_type::internal;
+        ev.internal_event_ = internal_event{ internal_event_type::set_focus, 0, 0 };
+        record_event(ev);
+    }
+    dispatch_scope scope_(dispatch_depth);
+
     if (controls.empty())
     {
         return;
@@ -1309,6 +1527,15 @@ void window::change_focus()
 
 void window::execute_focused()
 {
+    if (event_recorder_)
+    {
+        event ev;
+        ev.type = event_type::internal;
+        ev.internal_event_ = internal_event{ internal_event_type::execute_focused, 0, 0 };
+        record_event(ev);
+    }
+    dispatch_scope scope_(dispatch_depth);
+
     std::shared_ptr<wui::i_control> control;
 
     if (docked_control)
@@ -1408,12 +1635,12 @@ std::shared_ptr<i_control> window::get_focused()
 
 void window::update_button_images()
 {
-	switch_lang_button->set_image(theme_image(ti_switch_lang, theme_));
-    switch_theme_button->set_image(theme_image(ti_switch_theme, theme_));
-    pin_button->set_image(theme_image(ti_pin, theme_));
-    minimize_button->set_image(theme_image(ti_minimize, theme_));
-    expand_button->set_image(theme_image(window_state_ == window_state::normal ? ti_expand : ti_normal, theme_));
-    close_button->set_image(theme_image(ti_close, theme_));
+	switch_lang_button->set_theme_image(ti_switch_lang, theme_);
+    switch_theme_button->set_theme_image(ti_switch_theme, theme_);
+    pin_button->set_theme_image(ti_pin, theme_);
+    minimize_button->set_theme_image(ti_minimize, theme_);
+    expand_button->set_theme_image(window_state_ == window_state::normal ? ti_expand : ti_normal, theme_);
+    close_button->set_theme_image(ti_close, theme_);
 }
 
 void window::update_buttons()
@@ -1507,101 +1734,613 @@ void window::update_buttons()
 	}
 }
 
-void window::draw_border(graphic &gr)
+void window::paint(const rect &paint_rect, bool clear)
 {
-    auto c = theme_color(tcn, tv_border, theme_);
-    auto x = theme_dimension(tcn, tv_border_width, theme_);
+    perf_overlay_.begin_paint();
 
-    int32_t l = 0, t = 0, w = 0, h = 0;
-
-    auto pos = position();
+    auto flush_rect = paint_rect;
 
-    if (parent_.lock())
     {
-        l = pos.left;
-        t = pos.top;
-        w = pos.right - x;
-        h = pos.bottom - x;
+        alloc_counter::scope alloc_scope_(alloc_counter::phase::paint, tcn);
+
+        if (retained_)
+        {
+            flush_rect = paint_retained(paint_rect);
+        }
+        else
+        {
+            if (clear)
+            {
+                graphic_.clear(paint_rect);
+            }
+
+            draw_caption(graphic_, paint_rect);
+            draw_border(graphic_);
 
+            /// The topmost controls are drawn by the second pass to not collect them on every paint
+            for (auto &control : controls)
+            {
+                if (!control->topmost() && control->position().in(paint_rect))
+                {
+                    paint_profiler::draw_control(*control, graphic_, paint_rect);
+                }
+            }
+
+            for (auto &control : controls)
+            {
+                if (control->topmost() && control->position().in(paint_rect))
+                {
+                    paint_profiler::draw_control(*control, graphic_, paint_rect);
+                }
+            }
+        }
     }
-    else
+
+    perf_overlay_.flush(graphic_, flush_rect, { 0, 0, position_.width(), position_.height() });
+
+    alloc_counter::end_frame();
+}
+
+static bool rect_contains(const rect &outer, const rect &inner)
+{
+    return inner.left >= outer.left && inner.top >= outer.top && inner.right <= outer.right && inner.bottom <= outer.bottom;
+}
+
+static rect rect_union(const rect &a, const rect &b)
+{
+    if (a.is_null())
     {
-        w = position_.width() - x;
-        h = position_.height() - x;
+        return b;
     }
-
-    if (flag_is_set(window_style_, window_style::border_left))
+    if (b.is_null())
     {
-        gr.draw_line({ l, t, l, h }, c, x);
+        return a;
     }
-    if (flag_is_set(window_style_, window_style::border_top))
+    return { (std::min)(a.left, b.left), (std::min)(a.top, b.top), (std::max)(a.right, b.right), (std::max)(a.bottom, b.bottom) };
+}
+
+/// Clip the rects by the window, drop the empty ones and return their union.
+/// Too many small rects are replaced by the union
+static rect fit_damage(std::vector<rect> &damage, const rect &window_rect, bool full)
+{
+    static constexpr size_t max_damage_rects = 16;
+
+    if (full)
     {
-        gr.draw_line({ l, t, w, t }, c, x);
+        damage.assign(1, window_rect);
+        return window_rect;
     }
-    if (flag_is_set(window_style_, window_style::border_right))
+
+    rect damage_union = { 0 };
+    size_t damage_count = 0;
+    for (auto &d : damage)
     {
-        gr.draw_line({ w, t, w, h }, c, x);
+        d = { (std::max)(d.left, window_rect.left), (std::max)(d.top, window_rect.top), (std::min)(d.right, window_rect.right), (std::min)(d.bottom, window_rect.bottom) };
+        if (d.width() > 0 && d.height() > 0)
+        {
+            damage_union = rect_union(damage_union, d);
+            damage[damage_count++] = d;
+        }
     }
-    if (flag_is_set(window_style_, window_style::border_bottom))
+    damage.resize(damage_count);
+
+    if (damage.size() > max_damage_rects)
     {
-        gr.draw_line({ l, h, w, h }, c, x);
+        damage.assign(1, damage_union);
     }
-}
 
-void window::send_internal(internal_event_type type, int32_t x, int32_t y)
-{
-    event ev_;
-    ev_.type = event_type::internal;
-    ev_.internal_event_ = internal_event{ type, x, y };
-    send_event_to_plains(ev_);
+    return damage_union;
 }
 
-void window::send_system(system_event_type type, int32_t x, int32_t y)
+rect window::paint_retained(const rect &paint_rect)
 {
-    event ev_;
-    ev_.type = event_type::system;
-    ev_.system_event_ = system_event{ type, x, y };
-    send_event_to_plains(ev_);
-}
+    /// The buffer always holds the actual content here, so the system expose only needs the flush.
+    /// Rasterized are only the bounds of the commands changed since the previous paint
 
-std::shared_ptr<window> window::get_transient_window()
-{
-    return transient_window.lock();
-}
+    rect window_rect = { 0, 0, position_.width(), position_.height() };
 
-bool window::init(std::string_view caption_, const rect &position__, window_style style, std::function<void(void)> close_callback_)
-{
-    err.reset();
+    retained_dirty_taken.clear();
+    {
+        std::lock_guard<std::mutex> lock(damage_mutex);
+        std::swap(retained_dirty, retained_dirty_taken);
+    }
 
-    caption = caption_;
+    retained_damage.clear();
+    composite_damage.clear();
 
-    if (!position__.is_null())
+    bool full = !rect_contains(retained_size, window_rect) || !rect_contains(window_rect, retained_size);
+    retained_size = window_rect;
+
+    /// The first topmost control turns on the base layer, it stays on until the retained mode is reset
+    if (!layered)
     {
-        position_ = position__;
+        for (auto &control : controls)
+        {
+            if (control->topmost())
+            {
+                layered = base_layer.init(get_screen_size(context_), theme_color(tcn, tv_background, theme_));
+                full = full || layered;
+                break;
+            }
+        }
     }
 
-    window_style_ = style;
-    close_callback = close_callback_;
+    auto is_dirty = [this](const rect &position) {
+        for (auto &d : retained_dirty_taken)
+        {
+            if (position.in(d))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
 
-	add_control(switch_lang_button, { 0 });
-    add_control(switch_theme_button, { 0 });
-    add_control(pin_button, { 0 });
-    add_control(minimize_button, { 0 });
-    add_control(expand_button, { 0 });
-    add_control(close_button, { 0 });
+    /// The window's own caption and border are recorded on every paint, it is cheap
+    graphic_.begin_recording(next_window_list);
+    draw_caption(graphic_, window_rect);
+    draw_border(graphic_);
+    graphic_.end_recording();
 
-    update_button_images();
-    update_buttons();
+    display_list::diff(window_list, next_window_list, retained_damage);
+    std::swap(window_list, next_window_list);
 
-    auto transient_window_ = get_transient_window();
-    if (transient_window_)
+    ++retained_generation;
+
+    for (auto &control : controls)
     {
-        if (transient_window_->window_state_ == window_state::minimized)
+        auto position = control->position();
+        bool topmost = control->topmost();
+
+        auto it = retained_controls.find(control.get());
+        bool added = it == retained_controls.end();
+        if (added)
         {
-            transient_window_->normal();
+            it = retained_controls.emplace(control.get(), retained_control{ display_list(), display_list(), position, 0, topmost }).first;
         }
 
-        if (docked_ && transient_window_->position_ > position_)
+        auto &rc = it->second;
+        rc.generation = retained_generation;
+
+        bool moved = !rect_contains(rc.position, position) || !rect_contains(position, rc.position);
+
+        if (!added && !moved && !full && topmost == rc.topmost && !is_dirty(position))
+        {
+            continue;
+        }
+
+        graphic_.begin_recording(rc.next_list);
+        paint_profiler::draw_control(*control, graphic_, position);
+        graphic_.end_recording();
+
+        /// The topmost controls are not in the base layer, their changes are only composited over it
+        auto &damage = layered && topmost && rc.topmost ? composite_damage : retained_damage;
+        if (layered && topmost != rc.topmost)
+        {
+            retained_damage.emplace_back(rc.list.bounds());
+            retained_damage.emplace_back(rc.next_list.bounds());
+        }
+
+        if (added || moved)
+        {
+            damage.emplace_back(rc.list.bounds());
+            damage.emplace_back(rc.next_list.bounds());
+        }
+        else
+        {
+            display_list::diff(rc.list, rc.next_list, damage);
+        }
+
+        std::swap(rc.list, rc.next_list);
+        rc.position = position;
+        rc.topmost = topmost;
+    }
+
+    /// The removed controls
+    for (auto it = retained_controls.begin(); it != retained_controls.end();)
+    {
+        if (it->second.generation != retained_generation)
+        {
+            (layered && it->second.topmost ? composite_damage : retained_damage).emplace_back(it->second.list.bounds());
+            it = retained_controls.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    auto damage_union = fit_damage(retained_damage, window_rect, full);
+
+    if (!layered)
+    {
+        if (!rasterize_tiled(graphic_, true))
+        {
+            for (auto &d : retained_damage)
+            {
+                graphic_.set_clip(d);
+                rasterize(graphic_, d, 0, 0, true);
+            }
+            graphic_.set_clip({ 0 });
+        }
+
+        return rect_union(paint_rect, damage_union);
+    }
+
+    if (!rasterize_tiled(base_layer, false))
+    {
+        for (auto &d : retained_damage)
+        {
+            base_layer.set_clip(d);
+            rasterize(base_layer, d, 0, 0, false);
+        }
+        base_layer.set_clip({ 0 });
+    }
+
+    /// The changed base areas and the areas of the shown, hidden, moved or changed topmost controls
+    /// are composited: the base pixels are copied and only the topmost lists are replayed over them
+    composite_damage.insert(composite_damage.end(), retained_damage.begin(), retained_damage.end());
+    damage_union = fit_damage(composite_damage, window_rect, full);
+
+    for (auto &d : composite_damage)
+    {
+        graphic_.draw_graphic({ d.left, d.top, d.width(), d.height() }, base_layer, d.left, d.top);
+
+        graphic_.set_clip(d);
+        for (auto &control : controls)
+        {
+            auto it = retained_controls.find(control.get());
+            if (it != retained_controls.end() && it->second.topmost && it->second.list.bounds().in(d))
+            {
+                it->second.list.replay(graphic_, d);
+            }
+        }
+    }
+    graphic_.set_clip({ 0 });
+
+    return rect_union(paint_rect, damage_union);
+}
+
+void window::rasterize(graphic &gr, const rect &area, int32_t x_origin, int32_t y_origin, bool with_topmost)
+{
+    gr.clear({ area.left - x_origin, area.top - y_origin, area.right - x_origin, area.bottom - y_origin });
+
+    window_list.replay(gr, area, x_origin, y_origin);
+
+    for (int32_t pass = 0; pass != (with_topmost ? 2 : 1); ++pass)
+    {
+        for (auto &control : controls)
+        {
+            if (control->topmost() != (pass == 1))
+            {
+                continue;
+            }
+
+            auto it = retained_controls.find(control.get());
+            if (it != retained_controls.end() && it->second.list.bounds().in(area))
+            {
+                it->second.list.replay(gr, area, x_origin, y_origin);
+            }
+        }
+    }
+}
+
+bool window::rasterize_tiled(graphic &target, bool with_topmost)
+{
+    /// The tile is big enough to not be dominated by the compositing and small enough to balance the threads
+    static constexpr int32_t tile_size = 256;
+    static constexpr int64_t min_tiled_area = 4 * tile_size * tile_size;
+
+    if (!raster_pool)
+    {
+        return false;
+    }
+
+    int64_t damage_area = 0;
+    for (auto &d : retained_damage)
+    {
+        damage_area += static_cast<int64_t>(d.width()) * d.height();
+    }
+    if (damage_area < min_tiled_area)
+    {
+        return false;
+    }
+
+    /// The commands drawing another graphic read its drawable, the tiles under them are rasterized on the window's thread
+    raster_unsafe.clear();
+    if (!window_list.thread_safe())
+    {
+        raster_unsafe.emplace_back(window_list.unsafe_bounds());
+    }
+    for (auto &rc : retained_controls)
+    {
+        if (!rc.second.list.thread_safe() && (with_topmost || !rc.second.topmost))
+        {
+            raster_unsafe.emplace_back(rc.second.list.unsafe_bounds());
+        }
+    }
+
+    tracer::span span_("window::rasterize_tiled", "paint", damage_area);
+
+    auto background = theme_color(tcn, tv_background, theme_);
+    if (raster_graphics.empty())
+    {
+        for (int32_t i = 0; i != raster_pool->threads_count(); ++i)
+        {
+            raster_graphics.emplace_back(new graphic(context_));
+            if (!raster_graphics.back()->init_image({ 0, 0, tile_size, tile_size }, background))
+            {
+                raster_graphics.clear();
+                return false;
+            }
+        }
+        raster_background = background;
+    }
+    else if (raster_background != background)
+    {
+        for (auto &g : raster_graphics)
+        {
+            g->set_background_color(background);
+        }
+        raster_background = background;
+    }
+
+    raster_tiles.clear();
+    raster_window_tiles.clear();
+    for (auto &d : retained_damage)
+    {
+        for (auto top = d.top; top < d.bottom; top += tile_size)
+        {
+            for (auto left = d.left; left < d.right; left += tile_size)
+            {
+                rect tile = { left, top, (std::min)(left + tile_size, d.right), (std::min)(top + tile_size, d.bottom) };
+
+                auto unsafe = std::find_if(raster_unsafe.begin(), raster_unsafe.end(), [&tile](const rect &u) { return u.in(tile); });
+                (unsafe == raster_unsafe.end() ? raster_tiles : raster_window_tiles).push_back(tile);
+            }
+        }
+    }
+
+    /// The small capture keeps the task function in its inline storage
+    struct raster_job
+    {
+        graphic *target;
+        bool with_topmost;
+    } job{ &target, with_topmost };
+
+    raster_pool->run(raster_tiles.size(), [this, &job](size_t task, int32_t thread) {
+        auto &tile = raster_tiles[task];
+        auto &gr = *raster_graphics[thread];
+
+        gr.set_clip({ 0, 0, tile.width(), tile.height() });
+        rasterize(gr, tile, tile.left, tile.top, job.with_topmost);
+
+        /// The target buffer belongs to the system connection, the tiles are put there one by one
+        std::lock_guard<std::mutex> lock(raster_mutex);
+        job.target->draw_graphic({ tile.left, tile.top, tile.width(), tile.height() }, gr, 0, 0);
+    });
+
+    for (auto &tile : raster_window_tiles)
+    {
+        target.set_clip(tile);
+        rasterize(target, tile, 0, 0, with_topmost);
+    }
+    if (!raster_window_tiles.empty())
+    {
+        target.set_clip({ 0 });
+    }
+
+    return true;
+}
+
+rect window::paint_damaged()
+{
+    rect damaged = { 0 };
+    bool clear = false;
+
+    {
+        std::lock_guard<std::mutex> lock(damage_mutex);
+        std::swap(damaged, damage);
+        std::swap(clear, damage_clear);
+    }
+
+    if (!damaged.is_null())
+    {
+        paint(damaged, clear);
+    }
+
+    return damaged;
+}
+
+void window::dispatch_event(const event &ev)
+{
+    switch (ev.type)
+    {
+        case event_type::mouse:
+            send_mouse_event(ev.mouse_event_);
+        break;
+        case event_type::keyboard:
+        {
+            record_event(ev);
+            dispatch_scope scope_(dispatch_depth);
+            alloc_counter::scope alloc_scope_(alloc_counter::phase::dispatch);
+
+            auto control = get_focused();
+            if (control)
+            {
+                send_event_to_control(control, ev);
+            }
+            send_event_to_plains(ev);
+        }
+        break;
+        case event_type::internal:
+            switch (ev.internal_event_.type)
+            {
+                case internal_event_type::set_focus:
+                    change_focus();
+                break;
+                case internal_event_type::execute_focused:
+                    execute_focused();
+                break;
+                default:
+                    send_internal(ev.internal_event_.type, ev.internal_event_.x, ev.internal_event_.y);
+                break;
+            }
+        break;
+        case event_type::system:
+            send_system(ev.system_event_.type, ev.system_event_.x, ev.system_event_.y);
+        break;
+        default:
+        break;
+    }
+}
+
+void window::set_event_recorder(std::shared_ptr<event_recorder> recorder)
+{
+    event_recorder_ = recorder;
+}
+
+void window::record_event(const event &ev)
+{
+    if (event_recorder_ && dispatch_depth == 0)
+    {
+        event_recorder_->record(ev);
+    }
+}
+
+void window::draw_caption(graphic &gr, const rect &paint_rect)
+{
+    if (!flag_is_set(window_style_, window_style::title_showed) || parent_.lock())
+    {
+        return;
+    }
+
+    auto caption_rect = gr.measure_text(caption, caption_font);
+#ifdef _WIN32
+    caption_rect.move(5, 5);
+#elif __linux__
+    caption_rect.move(10, 5);
+#endif
+
+    if (caption_rect.in(paint_rect))
+    {
+        gr.draw_rect(caption_rect, theme_color(tcn, tv_background, theme_));
+        gr.draw_text(caption_rect,
+            caption,
+            theme_color(tcn, tv_text, theme_),
+            caption_font);
+    }
+}
+
+void window::draw_border(graphic &gr)
+{
+    auto c = theme_color(tcn, tv_border, theme_);
+    auto x = theme_dimension(tcn, tv_border_width, theme_);
+
+    int32_t l = 0, t = 0, w = 0, h = 0;
+
+    auto pos = position();
+
+    if (parent_.lock())
+    {
+        l = pos.left;
+        t = pos.top;
+        w = pos.right - x;
+        h = pos.bottom - x;
+
+    }
+    else
+    {
+        w = position_.width() - x;
+        h = position_.height() - x;
+    }
+
+    if (flag_is_set(window_style_, window_style::border_left))
+    {
+        gr.draw_line({ l, t, l, h }, c, x);
+    }
+    if (flag_is_set(window_style_, window_style::border_top))
+    {
+        gr.draw_line({ l, t, w, t }, c, x);
+    }
+    if (flag_is_set(window_style_, window_style::border_right))
+    {
+        gr.draw_line({ w, t, w, h }, c, x);
+    }
+    if (flag_is_set(window_style_, window_style::border_bottom))
+    {
+        gr.draw_line({ l, h, w, h }, c, x);
+    }
+}
+
+void window::send_internal(internal_event_type type, int32_t x, int32_t y)
+{
+    event ev_;
+    ev_.type = event_type::internal;
+    ev_.internal_event_ = internal_event{ type, x, y };
+
+    record_event(ev_);
+    dispatch_scope scope_(dispatch_depth);
+    alloc_counter::scope alloc_scope_(type == internal_event_type::size_changed ||
+        type == internal_event_type::window_expanded ||
+        type == internal_event_type::window_normalized ? alloc_counter::phase::layout : alloc_counter::phase::dispatch);
+
+    send_event_to_plains(ev_);
+}
+
+void window::send_system(system_event_type type, int32_t x, int32_t y)
+{
+    event ev_;
+    ev_.type = event_type::system;
+    ev_.system_event_ = system_event{ type, x, y };
+
+    record_event(ev_);
+    dispatch_scope scope_(dispatch_depth);
+    alloc_counter::scope alloc_scope_(alloc_counter::phase::dispatch);
+
+    send_event_to_plains(ev_);
+}
+
+std::shared_ptr<window> window::get_transient_window()
+{
+    return transient_window.lock();
+}
+
+bool window::init(std::string_view caption_, const rect &position__, window_style style, std::function<void(void)> close_callback_)
+{
+    tracer::span span_("window::init", "window");
+
+    err.reset();
+
+    caption = caption_;
+
+    if (!position__.is_null())
+    {
+        position_ = position__;
+    }
+
+    window_style_ = style;
+    close_callback = close_callback_;
+
+	add_control(switch_lang_button, { 0 });
+    add_control(switch_theme_button, { 0 });
+    add_control(pin_button, { 0 });
+    add_control(minimize_button, { 0 });
+    add_control(expand_button, { 0 });
+    add_control(close_button, { 0 });
+
+    update_button_images();
+    update_buttons();
+
+    auto transient_window_ = get_transient_window();
+    if (transient_window_)
+    {
+        if (transient_window_->window_state_ == window_state::minimized)
+        {
+            transient_window_->normal();
+        }
+
+        if (docked_ && transient_window_->position_ > position_)
         {
 			int32_t left = (transient_window_->position().width() - position_.width()) / 2;
             int32_t top = (transient_window_->position().height() - position_.height()) / 2;
@@ -1682,7 +2421,7 @@ bool window::init(std::string_view caption_, const rect &position__, window_styl
     context_.hwnd = CreateWindowEx(!topmost() ? 0 : WS_EX_TOPMOST,
         wcex.lpszClassName,
         L"",
-        WS_VISIBLE | WS_MINIMIZEBOX | WS_POPUP | (window_state_ == window_state::minimized ? WS_MINIMIZE : 0),
+        (!flag_is_set(window_style_, window_style::headless) ? WS_VISIBLE : 0) | WS_MINIMIZEBOX | WS_POPUP | (window_state_ == window_state::minimized ? WS_MINIMIZE : 0),
         position_.left,
         position_.top,
         position_.width(),
@@ -1806,7 +2545,10 @@ bool window::init(std::string_view caption_, const rect &position__, window_styl
 
     xcb_change_property(context_.connection, XCB_PROP_MODE_REPLACE, context_.wnd, wm_protocols_event, 4, 32, 1, &wm_delete_msg);
 
-    xcb_map_window(context_.connection, context_.wnd);
+    if (!flag_is_set(window_style_, window_style::headless))
+    {
+        xcb_map_window(context_.connection, context_.wnd);
+    }
 
     xcb_flush(context_.connection);
 
@@ -1923,6 +2665,8 @@ uint8_t get_key_modifier()
 
 LRESULT CALLBACK window::wnd_proc(HWND hwnd, UINT message, WPARAM w_param, LPARAM l_param)
 {
+    tracer::span span_("process_events", "event", static_cast<int64_t>(message));
+
     switch (message)
     {
         case WM_CREATE:
@@ -1953,52 +2697,7 @@ LRESULT CALLBACK window::wnd_proc(HWND hwnd, UINT message, WPARAM w_param, LPARA
                 ps.rcPaint.right,
                 ps.rcPaint.bottom };
 
-            if (ps.fErase)
-            {
-                wnd->graphic_.clear(paint_rect);
-            }
-            if (flag_is_set(wnd->window_style_, window_style::title_showed) && !wnd->parent_.lock())
-            {
-                auto caption_font = theme_font(wnd->tcn, tv_caption_font, wnd->theme_);
-
-                auto caption_rect = wnd->graphic_.measure_text(wnd->caption, caption_font);
-                caption_rect.move(5, 5);
-
-                if (caption_rect.in(paint_rect))
-                {
-                    wnd->graphic_.draw_rect(caption_rect, theme_color(wnd->tcn, tv_background, wnd->theme_));
-                    wnd->graphic_.draw_text(caption_rect,
-                        wnd->caption,
-                        theme_color(wnd->tcn, tv_text, wnd->theme_),
-                        caption_font);
-                }
-            }
-
-            wnd->draw_border(wnd->graphic_);
-
-            std::vector<std::shared_ptr<i_control>> topmost_controls;
-
-            for (auto &control : wnd->controls)
-            {
-                if (control->position().in(paint_rect))
-                {
-                    if (!control->topmost())
-                    {
-                        control->draw(wnd->graphic_, paint_rect);
-                    }
-                    else
-                    {
-                        topmost_controls.emplace_back(control);
-                    }
-                }
-            }
-
-            for (auto &control : topmost_controls)
-            {
-                control->draw(wnd->graphic_, paint_rect);
-            }
-
-            wnd->graphic_.flush(paint_rect);
+            wnd->paint(paint_rect, ps.fErase != FALSE);
 
             EndPaint(hwnd, &ps);
         }
@@ -2339,12 +3038,7 @@ LRESULT CALLBACK window::wnd_proc(HWND hwnd, UINT message, WPARAM w_param, LPARA
             ev.keyboard_event_ = keyboard_event{ keyboard_event_type::down, get_key_modifier(), 0 };
             ev.keyboard_event_.key[0] = static_cast<uint8_t>(w_param);
 
-            auto control = wnd->get_focused();
-            if (control)
-            {
-                wnd->send_event_to_control(control, ev);
-            }
-            wnd->send_event_to_plains(ev);
+            wnd->dispatch_event(ev);
         }
         break;
         case WM_KEYUP:
@@ -2356,12 +3050,7 @@ LRESULT CALLBACK window::wnd_proc(HWND hwnd, UINT message, WPARAM w_param, LPARA
             ev.keyboard_event_ = keyboard_event{ keyboard_event_type::up, get_key_modifier(), 0 };
             ev.keyboard_event_.key[0] = static_cast<uint8_t>(w_param);
 
-            auto control = wnd->get_focused();
-            if (control)
-            {
-                wnd->send_event_to_control(control, ev);
-            }
-            wnd->send_event_to_plains(ev);
+            wnd->dispatch_event(ev);
         }
         break;
         case WM_CHAR:
@@ -2376,17 +3065,27 @@ LRESULT CALLBACK window::wnd_proc(HWND hwnd, UINT message, WPARAM w_param, LPARA
                 memcpy(ev.keyboard_event_.key, narrow_str.c_str(), narrow_str.size());
                 ev.keyboard_event_.key_size = static_cast<uint8_t>(narrow_str.size());
 
-                auto control = wnd->get_focused();
-                if (control)
-                {
-                    wnd->send_event_to_control(control, ev);
-                }
-                wnd->send_event_to_plains(ev);
+                wnd->dispatch_event(ev);
             }
         break;
         case WM_USER:
             reinterpret_cast<window*>(GetWindowLongPtr(hwnd, GWLP_USERDATA))->send_internal(internal_event_type::user_emitted, static_cast<int32_t>(w_param), static_cast<int32_t>(l_param));
         break;
+        case perf_overlay_refresh_msg:
+        {
+            window* wnd = reinterpret_cast<window*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+
+            /// Windows doesn't report the count of messages, so the depth is the count of the pending message kinds
+            int32_t depth = 0;
+            for (auto status = HIWORD(GetQueueStatus(QS_ALLINPUT)); status != 0; status &= status - 1)
+            {
+                ++depth;
+            }
+            wnd->perf_overlay_.set_queue_depth(depth);
+
+            wnd->perf_overlay_.flush(wnd->graphic_, { 0 }, { 0, 0, wnd->position_.width(), wnd->position_.height() });
+        }
+        break;
         case WM_DEVICECHANGE:
             reinterpret_cast<window*>(GetWindowLongPtr(hwnd, GWLP_USERDATA))->send_system(system_event_type::device_change, static_cast<int32_t>(w_param), static_cast<int32_t>(l_param));
         break;
@@ -2394,7 +3093,10 @@ LRESULT CALLBACK window::wnd_proc(HWND hwnd, UINT message, WPARAM w_param, LPARA
         {
             window* wnd = reinterpret_cast<window*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
 
+            wnd->perf_overlay_.release();
             wnd->graphic_.release();
+            wnd->base_layer.release();
+            wnd->raster_graphics.clear();
 
             auto transient_window_ = wnd->get_transient_window();
             if (transient_window_)
@@ -2421,8 +3123,10 @@ LRESULT CALLBACK window::wnd_proc(HWND hwnd, UINT message, WPARAM w_param, LPARA
 void window::process_events()
 {
     xcb_generic_event_t *e = nullptr;
-    while (runned && (e = xcb_wait_for_event(context_.connection)))
+    while (runned && (e = next_event()))
     {
+        tracer::span span_("process_events", "event", static_cast<int64_t>(e->response_type & ~0x80));
+
         switch (e->response_type & ~0x80)
         {
             case XCB_EXPOSE:
@@ -2431,53 +3135,7 @@ void window::process_events()
 
                 const rect paint_rect{ expose.x, expose.y, expose.x + expose.width, expose.y + expose.height };
 
-                if (expose.pad0 != 0)
-                {
-                    graphic_.clear(paint_rect);
-                }
-
-                if (flag_is_set(window_style_, window_style::title_showed) && parent_.lock() == nullptr)
-                {
-                    auto caption_font = theme_font(tcn, tv_caption_font, theme_);
-
-                    auto caption_rect = graphic_.measure_text(caption, caption_font);
-                    caption_rect.move(10, 5);
-
-                    if (caption_rect.in(paint_rect))
-                    {
-                        graphic_.draw_rect(caption_rect, theme_color(tcn, tv_background, theme_));
-                        graphic_.draw_text(caption_rect,
-                            caption,
-                            theme_color(tcn, tv_text, theme_),
-                            caption_font);
-                    }
-                }
-
-                draw_border(graphic_);
-
-                std::vector<std::shared_ptr<i_control>> topmost_controls;
-
-                for (auto &control : controls)
-                {
-                    if (control->position().in(paint_rect))
-                    {
-                        if (!control->topmost())
-                        {
-                            control->draw(graphic_, paint_rect);
-                        }
-                        else
-                        {
-                            topmost_controls.emplace_back(control);
-                        }
-                    }
-                }
-
-                for (auto &control : topmost_controls)
-                {
-                    control->draw(graphic_, paint_rect);
-                }
-
-                graphic_.flush(paint_rect);
+                paint(paint_rect, expose.pad0 != 0);
             }
             break;
             case XCB_MOTION_NOTIFY:
@@ -2763,12 +3421,7 @@ void window::process_events()
                             default: break;
                         }
 
-                        auto control = get_focused();
-                        if (control)
-                        {
-                            send_event_to_control(control, ev);
-                        }
-                        send_event_to_plains(ev);
+                        dispatch_event(ev);
                         
                         continue;
                     }
@@ -2777,12 +3430,7 @@ void window::process_events()
                     ev.keyboard_event_ = keyboard_event{ keyboard_event_type::down, key_modifier, 0 };
                     ev.keyboard_event_.key[0] = static_cast<uint8_t>(ev_.detail);
 
-                    auto control = get_focused();
-                    if (control)
-                    {
-                        send_event_to_control(control, ev);
-                    }
-                    send_event_to_plains(ev);
+                    dispatch_event(ev);
                 }
                 else if (ev_.detail == vk_lshift ||
                     ev_.detail == vk_rshift ||
@@ -2806,12 +3454,7 @@ void window::process_events()
                     ev.keyboard_event_.key_size = static_cast<uint8_t>(XLookupString(&keyev, ev.keyboard_event_.key, sizeof(ev.keyboard_event_.key), nullptr, nullptr));
                     if (ev.keyboard_event_.key_size)
                     {
-                        auto control = get_focused();
-                        if (control)
-                        {
-                            send_event_to_control(control, ev);
-                        }
-                        send_event_to_plains(ev);
+                        dispatch_event(ev);
                     }
                 }
             }
@@ -2835,12 +3478,7 @@ void window::process_events()
                 ev.keyboard_event_ = keyboard_event{ keyboard_event_type::up, key_modifier, 0 };
                 ev.keyboard_event_.key[0] = static_cast<uint8_t>(ev_.detail);
 
-                auto control = get_focused();
-                if (control)
-                {
-                    send_event_to_control(control, ev);
-                }
-                send_event_to_plains(ev);
+                dispatch_event(ev);
             }
             break;
             case XCB_CONFIGURE_NOTIFY:
@@ -2911,14 +3549,21 @@ void window::process_events()
             }
             break;
             case XCB_CLIENT_MESSAGE:
-                if ((*(xcb_client_message_event_t*)e).data.data32[0] != wm_delete_msg)
+                if ((*(xcb_client_message_event_t*)e).data.data32[0] == perf_overlay_refresh_msg)
+                {
+                    perf_overlay_.flush(graphic_, { 0 }, { 0, 0, position_.width(), position_.height() });
+                }
+                else if ((*(xcb_client_message_event_t*)e).data.data32[0] != wm_delete_msg)
                 {
                     send_internal(internal_event_type::user_emitted, static_cast<int32_t>((*(xcb_client_message_event_t*)e).data.data32[1]), static_cast<int32_t>((*(xcb_client_message_event_t*)e).data.data32[2]));
                 }
                 else
                 {
                     graphic_.end_cairo_device(); /// this workaround is needed to prevent destruction in the depths of the cairo
+                    perf_overlay_.release();
                     graphic_.release();
+                    base_layer.release();
+                    raster_graphics.clear();
 
                     xcb_destroy_window(context_.connection, context_.wnd);
                     XCloseDisplay(context_.display);
@@ -2945,6 +3590,43 @@ void window::process_events()
         }
         free(e);
     }
+
+    for (auto pending : pending_events)
+    {
+        free(pending);
+    }
+    pending_events.clear();
+}
+
+xcb_generic_event_t *window::next_event()
+{
+    if (!context_.connection)
+    {
+        return nullptr;
+    }
+
+    if (pending_events.empty())
+    {
+        auto e = xcb_wait_for_event(context_.connection);
+        if (!perf_overlay_.showed() || !e)
+        {
+            return e;
+        }
+        pending_events.push_back(e);
+    }
+
+    /// Read ahead the events already received from the server to know the queue depth
+    while (auto queued = xcb_poll_for_queued_event(context_.connection))
+    {
+        pending_events.push_back(queued);
+    }
+
+    auto e = pending_events.front();
+    pending_events.pop_front();
+
+    perf_overlay_.set_queue_depth(static_cast<int32_t>(pending_events.size()));
+
+    return e;
 }
 
 void window::init_atoms()